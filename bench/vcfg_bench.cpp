@@ -0,0 +1,378 @@
+// Benchmark suite for the VortexConfig parser.
+//
+// Generates synthetic configuration workloads in memory and measures them. Every workload reports
+// its parse throughput, the allocations per parse, the memory held by the parsed data and the peak RSS.
+// The write throughput is reported too, and so is the average cost of a single lookup for every getter
+// family and for a key looked up through the overrides.
+// Run with --quick for a short smoke run, or pass a scenario name to run only the matching workloads.
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+// Count every allocation done by the parser
+static uint64_t g_allocCount = 0;
+static uint64_t g_reallocCount = 0;
+static uint64_t g_freeCount = 0;
+
+static void* bench_malloc(size_t size) { ++g_allocCount; return malloc(size); }
+static void* bench_calloc(size_t count, size_t size) { ++g_allocCount; return calloc(count, size); }
+static void* bench_realloc(void* ptr, size_t size) { if (ptr) ++g_reallocCount; else ++g_allocCount; return realloc(ptr, size); }
+static void bench_free(void* ptr) { if (ptr) ++g_freeCount; free(ptr); }
+
+#define VCFG_MALLOC(size) bench_malloc(size)
+#define VCFG_CALLOC(count, size) bench_calloc(count, size)
+#define VCFG_REALLOC(ptr, size) bench_realloc(ptr, size)
+#define VCFG_FREE(ptr) bench_free(ptr)
+#define VCFG_ENABLE_STATS 1
+#include "vcfg/VortexConfig.h"
+
+#include "workloads.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(OS_WINDOWS)
+	#include <windows.h>
+	#include <psapi.h>
+#else
+	#include <sys/resource.h>
+#endif
+
+// The bool keys of the lookup workload read as an enum
+enum class Switch { Off, On };
+template <> struct vcfg::enum_names<Switch> {
+	static constexpr vcfg::enum_name<Switch> names[] = { { "false", Switch::Off }, { "true", Switch::On } };
+};
+
+namespace {
+	using namespace vcfg_bench;
+	using Clock = std::chrono::steady_clock;
+
+	// Prevents the compiler from optimizing the lookups away
+	volatile uint64_t g_sink = 0;
+	void Consume(uint64_t value) { g_sink = g_sink ^ value; }
+
+	double ElapsedNs(Clock::time_point start, Clock::time_point end) {
+		return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	}
+
+	// Peak resident set size of the whole process in KiB
+	uint64_t PeakRssKiB() {
+	#if defined(OS_WINDOWS)
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+		return counters.PeakWorkingSetSize / 1024;
+	#else
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+		#if defined(__APPLE__)
+			return (uint64_t)usage.ru_maxrss / 1024;
+		#else
+			return (uint64_t)usage.ru_maxrss;
+		#endif
+	#endif
+	}
+
+	/****************************************************/
+	/*					Parse benchmarks				*/
+	/****************************************************/
+
+	struct ParseResult {
+		double megabytesPerSecond;
+		double allocationsPerParse;
+		double reallocationsPerParse;
+		uint64_t parsedKiB;
+		uint64_t peakRssKiB;
+	};
+
+	ParseResult BenchmarkParse(const std::string& data, uint32_t options, double minimumSeconds) {
+		ParseResult result = {};
+		double totalNs = 0;
+		uint64_t iterations = 0;
+		uint64_t allocations = 0;
+		uint64_t reallocations = 0;
+
+		while (iterations < 3 || totalNs < minimumSeconds * 1e9) {
+			VCFG_Parser parser;
+			vcfg_set_buffer(&parser, data.data(), data.size());
+			vcfg_set_options(&parser, options);
+
+			uint64_t allocsBefore = g_allocCount;
+			uint64_t reallocsBefore = g_reallocCount;
+			Clock::time_point start = Clock::now();
+			vcfg_parse(&parser);
+			Clock::time_point end = Clock::now();
+			allocations += g_allocCount - allocsBefore;
+			reallocations += g_reallocCount - reallocsBefore;
+			totalNs += ElapsedNs(start, end);
+			++iterations;
+
+			VCFGStats_t stats;
+			if (vcfg_get_stats(&parser, &stats)) result.parsedKiB = stats.liveBytes / 1024;
+
+			// The buffer is owned by the benchmark, not by the parser
+			parser.m_configBuffer = nullptr;
+			vcfg_clear(&parser);
+		}
+
+		result.megabytesPerSecond = ((double)data.size() * iterations / (1024.0 * 1024.0)) / (totalNs / 1e9);
+		result.allocationsPerParse = (double)allocations / iterations;
+		result.reallocationsPerParse = (double)reallocations / iterations;
+		result.peakRssKiB = PeakRssKiB();
+		return result;
+	}
+
+
+
+	/****************************************************/
+	/*					Write benchmarks				*/
+	/****************************************************/
+
+	struct WriteResult {
+		double megabytesPerSecond;
+		size_t outputBytes;
+	};
+
+	// Throughput of writing the parsed data into a memory buffer that is reused between the iterations,
+	// so only the serialization is measured (in megabytes of output per second)
+	WriteResult BenchmarkWrite(VCFG_Parser* parser, uint32_t flags, double minimumSeconds) {
+		WriteResult result = {};
+		VCFGBufferSink_t buffer = {};
+		buffer.growable = 1;
+		VCFGSink_t sink = vcfg_buffer_sink(&buffer);
+
+		double totalNs = 0;
+		uint64_t iterations = 0;
+		while (iterations < 3 || totalNs < minimumSeconds * 1e9) {
+			buffer.length = 0;
+			Clock::time_point start = Clock::now();
+			vcfg_write(parser, &sink, flags);
+			Clock::time_point end = Clock::now();
+			totalNs += ElapsedNs(start, end);
+			++iterations;
+		}
+
+		result.outputBytes = buffer.length;
+		result.megabytesPerSecond = ((double)buffer.length * iterations / (1024.0 * 1024.0)) / (totalNs / 1e9);
+		free(buffer.data);
+		return result;
+	}
+
+
+
+	/****************************************************/
+	/*					Lookup benchmarks				*/
+	/****************************************************/
+
+	struct LookupKeys {
+		std::vector<std::string> sections;
+		std::vector<std::string> stringKeys;
+		std::vector<std::string> intKeys;
+		std::vector<std::string> floatKeys;
+		std::vector<std::string> boolKeys;
+		std::vector<std::string> durationKeys;
+		std::vector<std::string> sizeKeys;
+	};
+
+	template <typename Lookup>
+	double MeasureLookup(size_t lookupCount, Lookup&& lookup) {
+		Clock::time_point start = Clock::now();
+		for (size_t i = 0; i < lookupCount; i++) {
+			lookup(i);
+		}
+		Clock::time_point end = Clock::now();
+		return ElapsedNs(start, end) / (double)lookupCount;
+	}
+
+	void BenchmarkLookups(size_t sectionCount, size_t keysPerSection, size_t lookupCount) {
+		std::string data = GenerateLookupWorkload(sectionCount, keysPerSection);
+		VCFG_Parser parser;
+		vcfg_set_buffer(&parser, data.data(), data.size());
+		vcfg_parse(&parser);
+
+		// Precompute the names and a random access pattern so that only the lookups are measured
+		LookupKeys keys;
+		for (size_t s = 0; s < sectionCount; s++) keys.sections.push_back("section_" + std::to_string(s));
+		for (size_t k = 0; k < keysPerSection; k++) {
+			std::string index = std::to_string(k);
+			keys.stringKeys.push_back("string_" + index);
+			keys.intKeys.push_back("int_" + index);
+			keys.floatKeys.push_back("float_" + index);
+			keys.boolKeys.push_back("bool_" + index);
+			keys.durationKeys.push_back("duration_" + index);
+			keys.sizeKeys.push_back("size_" + index);
+		}
+
+		Random random;
+		std::vector<uint32_t> sectionPattern(4096), keyPattern(4096);
+		for (size_t i = 0; i < sectionPattern.size(); i++) {
+			sectionPattern[i] = (uint32_t)(random.Next() % sectionCount);
+			keyPattern[i] = (uint32_t)(random.Next() % keysPerSection);
+		}
+		std::vector<const VCFG_Node*> objectNodes;
+		for (size_t s = 0; s < sectionCount; s++) objectNodes.push_back(vcfg_get_node(&parser, keys.sections[s].c_str(), "object"));
+
+		#define SECTION(i) keys.sections[sectionPattern[(i) & 4095]].c_str()
+		#define KEY(list, i) keys.list[keyPattern[(i) & 4095]].c_str()
+		#define NODE(i) objectNodes[sectionPattern[(i) & 4095]]
+
+		std::printf("\n  Lookups (%zu sections x %zu keys per type, %zu lookups each)\n", sectionCount, keysPerSection, lookupCount);
+		std::printf("    %-28s %10.1f ns\n", "vcfg_get_section", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_get_section(&parser, SECTION(i))); }));
+		std::printf("    %-28s %10.1f ns\n", "vcfg_get_string", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_get_string(&parser, SECTION(i), KEY(stringKeys, i))); }));
+		std::printf("    %-28s %10.1f ns\n", "vcfg_get_int", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_get_int(&parser, SECTION(i), KEY(intKeys, i))); }));
+		std::printf("    %-28s %10.1f ns\n", "vcfg_get_float", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_get_float(&parser, SECTION(i), KEY(floatKeys, i))); }));
+		std::printf("    %-28s %10.1f ns\n", "vcfg_get_bool", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_get_bool(&parser, SECTION(i), KEY(boolKeys, i))); }));
+		std::printf("    %-28s %10.1f ns\n", "vcfg_try_get_int", MeasureLookup(lookupCount, [&](size_t i) { int64_t value = 0; Consume((uint64_t)vcfg_try_get_int(&parser, SECTION(i), KEY(intKeys, i), &value) + (uint64_t)value); }));
+		std::printf("    %-28s %10.1f ns\n", "vcfg_get_duration_ns", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_get_duration_ns(&parser, SECTION(i), KEY(durationKeys, i))); }));
+		std::printf("    %-28s %10.1f ns\n", "vcfg_get_bytes", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_get_bytes(&parser, SECTION(i), KEY(sizeKeys, i))); }));
+		std::printf("    %-28s %10.1f ns\n", "vcfg_try_get_float", MeasureLookup(lookupCount, [&](size_t i) { double value = 0; Consume((uint64_t)vcfg_try_get_float(&parser, SECTION(i), KEY(floatKeys, i), &value) + (uint64_t)value); }));
+		std::printf("    %-28s %10.1f ns\n", "vcfg_get_node", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_get_node(&parser, SECTION(i), KEY(stringKeys, i))); }));
+		std::printf("    %-28s %10.1f ns\n", "vcfg_get_string_from_node", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_get_string_from_node(&parser, NODE(i), "string")); }));
+		std::printf("    %-28s %10.1f ns\n", "vcfg_get_int_from_node", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_get_int_from_node(&parser, NODE(i), "int")); }));
+		std::printf("    %-28s %10.1f ns\n", "vcfg_get_float_from_node", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_get_float_from_node(&parser, NODE(i), "float")); }));
+		std::printf("    %-28s %10.1f ns\n", "vcfg_get_bool_from_node", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_get_bool_from_node(&parser, NODE(i), "bool")); }));
+		std::printf("    %-28s %10.1f ns\n", "vcfg_get_node_from_node", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_get_node_from_node(&parser, NODE(i), "inner")); }));
+		std::printf("    %-28s %10.1f ns\n", "GetEnum (cached)", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)parser.GetEnum<Switch>(SECTION(i), KEY(boolKeys, i))); }));
+
+		// A schema with a required rule for every typed key, the whole configuration is validated (the time is per rule)
+		std::vector<VCFGSchemaRule_t> rules;
+		for (size_t s = 0; s < sectionCount; s++) {
+			for (size_t k = 0; k < keysPerSection; k++) {
+				rules.push_back({ keys.sections[s].c_str(), keys.stringKeys[k].c_str(), VCFG_SCHEMA_STRING, VCFG_SCHEMA_REQUIRED, nullptr, nullptr, nullptr, nullptr });
+				rules.push_back({ keys.sections[s].c_str(), keys.intKeys[k].c_str(), VCFG_SCHEMA_INT, VCFG_SCHEMA_REQUIRED, "0", nullptr, nullptr, nullptr });
+				rules.push_back({ keys.sections[s].c_str(), keys.floatKeys[k].c_str(), VCFG_SCHEMA_FLOAT, VCFG_SCHEMA_REQUIRED, nullptr, nullptr, nullptr, nullptr });
+				rules.push_back({ keys.sections[s].c_str(), keys.boolKeys[k].c_str(), VCFG_SCHEMA_BOOL, VCFG_SCHEMA_REQUIRED, nullptr, nullptr, nullptr, nullptr });
+			}
+		}
+		VCFGSchema_t schema = {};
+		vcfg_schema_compile(&schema, rules.data(), (uint32_t)rules.size());
+		size_t validationCount = lookupCount / rules.size() + 1;
+		std::printf("    %-28s %10.1f ns\n", "vcfg_validate (per rule)", MeasureLookup(validationCount, [&](size_t) { Consume(vcfg_validate(&parser, &schema, nullptr, 0)); }) / (double)rules.size());
+		vcfg_schema_free(&schema);
+
+		// Overrides of existing keys (after the getters above, so that they see the parsed values)
+		std::printf("    %-28s %10.1f ns\n", "vcfg_set_int", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_set_int(&parser, SECTION(i), KEY(intKeys, i), (int64_t)i)); }));
+
+		// The same lookups through the hash index and through two layers (the upper one has a quarter of the sections)
+		vcfg_build_index(&parser);
+		std::string upperData = GenerateLookupWorkload(sectionCount / 4 + 1, keysPerSection);
+		VCFG_Parser upper;
+		vcfg_set_buffer(&upper, upperData.data(), upperData.size());
+		vcfg_parse(&upper);
+		VCFGLayers_t layers = {};
+		vcfg_layers_push(&layers, &parser);
+		vcfg_layers_push(&layers, &upper);
+		std::printf("    %-28s %10.1f ns\n", "vcfg_get_section (index)", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_get_section(&parser, SECTION(i))); }));
+		std::printf("    %-28s %10.1f ns\n", "vcfg_get_string (index)", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_get_string(&parser, SECTION(i), KEY(stringKeys, i))); }));
+		// Keys of [section_N.child] (which isn't defined) found in [section_N] through the section tree
+		std::vector<std::string> childSections;
+		for (size_t s = 0; s < sectionCount; s++) childSections.push_back(keys.sections[s] + ".child");
+		vcfg_build_section_tree(&parser);
+		parser.m_options |= VCFG_OPTION_NESTED_SECTIONS;
+		std::printf("    %-28s %10.1f ns\n", "vcfg_get_string (parent)", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_get_string(&parser, childSections[sectionPattern[i & 4095]].c_str(), KEY(stringKeys, i))); }));
+		parser.m_options &= ~VCFG_OPTION_NESTED_SECTIONS;
+		std::printf("    %-28s %10.1f ns\n", "vcfg_layers_get_string", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_layers_get_string(&layers, SECTION(i), KEY(stringKeys, i))); }));
+		// The base parser below the command line overrides of two keys, almost every lookup misses them
+		char* arguments[] = { (char*)"bench", (char*)"--set", (char*)"section_0.string_0=override", (char*)"--set=section_1.int_0=1", nullptr };
+		VCFG_Parser overrides;
+		vcfg_load_arguments(&overrides, 4, arguments);
+		VCFGLayers_t overridden = {};
+		vcfg_layers_push(&overridden, &parser);
+		vcfg_layers_push(&overridden, &overrides);
+		std::printf("    %-28s %10.1f ns\n", "vcfg_layers_get_string --set", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_layers_get_string(&overridden, SECTION(i), KEY(stringKeys, i))); }));
+		// A request scope with two overrides over the same layers and the cost of opening and closing it
+		static VCFGScopes_t scopes;
+		vcfg_scopes_init(&scopes, &overridden);
+		vcfg_push_scope(&scopes);
+		vcfg_scope_set(&scopes, "section_2", "string_0", "scoped");
+		vcfg_scope_set(&scopes, "section_3", "int_0", "2");
+		std::printf("    %-28s %10.1f ns\n", "vcfg_scope_get_string", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_scope_get_string(&scopes, SECTION(i), KEY(stringKeys, i))); }));
+		vcfg_pop_scope(&scopes);
+		std::printf("    %-28s %10.1f ns\n", "push_scope, 2x set, pop", MeasureLookup(lookupCount, [&](size_t i) {
+			vcfg_push_scope(&scopes);
+			vcfg_scope_set(&scopes, SECTION(i), "string_0", "scoped");
+			vcfg_scope_set(&scopes, SECTION(i), "int_0", "2");
+			Consume((uint64_t)vcfg_pop_scope(&scopes));
+		}));
+		vcfg_clear(&overrides);
+		std::printf("    %-28s %10.1f ns\n", "vcfg_set_int (index)", MeasureLookup(lookupCount, [&](size_t i) { Consume((uint64_t)vcfg_set_int(&parser, SECTION(i), KEY(intKeys, i), (int64_t)i)); }));
+		upper.m_configBuffer = nullptr;
+		vcfg_clear(&upper);
+
+		#undef SECTION
+		#undef KEY
+		#undef NODE
+
+		parser.m_configBuffer = nullptr;
+		vcfg_clear(&parser);
+	}
+
+	struct Scenario {
+		const char* name;
+		std::string data;
+		uint32_t options;
+	};
+}
+
+int main(int argc, char** argv) {
+	bool quick = false;
+	const char* filter = nullptr;
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--quick") == 0) quick = true;
+		else filter = argv[i];
+	}
+
+	// The quick mode shrinks the workloads so the suite can be used as a smoke test
+	size_t scale = quick ? 1 : 10;
+	double minimumSeconds = quick ? 0.05 : 0.5;
+
+	std::vector<Scenario> scenarios;
+	scenarios.push_back({ "many_small_sections", GenerateManySmallSections(2000 * scale) });
+	scenarios.push_back({ "huge_section", GenerateHugeSection(2000 * scale) });
+	scenarios.push_back({ "deep_nesting", GenerateDeepNesting(64, 20 * scale) });
+	scenarios.push_back({ "wide_arrays", GenerateWideArrays(4, 1000 * scale) });
+	scenarios.push_back({ "comment_heavy", GenerateCommentHeavy(2000 * scale) });
+	scenarios.push_back({ "long_strings", GenerateLongStrings(16 * scale, 64 * 1024) });
+	// The same references parsed as plain text and resolved, the difference is the cost of the interpolation
+	scenarios.push_back({ "references", GenerateReferences(10000 * scale) });
+	scenarios.push_back({ "references_resolved", GenerateReferences(10000 * scale), VCFG_OPTION_INTERPOLATE });
+
+	std::printf("VortexConfig benchmark%s\n\n", quick ? " (quick)" : "");
+	std::printf("  %-22s %12s %12s %14s %16s %12s %14s\n", "Parse", "Input KiB", "MB/s", "Allocs/parse", "Reallocs/parse", "Parsed KiB", "Peak RSS KiB");
+	for (const Scenario& scenario : scenarios) {
+		if (filter && !std::strstr(scenario.name, filter)) continue;
+
+		ParseResult result = BenchmarkParse(scenario.data, scenario.options, minimumSeconds);
+		std::printf("  %-22s %12zu %12.1f %14.0f %16.0f %12llu %14llu\n", scenario.name, scenario.data.size() / 1024,
+			result.megabytesPerSecond, result.allocationsPerParse, result.reallocationsPerParse,
+			(unsigned long long)result.parsedKiB, (unsigned long long)result.peakRssKiB);
+	}
+
+	std::printf("\n  %-22s %12s %12s %12s %12s\n", "Write", "Pretty KiB", "MB/s", "Compact KiB", "MB/s");
+	for (const Scenario& scenario : scenarios) {
+		if (filter && !std::strstr(scenario.name, filter)) continue;
+
+		VCFG_Parser parser;
+		vcfg_set_buffer(&parser, scenario.data.data(), scenario.data.size());
+		vcfg_set_options(&parser, scenario.options);
+		vcfg_parse(&parser);
+
+		WriteResult pretty = BenchmarkWrite(&parser, VCFG_WRITE_PRETTY, minimumSeconds);
+		WriteResult compact = BenchmarkWrite(&parser, VCFG_WRITE_COMPACT, minimumSeconds);
+		std::printf("  %-22s %12zu %12.1f %12zu %12.1f\n", scenario.name, pretty.outputBytes / 1024, pretty.megabytesPerSecond,
+			compact.outputBytes / 1024, compact.megabytesPerSecond);
+
+		parser.m_configBuffer = nullptr;
+		vcfg_clear(&parser);
+	}
+
+	if (!filter || std::strstr("lookups", filter)) {
+		BenchmarkLookups(quick ? 16 : 64, quick ? 8 : 16, quick ? 100000 : 1000000);
+	}
+
+	return 0;
+}
@@ -0,0 +1,409 @@
+// Instruction count regression check for the VortexConfig parser.
+//
+// Runs the parse, open and lookup workloads under the retired instruction counter of the CPU
+// (perf_event_open, user space only) and compares the counts against a checked-in baseline.
+// Unlike wall-clock timings the instruction counts are stable on shared and noisy machines,
+// so the thresholds of every scenario can be kept at a few percent.
+//
+// Usage: vcfg_perfcheck --baseline <file> [--update-baseline] [scenario filter]
+// Exit codes: 0 - no regressions, 1 - regression, error or a baseline without counts,
+// 77 - counters not available or a baseline of another compiler (skipped)
+
+#include "vcfg/VortexConfig.h"
+
+#include "workloads.h"
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(OS_LINUX)
+	#include <linux/perf_event.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+
+#if !defined(VCFG_PERFCHECK_COMPILER)
+	#define VCFG_PERFCHECK_COMPILER "unknown"
+#endif
+
+// Directory for the file of the open workload (the build directory, not the one of the baseline)
+#if !defined(VCFG_PERFCHECK_SCRATCH_DIR)
+	#define VCFG_PERFCHECK_SCRATCH_DIR "."
+#endif
+
+// The bool keys of the lookup workload read as an enum
+enum class Switch { Off, On };
+template <> struct vcfg::enum_names<Switch> {
+	static constexpr vcfg::enum_name<Switch> names[] = { { "false", Switch::Off }, { "true", Switch::On } };
+};
+
+namespace {
+	using namespace vcfg_bench;
+
+	constexpr int kSkipReturnCode = 77;
+	constexpr int kRepetitions = 5;
+	constexpr double kDefaultTolerance = 2.0;
+
+	// Prevents the compiler from optimizing the lookups away
+	volatile uint64_t g_sink = 0;
+	void Consume(uint64_t value) { g_sink = g_sink ^ value; }
+
+	// Counts the instructions retired in user space by the calling thread
+	class InstructionCounter {
+		public:
+			InstructionCounter() {
+			#if defined(OS_LINUX)
+				struct perf_event_attr attributes;
+				std::memset(&attributes, 0, sizeof(attributes));
+				attributes.size = sizeof(attributes);
+				attributes.type = PERF_TYPE_HARDWARE;
+				attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+				attributes.disabled = 1;
+				attributes.exclude_kernel = 1;
+				attributes.exclude_hv = 1;
+				m_fd = (int)syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+			#endif
+			}
+
+			~InstructionCounter() {
+			#if defined(OS_LINUX)
+				if (m_fd >= 0) close(m_fd);
+			#endif
+			}
+
+			bool Available() const { return m_fd >= 0; }
+
+			void Start() {
+			#if defined(OS_LINUX)
+				if (m_fd < 0) return;
+				ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+				ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+			#endif
+			}
+
+			void Stop() {
+			#if defined(OS_LINUX)
+				if (m_fd < 0) return;
+				ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+				uint64_t value = 0;
+				if (read(m_fd, &value, sizeof(value)) == (ssize_t)sizeof(value)) m_instructions = value;
+			#endif
+			}
+
+			uint64_t Instructions() const { return m_instructions; }
+
+		private:
+			int m_fd = -1;
+			uint64_t m_instructions = 0;
+	};
+
+	// A workload measures its own region (so that the setup is not counted)
+	// and returns the number of operations it did
+	struct Scenario {
+		std::string name;
+		std::function<uint64_t(InstructionCounter&)> run;
+	};
+
+	// Lowest instruction count per operation over a few repetitions
+	uint64_t Measure(InstructionCounter& counter, const Scenario& scenario) {
+		uint64_t best = UINT64_MAX;
+		scenario.run(counter);	// Warm up the caches and the allocator
+		for (int i = 0; i < kRepetitions; i++) {
+			uint64_t operations = scenario.run(counter);
+			uint64_t perOperation = (counter.Instructions() + operations / 2) / operations;
+			if (perOperation < best) best = perOperation;
+		}
+		return best;
+	}
+
+
+
+	/****************************************************/
+	/*						Scenarios					*/
+	/****************************************************/
+
+	Scenario ParseScenario(const char* name, std::string data) {
+		return { std::string("parse_") + name, [data](InstructionCounter& counter) -> uint64_t {
+			VCFG_Parser parser;
+			vcfg_set_buffer(&parser, data.data(), data.size());
+			counter.Start();
+			vcfg_parse(&parser);
+			counter.Stop();
+
+			// The buffer is owned by the scenario, not by the parser
+			parser.m_configBuffer = nullptr;
+			vcfg_clear(&parser);
+			return 1;
+		} };
+	}
+
+	Scenario OpenScenario(const std::string& path) {
+		return { "open", [path](InstructionCounter& counter) -> uint64_t {
+			VCFG_Parser parser;
+			counter.Start();
+			vcfg_open(&parser, path.c_str());
+			counter.Stop();
+			vcfg_clear(&parser);
+			return 1;
+		} };
+	}
+
+	// Data shared by all the lookup scenarios
+	struct LookupData {
+		static constexpr size_t kSectionCount = 16;
+		static constexpr size_t kKeysPerSection = 8;
+		static constexpr size_t kLookupCount = 4096;
+
+		std::string data;
+		VCFG_Parser parser;
+		std::vector<std::string> sections, stringKeys, intKeys, floatKeys, boolKeys, durationKeys, sizeKeys;
+		std::vector<uint32_t> sectionPattern, keyPattern;
+		std::vector<const VCFG_Node*> objectNodes;
+
+		// The durations and sizes are converted while parsing, so their getters read the stored values
+		LookupData() : data(GenerateLookupWorkload(kSectionCount, kKeysPerSection)) {
+			vcfg_set_options(&parser, VCFG_OPTION_UNITS);
+			vcfg_set_buffer(&parser, data.data(), data.size());
+			vcfg_parse(&parser);
+
+			for (size_t s = 0; s < kSectionCount; s++) sections.push_back("section_" + std::to_string(s));
+			for (size_t k = 0; k < kKeysPerSection; k++) {
+				std::string index = std::to_string(k);
+				stringKeys.push_back("string_" + index);
+				intKeys.push_back("int_" + index);
+				floatKeys.push_back("float_" + index);
+				boolKeys.push_back("bool_" + index);
+				durationKeys.push_back("duration_" + index);
+				sizeKeys.push_back("size_" + index);
+			}
+
+			Random random;
+			for (size_t i = 0; i < kLookupCount; i++) {
+				sectionPattern.push_back((uint32_t)(random.Next() % kSectionCount));
+				keyPattern.push_back((uint32_t)(random.Next() % kKeysPerSection));
+			}
+			for (size_t s = 0; s < kSectionCount; s++) objectNodes.push_back(vcfg_get_node(&parser, sections[s].c_str(), "object"));
+		}
+
+		~LookupData() {
+			parser.m_configBuffer = nullptr;
+			vcfg_clear(&parser);
+		}
+
+		const char* Section(size_t i) const { return sections[sectionPattern[i]].c_str(); }
+		const char* Key(const std::vector<std::string>& keys, size_t i) const { return keys[keyPattern[i]].c_str(); }
+		const VCFG_Node* Node(size_t i) const { return objectNodes[sectionPattern[i]]; }
+	};
+
+	template <typename Lookup>
+	Scenario LookupScenario(const char* name, Lookup lookup) {
+		return { name, [lookup](InstructionCounter& counter) -> uint64_t {
+			counter.Start();
+			for (size_t i = 0; i < LookupData::kLookupCount; i++) lookup(i);
+			counter.Stop();
+			return LookupData::kLookupCount;
+		} };
+	}
+
+	std::vector<Scenario> CreateScenarios(LookupData& lookups, const std::string& openPath) {
+		std::vector<Scenario> scenarios;
+		scenarios.push_back(ParseScenario("many_small_sections", GenerateManySmallSections(500)));
+		scenarios.push_back(ParseScenario("huge_section", GenerateHugeSection(2000)));
+		scenarios.push_back(ParseScenario("deep_nesting", GenerateDeepNesting(32, 10)));
+		scenarios.push_back(ParseScenario("wide_arrays", GenerateWideArrays(4, 500)));
+		scenarios.push_back(ParseScenario("comment_heavy", GenerateCommentHeavy(500)));
+		scenarios.push_back(ParseScenario("long_strings", GenerateLongStrings(4, 16 * 1024)));
+		scenarios.push_back(OpenScenario(openPath));
+
+		LookupData* l = &lookups;
+		VCFG_Parser* p = &(lookups.parser);
+		scenarios.push_back(LookupScenario("get_section", [=](size_t i) { Consume((uint64_t)vcfg_get_section(p, l->Section(i))); }));
+		scenarios.push_back(LookupScenario("get_string", [=](size_t i) { Consume((uint64_t)vcfg_get_string(p, l->Section(i), l->Key(l->stringKeys, i))); }));
+		scenarios.push_back(LookupScenario("get_int", [=](size_t i) { Consume((uint64_t)vcfg_get_int(p, l->Section(i), l->Key(l->intKeys, i))); }));
+		scenarios.push_back(LookupScenario("get_float", [=](size_t i) { Consume((uint64_t)vcfg_get_float(p, l->Section(i), l->Key(l->floatKeys, i))); }));
+		scenarios.push_back(LookupScenario("get_bool", [=](size_t i) { Consume((uint64_t)vcfg_get_bool(p, l->Section(i), l->Key(l->boolKeys, i))); }));
+		scenarios.push_back(LookupScenario("get_duration_ns", [=](size_t i) { Consume((uint64_t)vcfg_get_duration_ns(p, l->Section(i), l->Key(l->durationKeys, i))); }));
+		scenarios.push_back(LookupScenario("get_bytes", [=](size_t i) { Consume((uint64_t)vcfg_get_bytes(p, l->Section(i), l->Key(l->sizeKeys, i))); }));
+		scenarios.push_back(LookupScenario("get_enum", [=](size_t i) { Consume((uint64_t)p->GetEnum<Switch>(l->Section(i), l->Key(l->boolKeys, i))); }));
+		scenarios.push_back(LookupScenario("get_node", [=](size_t i) { Consume((uint64_t)vcfg_get_node(p, l->Section(i), l->Key(l->stringKeys, i))); }));
+		scenarios.push_back(LookupScenario("get_string_from_node", [=](size_t i) { Consume((uint64_t)vcfg_get_string_from_node(p, l->Node(i), "string")); }));
+		scenarios.push_back(LookupScenario("get_int_from_node", [=](size_t i) { Consume((uint64_t)vcfg_get_int_from_node(p, l->Node(i), "int")); }));
+		scenarios.push_back(LookupScenario("get_float_from_node", [=](size_t i) { Consume((uint64_t)vcfg_get_float_from_node(p, l->Node(i), "float")); }));
+		scenarios.push_back(LookupScenario("get_bool_from_node", [=](size_t i) { Consume((uint64_t)vcfg_get_bool_from_node(p, l->Node(i), "bool")); }));
+		scenarios.push_back(LookupScenario("get_node_from_node", [=](size_t i) { Consume((uint64_t)vcfg_get_node_from_node(p, l->Node(i), "inner")); }));
+		return scenarios;
+	}
+
+
+
+	/****************************************************/
+	/*						Baseline					*/
+	/****************************************************/
+
+	// The baseline is a configuration file itself:
+	//   [build]             compiler = "<id> <version>" the counts were recorded with
+	//   [<scenario>]        instructions = <count per operation>, tolerance = <allowed increase in percent>
+	struct BaselineEntry {
+		std::string name;
+		int64_t instructions;
+		double tolerance;
+	};
+
+	struct Baseline {
+		std::string compiler;
+		std::vector<BaselineEntry> entries;
+
+		const BaselineEntry* Find(const std::string& name) const {
+			for (const BaselineEntry& entry : entries) {
+				if (entry.name == name) return &entry;
+			}
+			return nullptr;
+		}
+	};
+
+	bool LoadBaseline(const char* path, Baseline& baseline) {
+		VCFGParser parser;
+		if (!parser.Open(path)) return false;
+
+		const char* compiler = parser.GetString("build", "compiler");
+		if (compiler) baseline.compiler = compiler;
+
+		for (uint32_t i = 0; i < parser.m_sectionCount; i++) {
+			const char* name = parser.m_parsedData[i].name;
+			if (!name || std::strcmp(name, "build") == 0) continue;
+
+			BaselineEntry entry = { name, parser.GetInt(name, "instructions"), kDefaultTolerance };
+			if (parser.GetString(name, "tolerance")) entry.tolerance = parser.GetFloat(name, "tolerance");
+			baseline.entries.push_back(entry);
+		}
+		return true;
+	}
+
+	bool SaveBaseline(const char* path, const Baseline& baseline) {
+		FILE* file = std::fopen(path, "w");
+		if (!file) return false;
+
+		std::fprintf(file, "// Instruction count baseline for vcfg_perfcheck (instructions per operation, user space only).\n");
+		std::fprintf(file, "// The counts depend on the compiler and the CPU, regenerate them with:\n");
+		std::fprintf(file, "//   vcfg_perfcheck --baseline bench/perf_baseline.vcfg --update-baseline\n");
+		std::fprintf(file, "// The tolerance is the allowed increase in percent and is kept when the baseline is updated.\n\n");
+		std::fprintf(file, "[build]\ncompiler = \"%s\"\n", baseline.compiler.c_str());
+		for (const BaselineEntry& entry : baseline.entries) {
+			std::fprintf(file, "\n[%s]\ninstructions = %lld\ntolerance = %.1f\n", entry.name.c_str(), (long long)entry.instructions, entry.tolerance);
+		}
+
+		return std::fclose(file) == 0;
+	}
+}
+
+int main(int argc, char** argv) {
+	const char* baselinePath = nullptr;
+	const char* filter = nullptr;
+	bool update = false;
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) baselinePath = argv[++i];
+		else if (std::strcmp(argv[i], "--update-baseline") == 0) update = true;
+		else filter = argv[i];
+	}
+
+	if (!baselinePath) {
+		std::fprintf(stderr, "Usage: %s --baseline <file> [--update-baseline] [scenario filter]\n", argv[0]);
+		return 1;
+	}
+
+	Baseline baseline;
+	if (!LoadBaseline(baselinePath, baseline) && !update) {
+		std::fprintf(stderr, "Failed to load the baseline from %s\n", baselinePath);
+		return 1;
+	}
+
+	std::string openPath = std::string(VCFG_PERFCHECK_SCRATCH_DIR) + "/vcfg_perfcheck.workload.tmp";
+	FILE* openFile = std::fopen(openPath.c_str(), "w");
+	if (!openFile) {
+		std::fprintf(stderr, "Failed to create %s\n", openPath.c_str());
+		return 1;
+	}
+	std::string openData = GenerateManySmallSections(200);
+	std::fwrite(openData.data(), 1, openData.size(), openFile);
+	std::fclose(openFile);
+
+	LookupData lookups;
+	std::vector<Scenario> scenarios = CreateScenarios(lookups, openPath);
+
+	InstructionCounter counter;
+	if (!counter.Available()) {
+		// Still run every workload once so that the target works as a smoke test
+		for (const Scenario& scenario : scenarios) scenario.run(counter);
+		std::remove(openPath.c_str());
+		std::printf("Instruction counters are not available on this machine, skipping\n");
+		return kSkipReturnCode;
+	}
+
+	// A baseline without counts would make every run pass without comparing anything
+	bool recorded = !baseline.compiler.empty() && !baseline.entries.empty();
+	for (const BaselineEntry& entry : baseline.entries) recorded = recorded && (entry.instructions > 0);
+	if (!update && !recorded) {
+		std::remove(openPath.c_str());
+		std::fprintf(stderr, "The baseline %s has no instruction counts, record them with --update-baseline\n", baselinePath);
+		return 1;
+	}
+
+	bool compilerMatches = baseline.compiler == VCFG_PERFCHECK_COMPILER;
+	if (!update && !compilerMatches) {
+		std::remove(openPath.c_str());
+		std::printf("The baseline was recorded with \"%s\", this build uses \"%s\", skipping\n", baseline.compiler.c_str(), VCFG_PERFCHECK_COMPILER);
+		return kSkipReturnCode;
+	}
+
+	Baseline updated;
+	updated.compiler = VCFG_PERFCHECK_COMPILER;
+
+	int regressions = 0;
+	std::printf("  %-26s %12s %12s %9s %9s\n", "Scenario", "Baseline", "Measured", "Delta %", "Limit %");
+	for (const Scenario& scenario : scenarios) {
+		const BaselineEntry* entry = baseline.Find(scenario.name);
+		if (filter && !std::strstr(scenario.name.c_str(), filter)) {
+			if (entry) updated.entries.push_back(*entry);
+			continue;
+		}
+
+		uint64_t measured = Measure(counter, scenario);
+		double tolerance = entry ? entry->tolerance : kDefaultTolerance;
+		updated.entries.push_back({ scenario.name, (int64_t)measured, tolerance });
+
+		if (!entry || entry->instructions <= 0) {
+			std::printf("  %-26s %12s %12llu %9s %9.1f  (new)\n", scenario.name.c_str(), "-", (unsigned long long)measured, "-", tolerance);
+			continue;
+		}
+
+		double delta = ((double)measured - (double)entry->instructions) * 100.0 / (double)entry->instructions;
+		const char* status = "";
+		if (delta > tolerance) {
+			status = "  REGRESSION";
+			++regressions;
+		}
+		else if (delta < -tolerance) status = "  (improved, update the baseline)";
+
+		std::printf("  %-26s %12lld %12llu %+9.2f %9.1f%s\n", scenario.name.c_str(), (long long)entry->instructions, (unsigned long long)measured, delta, tolerance, status);
+	}
+	std::remove(openPath.c_str());
+
+	if (update) {
+		if (!SaveBaseline(baselinePath, updated)) {
+			std::fprintf(stderr, "Failed to write the baseline to %s\n", baselinePath);
+			return 1;
+		}
+		std::printf("\nBaseline written to %s\n", baselinePath);
+		return 0;
+	}
+
+	if (regressions) {
+		std::printf("\n%d scenario(s) exceeded their instruction count threshold\n", regressions);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,136 @@
+// Synthetic configuration workloads shared by the benchmark executables.
+//
+// Every generator is deterministic, so the same arguments always produce the same file.
+
+#ifndef VCFG_BENCH_WORKLOADS_H
+#define VCFG_BENCH_WORKLOADS_H 1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace vcfg_bench {
+	// Small deterministic generator so that every run produces the same workloads
+	struct Random {
+		uint64_t state = 0x9E3779B97F4A7C15ull;
+		uint64_t Next() {
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			return state;
+		}
+	};
+
+
+
+	/****************************************************/
+	/*				Workload generators					*/
+	/****************************************************/
+
+	inline std::string GenerateManySmallSections(size_t sectionCount) {
+		std::string out;
+		for (size_t i = 0; i < sectionCount; i++) {
+			out += "[section_" + std::to_string(i) + "]\n";
+			out += "name = \"service " + std::to_string(i) + "\"\n";
+			out += "port = " + std::to_string(1024 + (i % 60000)) + "\n";
+			out += "ratio = 0." + std::to_string(i % 1000) + "\n";
+			out += "enabled = " + std::string((i & 1) ? "true" : "false") + "\n\n";
+		}
+		return out;
+	}
+
+	inline std::string GenerateHugeSection(size_t keyCount) {
+		std::string out = "[huge]\n";
+		for (size_t i = 0; i < keyCount; i++) {
+			out += "key_" + std::to_string(i) + " = " + std::to_string(i * 7) + "\n";
+		}
+		return out;
+	}
+
+	inline std::string GenerateDeepNesting(size_t depth, size_t repetitions) {
+		std::string out = "[deep]\n";
+		for (size_t r = 0; r < repetitions; r++) {
+			out += "tree_" + std::to_string(r) + " = ";
+			for (size_t d = 0; d < depth; d++) {
+				out += (d & 1) ? "[ " : "{ level = ";
+			}
+			out += "1";
+			for (size_t d = depth; d > 0; d--) {
+				out += ((d - 1) & 1) ? " ]" : " }";
+			}
+			out += "\n";
+		}
+		return out;
+	}
+
+	inline std::string GenerateWideArrays(size_t arrayCount, size_t elementCount) {
+		std::string out = "[arrays]\n";
+		for (size_t a = 0; a < arrayCount; a++) {
+			out += "array_" + std::to_string(a) + " = [";
+			for (size_t e = 0; e < elementCount; e++) {
+				if (e) out += ", ";
+				out += std::to_string(e);
+			}
+			out += "]\n";
+		}
+		return out;
+	}
+
+	inline std::string GenerateCommentHeavy(size_t keyCount) {
+		std::string out = "/*\n *\tA configuration file that is mostly documentation\n */\n[documented]\n";
+		for (size_t i = 0; i < keyCount; i++) {
+			out += "// The key below controls feature number " + std::to_string(i) + " of the service.\n";
+			out += "/* It is documented in a block comment as well,\n   spanning more than a single line of text. */\n";
+			out += "feature_" + std::to_string(i) + " = " + std::to_string(i) + "\t// trailing comment\n";
+		}
+		return out;
+	}
+
+	inline std::string GenerateLongStrings(size_t keyCount, size_t stringLength) {
+		Random random;
+		std::string out = "[strings]\n";
+		for (size_t i = 0; i < keyCount; i++) {
+			out += "text_" + std::to_string(i) + " = \"";
+			for (size_t c = 0; c < stringLength; c++) {
+				out += (char)('a' + (random.Next() % 26));
+			}
+			out += "\"\n";
+		}
+		return out;
+	}
+
+	// Four references per service: three to plain values and one to the url of an earlier service,
+	// so the values depend on each other in long chains
+	inline std::string GenerateReferences(size_t referenceCount) {
+		std::string out = "[defaults]\nhost = \"example.com\"\nport = 8080\n\n";
+		for (size_t i = 0; i < referenceCount / 4; i++) {
+			std::string name = "service_" + std::to_string(i);
+			out += "[" + name + "]\n";
+			out += "path = \"api/" + std::to_string(i) + "\"\n";
+			out += "url = \"http://${defaults.host}:${defaults.port}/${" + name + ".path}\"\n";
+			out += "upstream = \"${service_" + std::to_string(i / 2) + ".url}\"\n\n";
+		}
+		return out;
+	}
+
+	// A mix of typed keys and nested nodes used by the lookup benchmarks
+	inline std::string GenerateLookupWorkload(size_t sectionCount, size_t keysPerSection) {
+		std::string out;
+		for (size_t s = 0; s < sectionCount; s++) {
+			out += "[section_" + std::to_string(s) + "]\n";
+			for (size_t k = 0; k < keysPerSection; k++) {
+				std::string index = std::to_string(k);
+				out += "string_" + index + " = \"value " + index + "\"\n";
+				out += "int_" + index + " = " + std::to_string(k * 31) + "\n";
+				out += "float_" + index + " = " + std::to_string(k) + ".25\n";
+				out += "bool_" + index + " = " + std::string((k & 1) ? "true" : "false") + "\n";
+				out += "duration_" + index + " = " + std::to_string((k + 1) * 250) + "ms\n";
+				out += "size_" + index + " = " + std::to_string(k + 1) + ".5KiB\n";
+			}
+			out += "object = { string = \"nested\", int = 42, float = 4.5, bool = true, inner = { int = 7 } }\n";
+		}
+		return out;
+	}
+}
+
+#endif // VCFG_BENCH_WORKLOADS_H
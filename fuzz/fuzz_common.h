@@ -0,0 +1,127 @@
+// Helpers shared by the fuzzing harnesses.
+//
+// Besides the memory errors caught by the sanitizers the harnesses look for pathological inputs:
+// every parse has a time budget proportional to the size of the input and an input that exceeds
+// it aborts, so that libFuzzer and AFL++ store it next to the crashes. The budget is measured in
+// CPU time of the parsing thread, so waiting for the scheduler doesn't count. It can be tuned with
+// the VCFG_FUZZ_NS_PER_BYTE and VCFG_FUZZ_FIXED_US environment variables and VCFG_FUZZ_BUDGET=0
+// turns it off (CTest replays the corpus that way, the budget is meant for live fuzzing).
+
+#ifndef VCFG_FUZZ_COMMON_H
+#define VCFG_FUZZ_COMMON_H 1
+
+#include "vcfg/VortexConfig.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_WIN32)
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif
+
+namespace vcfg_fuzz {
+	// Generous defaults, so that only inputs that scale badly are reported (sanitizers slow everything down)
+	constexpr uint64_t kDefaultNsPerByte = 2000;
+	constexpr uint64_t kDefaultFixedUs = 10000;
+
+	inline uint64_t EnvironmentValue(const char* name, uint64_t defaultValue) {
+		const char* value = std::getenv(name);
+		if (!value || !*value) return defaultValue;
+		return std::strtoull(value, nullptr, 10);
+	}
+
+	// CPU time used by the calling thread in nanoseconds
+	inline uint64_t ThreadCpuNs() {
+	#if defined(_WIN32)
+		FILETIME creation, exit, kernel, user;
+		if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) return 0;
+		uint64_t kernelTime = ((uint64_t)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+		uint64_t userTime = ((uint64_t)user.dwHighDateTime << 32) | user.dwLowDateTime;
+		return (kernelTime + userTime) * 100;
+	#else
+		struct timespec now;
+		if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0) return 0;
+		return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+	#endif
+	}
+
+	// Parse time budget in nanoseconds for an input of the given size (0 when it's turned off)
+	inline uint64_t ParseBudgetNs(size_t size) {
+		static const bool enabled = EnvironmentValue("VCFG_FUZZ_BUDGET", 1) != 0;
+		if (!enabled) return 0;
+		static const uint64_t nsPerByte = EnvironmentValue("VCFG_FUZZ_NS_PER_BYTE", kDefaultNsPerByte);
+		static const uint64_t fixedNs = EnvironmentValue("VCFG_FUZZ_FIXED_US", kDefaultFixedUs) * 1000;
+		return fixedNs + nsPerByte * (uint64_t)size;
+	}
+
+	// Parses the input from an exactly sized heap copy, so that the sanitizers
+	// catch every read past the end of the buffer, and checks the time budget
+	inline void ParseWithBudget(VCFG_Parser* parser, const uint8_t* data, size_t size) {
+		char* buffer = (char*)std::malloc(size ? size : 1);
+		if (!buffer) return;
+		if (size) std::memcpy(buffer, data, size);
+
+		// The parser owns the buffer from now on and frees it in vcfg_clear
+		vcfg_set_buffer(parser, buffer, size);
+
+		uint64_t start = ThreadCpuNs();
+		vcfg_parse(parser);
+		uint64_t elapsedNs = ThreadCpuNs() - start;
+
+		uint64_t budgetNs = ParseBudgetNs(size);
+		if (budgetNs && (elapsedNs > budgetNs)) {
+			std::fprintf(stderr, "vcfg_parse took %llu ns for %zu bytes (budget %llu ns)\n", (unsigned long long)elapsedNs, size, (unsigned long long)budgetNs);
+			std::abort();
+		}
+	}
+
+	// Writes the configuration to a new growable buffer
+	inline int WriteToBuffer(VCFG_Parser* parser, uint32_t flags, VCFGBufferSink_t* buffer) {
+		VCFGBufferSink_t empty = { 0 };
+		*buffer = empty;
+		buffer->growable = 1;
+
+		VCFGSink_t sink = vcfg_buffer_sink(buffer);
+		return vcfg_write(parser, &sink, flags);
+	}
+
+	// Writes the configuration in both formats, parses the output with the same options and writes it again.
+	// The outputs have to be the same, names and values that can't be written are the only acceptable failure
+	inline void CheckRoundTrip(VCFG_Parser* parser) {
+		const uint32_t formats[] = { VCFG_WRITE_PRETTY, VCFG_WRITE_COMPACT };
+		for (uint32_t flags : formats) {
+			VCFGBufferSink_t first;
+			if (!WriteToBuffer(parser, flags, &first)) {
+				if (vcfg_get_last_error(parser) != VCFG_ERROR_NOT_REPRESENTABLE) std::abort();
+				std::free(first.data);
+				return;
+			}
+
+			// An empty configuration writes nothing
+			if (!first.length) {
+				std::free(first.data);
+				continue;
+			}
+
+			// The parser owns the first output from now on
+			VCFG_Parser reparsed;
+			vcfg_set_options(&reparsed, parser->m_options);
+			vcfg_set_buffer(&reparsed, first.data, first.length);
+			if (!vcfg_parse(&reparsed)) std::abort();
+
+			VCFGBufferSink_t second;
+			if (!WriteToBuffer(&reparsed, flags, &second)) std::abort();
+			if ((second.length != first.length) || std::memcmp(second.data, first.data, first.length)) std::abort();
+
+			std::free(second.data);
+			vcfg_clear(&reparsed);
+		}
+	}
+}
+
+#endif // VCFG_FUZZ_COMMON_H
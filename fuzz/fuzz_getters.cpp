@@ -0,0 +1,225 @@
+// libFuzzer / AFL++ harness for the getters.
+//
+// Parses the input and reads every section, key and nested node with every getter.
+// A few names that don't exist are looked up too.
+// Inputs of odd length are parsed with the references resolved and the dotted sections nested.
+// Every subsection has to start with the name of its parent.
+// Inputs with the second bit of the length set are parsed with the durations and sizes converted.
+// The converted values have to be the ones the text converts to.
+// The input is validated against a fixed schema, then compiled as a schema and validated against itself.
+// Every key is read as two enums that take the cache of the node over from each other.
+// The boolean of a key has to be the one of the literal it's equal to (in any case).
+// The first key of every section is overridden with --set and has to be read through the layers.
+
+#include "fuzz_common.h"
+
+#include <cctype>
+#include <string>
+#include <vector>
+
+namespace {
+	enum class Level { Debug, Info, Warn };
+	enum class Severity { Warn, Error };
+}
+
+template <> struct vcfg::enum_names<Level> {
+	static constexpr vcfg::enum_name<Level> names[] = { { "debug", Level::Debug }, { "info", Level::Info }, { "warn", Level::Warn } };
+};
+
+template <> struct vcfg::enum_names<Severity> {
+	static constexpr vcfg::enum_name<Severity> names[] = { { "warn", Severity::Warn }, { "error", Severity::Error } };
+};
+
+namespace {
+	volatile uint64_t g_sink = 0;
+	void Consume(uint64_t value) { g_sink = g_sink ^ value; }
+
+	const char* const g_levels[] = { "debug", "info", "warn", nullptr };
+	const VCFGSchemaRule_t g_rules[] = {
+		{ nullptr, "name", VCFG_SCHEMA_STRING, VCFG_SCHEMA_REQUIRED, "1", "16", "*a?*", nullptr },
+		{ "server", "port", VCFG_SCHEMA_INT, VCFG_SCHEMA_REQUIRED, "1", "65535", nullptr, nullptr },
+		{ "server", "timeout", VCFG_SCHEMA_DURATION, 0, nullptr, "30s", nullptr, nullptr },
+		{ "server", "buffer", VCFG_SCHEMA_SIZE, 0, "1KiB", nullptr, nullptr, nullptr },
+		{ "server", "ratio", VCFG_SCHEMA_FLOAT, 0, "0", "1", nullptr, nullptr },
+		{ "server", "level", VCFG_SCHEMA_ENUM, 0, nullptr, nullptr, nullptr, g_levels },
+		{ "server", "pool.size", VCFG_SCHEMA_INT, VCFG_SCHEMA_REQUIRED, nullptr, "64", nullptr, nullptr },
+		{ "server", "pool.tags", VCFG_SCHEMA_ARRAY, 0, nullptr, "4", nullptr, nullptr },
+		{ "a", "b", VCFG_SCHEMA_BOOL, 0, nullptr, nullptr, nullptr, nullptr }
+	};
+
+	// Violations are reported in the given capacity and counted beyond it
+	void Validate(VCFG_Parser* parser, const VCFGSchema_t* schema) {
+		VCFGViolation_t violations[4];
+		uint32_t count = vcfg_validate(parser, schema, violations, 4);
+		for (uint32_t i = 0; (i < count) && (i < 4); i++) {
+			if (!violations[i].rule || ((violations[i].kind == VCFG_VIOLATION_MISSING) != !violations[i].key)) std::abort();
+		}
+		if (vcfg_validate(parser, schema, nullptr, 0) != count) std::abort();
+	}
+
+	// The enum has to be the name the value is equal to, also when it's read from the cache
+	void CheckEnum(VCFG_Parser* parser, const char* sectionName, const char* keyName) {
+		const char* value = vcfg_get_string(parser, sectionName, keyName);
+		int position = -1;
+		for (int i = 0; value && g_levels[i]; i++) {
+			if (std::strcmp(value, g_levels[i]) == 0) position = i;
+		}
+		int severity = !value ? -1 : !std::strcmp(value, "warn") ? 0 : !std::strcmp(value, "error") ? 1 : -1;
+
+		// Every read but the first of each enum finds the cache filled by the other one or by itself
+		const VCFG_Node* node = vcfg_get_node(parser, sectionName, keyName);
+		for (int read = 0; read < 6; read++) {
+			if (read % 3 == 2) {
+				vcfg::expected<Severity> result = parser->TryGetEnum<Severity>(sectionName, keyName);
+				if ((severity < 0) ? result.has_value() : (!result || ((int)*result != severity))) std::abort();
+				continue;
+			}
+
+			vcfg::expected<Level> level = parser->TryGetEnum<Level>(sectionName, keyName);
+			if ((position < 0) ? level.has_value() : (!level || ((int)*level != position))) std::abort();
+
+			// A value that isn't one of the names is cached like the others
+			uint32_t cache = (vcfg::detail::enum_lookup<Level>::id() << vcfg::detail::enum_position_bits) | ((position < 0) ? vcfg::detail::enum_no_match : (uint32_t)(position + 1));
+			if (node && node->value && (node->enumCache != cache)) std::abort();
+		}
+	}
+
+	// The boolean has to be read from the type tag found while parsing
+	void CheckBool(VCFG_Parser* parser, const char* sectionName, const char* keyName) {
+		static const char* const literals[] = { "false", "no", "off", "0", "true", "yes", "on", "1" };
+		const VCFG_Node* node = vcfg_get_node(parser, sectionName, keyName);
+		const char* value = node ? node->value : nullptr;
+		int expected = -1;
+		for (int i = 0; value && (i < 8); i++) {
+			size_t c = 0;
+			while (literals[i][c] && (std::tolower((unsigned char)value[c]) == literals[i][c])) ++c;
+			if (!literals[i][c] && !value[c]) expected = (i >= 4);
+		}
+
+		int boolean = -1;
+		VCFGStatus status = vcfg_try_get_bool(parser, sectionName, keyName, &boolean);
+		if (!node) {
+			if (status != VCFG_STATUS_NOT_FOUND) std::abort();
+		}
+		else if ((expected < 0) ? (status != VCFG_STATUS_INVALID_FORMAT) : ((status != VCFG_STATUS_OK) || (boolean != expected))) std::abort();
+		if (vcfg_get_bool(parser, sectionName, keyName) != (expected > 0)) std::abort();
+	}
+
+	// --set section.key has to address the key like ${section.key}, the section name may contain dots
+	void CheckOverrides(VCFG_Parser* parser) {
+		std::vector<std::string> arguments = { "fuzz" };
+		std::vector<uint32_t> checked;
+		for (uint32_t s = 0; s < parser->m_sectionCount; s++) {
+			const VCFGSection_t* section = &(parser->m_parsedData[s]);
+			const char* name = section->keyCount ? section->keys[0].name : nullptr;
+			if (!name || !(*name) || std::strpbrk(name, ".=") || (section->name && (!(*section->name) || std::strchr(section->name, '=')))) continue;
+
+			arguments.push_back("--set");
+			arguments.push_back((section->name ? std::string(section->name) + "." : std::string()) + name + "=override");
+			checked.push_back(s);
+		}
+
+		std::vector<char*> argv;
+		for (std::string& argument : arguments) argv.push_back(&argument[0]);
+		VCFG_Parser overrides;
+		if (!vcfg_load_arguments(&overrides, (int)argv.size(), argv.data())) std::abort();
+
+		VCFGLayers_t layers = {};
+		if (!vcfg_layers_push(&layers, parser) || !vcfg_layers_push(&layers, &overrides)) std::abort();
+		for (uint32_t s : checked) {
+			const VCFGSection_t* section = &(parser->m_parsedData[s]);
+			const char* value = vcfg_layers_get_string(&layers, section->name, section->keys[0].name);
+			if (!value || std::strcmp(value, "override")) std::abort();
+		}
+	}
+
+	// The nanoseconds and bytes stored while parsing have to be the ones of the text
+	void CheckQuantity(VCFG_Parser* parser, const char* sectionName, const char* keyName) {
+		const VCFG_Node* node = vcfg_get_node(parser, sectionName, keyName);
+		if (!node || !node->value) return;
+
+		int64_t value = 0, expected = 0;
+		if (vcfg_try_get_duration_ns(parser, sectionName, keyName, &value) != vcfginternal_parse_unit_value(node->value, VCFG_UNIT_DURATION, &expected)) std::abort();
+		if (value != expected) std::abort();
+		value = expected = 0;
+		if (vcfg_try_get_bytes(parser, sectionName, keyName, &value) != vcfginternal_parse_unit_value(node->value, VCFG_UNIT_SIZE, &expected)) std::abort();
+		if (value != expected) std::abort();
+	}
+
+	void LookupChildren(VCFG_Parser* parser, const VCFG_Node* node) {
+		Consume((uint64_t)vcfg_get_string_from_node(parser, node, "missing"));
+		Consume((uint64_t)vcfg_get_node_from_node(parser, node, "missing"));
+
+		for (uint32_t i = 0; i < node->childCount; i++) {
+			const char* name = node->children[i].name;
+			if (!name) continue;
+
+			Consume((uint64_t)vcfg_get_string_from_node(parser, node, name));
+			Consume((uint64_t)vcfg_get_int_from_node(parser, node, name));
+			Consume((uint64_t)vcfg_get_float_from_node(parser, node, name));
+			Consume((uint64_t)vcfg_get_bool_from_node(parser, node, name));
+
+			const VCFG_Node* child = vcfg_get_node_from_node(parser, node, name);
+			if (child) LookupChildren(parser, child);
+		}
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+	VCFG_Parser parser;
+	vcfg_set_options(&parser, ((size & 1) ? (VCFG_OPTION_INTERPOLATE | VCFG_OPTION_NESTED_SECTIONS) : 0) | ((size & 2) ? VCFG_OPTION_UNITS : 0));
+	vcfg_fuzz::ParseWithBudget(&parser, data, size);
+	VCFGError error = vcfg_get_last_error(&parser);
+	if ((error == VCFG_ERROR_INVALID_REFERENCE || error == VCFG_ERROR_REFERENCE_CYCLE) && !(size & 1)) std::abort();
+
+	Consume((uint64_t)vcfg_get_section(&parser, "missing"));
+	Consume((uint64_t)vcfg_get_string(&parser, "missing", "missing"));
+	Consume((uint64_t)vcfg_get_node(&parser, "missing", "missing"));
+
+	for (uint32_t s = 0; s < parser.m_sectionCount; s++) {
+		const VCFGSection_t* section = &(parser.m_parsedData[s]);
+		Consume((uint64_t)vcfg_get_section(&parser, section->name));
+		Consume((uint64_t)vcfg_get_int(&parser, section->name, "missing"));
+
+		const uint32_t* subsections = nullptr;
+		uint32_t subsectionCount = section->name ? vcfg_get_subsections(&parser, section->name, &subsections) : 0;
+		size_t nameLength = section->name ? std::strlen(section->name) : 0;
+		for (uint32_t i = 0; i < subsectionCount; i++) {
+			const char* subsectionName = parser.m_parsedData[subsections[i]].name;
+			if (std::strncmp(subsectionName, section->name, nameLength) || (subsectionName[nameLength] != '.')) std::abort();
+		}
+
+		for (uint32_t k = 0; k < section->keyCount; k++) {
+			const char* name = section->keys[k].name;
+			if (!name) continue;
+
+			Consume((uint64_t)vcfg_get_string(&parser, section->name, name));
+			Consume((uint64_t)vcfg_get_int(&parser, section->name, name));
+			Consume((uint64_t)vcfg_get_float(&parser, section->name, name));
+			Consume((uint64_t)vcfg_get_bool(&parser, section->name, name));
+			Consume((uint64_t)vcfg_get_duration_ns(&parser, section->name, name));
+			Consume((uint64_t)vcfg_get_bytes(&parser, section->name, name));
+			CheckEnum(&parser, section->name, name);
+			CheckBool(&parser, section->name, name);
+			CheckQuantity(&parser, section->name, name);
+
+			const VCFG_Node* node = vcfg_get_node(&parser, section->name, name);
+			if (node) LookupChildren(&parser, node);
+		}
+	}
+
+	static VCFGSchema_t fixedSchema = {};
+	if (!fixedSchema.table && !vcfg_schema_compile(&fixedSchema, g_rules, sizeof(g_rules) / sizeof(g_rules[0]))) std::abort();
+	Validate(&parser, &fixedSchema);
+
+	VCFGSchema_t schema = {};
+	if (vcfg_schema_load(&schema, &parser)) Validate(&parser, &schema);
+	else if (vcfg_get_last_error(&parser) != VCFG_ERROR_INVALID_SCHEMA) std::abort();
+	vcfg_schema_free(&schema);
+	CheckOverrides(&parser);
+
+	// Names and values are freed with the size given by strlen, so inputs with NUL bytes can't balance
+	vcfg_clear(&parser);
+	if (parser.m_parsedBytes && !std::memchr(data, 0, size)) std::abort();
+	return 0;
+}
@@ -0,0 +1,169 @@
+// libFuzzer / AFL++ harness for the mutation functions.
+//
+// Parses the input and then uses the same bytes as a script of sets, inserts and removals
+// on the parsed data. After every script the source order and the array element names have
+// to be consistent, the data has to survive a write/parse round trip and clearing the parser
+// has to free every byte that was allocated. The harness is built with VCFG_ENABLE_LOSSLESS: writing the
+// unchanged data with VCFG_WRITE_PRESERVE_FORMATTING has to reproduce the input exactly and after the script
+// the preserved text has to parse to the same data as the changed one. Inputs of odd length run the script
+// with the hash index, which has to find the same sections and keys as the linear lookups afterwards.
+// Inputs with the second bit of the length set run it with the section tree, which has to stay sorted.
+
+#define VCFG_ENABLE_LOSSLESS 1
+#include "fuzz_common.h"
+
+#include <cmath>
+
+namespace {
+	// sourceIndex has to be a permutation of the positions, array elements have to be named after it
+	// and the type tags have to match the values
+	void CheckKeys(const VCFGKey_t* keys, uint32_t keyCount, int isArray) {
+		uint8_t seen[256] = { 0 };
+		for (uint32_t i = 0; i < keyCount; i++) {
+			if (keys[i].typeTag && (keys[i].typeTag != vcfginternal_classify_bool(keys[i].value))) std::abort();
+
+			uint32_t sourceIndex = keys[i].sourceIndex;
+			if (sourceIndex >= keyCount) std::abort();
+			if (keyCount <= sizeof(seen)) {
+				if (seen[sourceIndex]) std::abort();
+				seen[sourceIndex] = 1;
+			}
+
+			if (isArray) {
+				char indexBuffer[24];
+				std::snprintf(indexBuffer, sizeof(indexBuffer), "%u", sourceIndex);
+				if (!keys[i].name || std::strcmp(keys[i].name, indexBuffer)) std::abort();
+			}
+
+			CheckKeys(keys[i].children, keys[i].childCount, vcfginternal_is_array(&(keys[i])));
+		}
+	}
+
+	// Picks an existing key of a section (or a new name when the byte is past the last key)
+	const char* PickKey(const VCFGSection_t* section, uint8_t byte, char* nameBuffer) {
+		if (byte < section->keyCount) return section->keys[byte].name;
+		std::snprintf(nameBuffer, 16, "k%u", (unsigned)(byte & 15));
+		return nameBuffer;
+	}
+
+	// Every section and key of a section has to be found through the index, as the first one of its name
+	// (in the section or in the nearest section it inherits from)
+	void CheckIndex(VCFG_Parser* parser) {
+		if ((size_t)parser->m_indexCount * 2 > parser->m_indexCapacity) std::abort();
+
+		for (uint32_t s = 0; s < parser->m_sectionCount; s++) {
+			VCFGSection_t* section = &(parser->m_parsedData[s]);
+			VCFGSection_t* first = parser->m_parsedData;
+			while (vcfginternal_strcmp(first->name, section->name) != 0) ++first;
+			if (vcfg_get_section(parser, section->name) != first) std::abort();
+
+			for (uint32_t k = 0; k < section->keyCount; k++) {
+				VCFGKey_t* key = nullptr;
+				for (VCFGSection_t* owner = first; !key; owner = &(parser->m_parsedData[owner->parent])) {
+					key = vcfginternal_find_in_keys(owner->keys, owner->keyCount, section->keys[k].name);
+					if (!(owner->parent)) break;
+				}
+				if (vcfginternal_find_key(parser, section->name, section->keys[k].name) != key) std::abort();
+			}
+		}
+	}
+
+	// The section tree has to hold every section once, sorted by name and then by position
+	void CheckSectionTree(VCFG_Parser* parser) {
+		for (uint32_t i = 0; i < parser->m_sectionCount; i++) {
+			if (parser->m_sectionTree[i] >= parser->m_sectionCount) std::abort();
+			if (!i) continue;
+
+			VCFGTreeEntry_t previous = { parser->m_parsedData[parser->m_sectionTree[i - 1]].name, parser->m_sectionTree[i - 1] };
+			VCFGTreeEntry_t current = { parser->m_parsedData[parser->m_sectionTree[i]].name, parser->m_sectionTree[i] };
+			if (vcfginternal_compare_tree_entries(&previous, &current) >= 0) std::abort();
+		}
+	}
+
+	// The output of a write that keeps the parsed text has to parse to the same data as the parser holds
+	void CheckPreserved(VCFG_Parser* parser) {
+		VCFGBufferSink_t preserved, expected;
+		int written = vcfg_fuzz::WriteToBuffer(parser, VCFG_WRITE_PRESERVE_FORMATTING, &preserved) && vcfg_fuzz::WriteToBuffer(parser, VCFG_WRITE_COMPACT, &expected);
+		if (!written) {
+			if (vcfg_get_last_error(parser) != VCFG_ERROR_NOT_REPRESENTABLE) std::abort();
+			std::free(preserved.data);
+			return;
+		}
+
+		// The parser owns the preserved output from now on
+		VCFG_Parser reparsed;
+		if (preserved.length) {
+			vcfg_set_buffer(&reparsed, preserved.data, preserved.length);
+			if (!vcfg_parse(&reparsed)) std::abort();
+		}
+		else std::free(preserved.data);
+
+		VCFGBufferSink_t actual;
+		if (!vcfg_fuzz::WriteToBuffer(&reparsed, VCFG_WRITE_COMPACT, &actual)) std::abort();
+		if ((actual.length != expected.length) || (actual.length && std::memcmp(actual.data, expected.data, actual.length))) std::abort();
+		std::free(actual.data);
+		std::free(expected.data);
+		vcfg_clear(&reparsed);
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+	VCFG_Parser parser;
+	vcfg_fuzz::ParseWithBudget(&parser, data, size);
+	int parsed = (vcfg_get_last_error(&parser) == VCFG_ERROR_NONE) && parser.m_sectionCount;
+	if (size & 1) vcfg_build_index(&parser);
+	if (size & 2) vcfg_build_section_tree(&parser);
+
+	// Nothing was changed yet, so the input has to come out as it went in (syntax errors included)
+	VCFGBufferSink_t unchanged;
+	if (!vcfg_fuzz::WriteToBuffer(&parser, VCFG_WRITE_PRESERVE_FORMATTING, &unchanged) || (unchanged.length != size) || (size && std::memcmp(unchanged.data, data, size))) std::abort();
+	std::free(unchanged.data);
+
+	// Every 4 bytes are one operation: the kind, the section, the key and an argument
+	for (size_t i = 0; (i + 4 <= size) && (i < 4 * 64); i += 4) {
+		char sectionBuffer[16], nameBuffer[16];
+		std::snprintf(sectionBuffer, sizeof(sectionBuffer), "s%u", (unsigned)(data[i + 1] & 7));
+		VCFGSection_t* section = vcfg_add_section(&parser, (data[i + 1] & 8) ? sectionBuffer : nullptr);
+		if (!section) continue;
+
+		const char* sectionName = section->name;
+		const char* keyName = PickKey(section, data[i + 2], nameBuffer);
+		uint8_t argument = data[i + 3];
+
+		switch (data[i] & 7) {
+			case 0: vcfg_set_string(&parser, sectionName, keyName, (argument & 1) ? "a b" : ""); break;
+			case 1: vcfg_set_int(&parser, sectionName, keyName, (int64_t)argument * -1000003); break;
+			case 2: vcfg_set_float(&parser, sectionName, keyName, (argument == 255) ? HUGE_VAL : (double)argument / 7.0); break;
+			case 3: vcfg_set_bool(&parser, sectionName, keyName, argument & 1); break;
+			case 4: vcfg_set_int_in_node(&parser, vcfg_set_object(&parser, sectionName, keyName), (argument & 1) ? "x" : "y", argument); break;
+			case 5: {
+				VCFG_Node* array = vcfg_set_array(&parser, sectionName, keyName);
+				if (array) vcfg_insert_value(&parser, array, array->childCount ? argument % (array->childCount + 1) : 0, "v");
+				break;
+			}
+			case 6: {
+				VCFG_Node* array = vcfg_set_array(&parser, sectionName, keyName);
+				if (!array || !array->childCount) break;
+				char indexBuffer[16];
+				std::snprintf(indexBuffer, sizeof(indexBuffer), "%u", (unsigned)(argument % array->childCount));
+				if (argument & 1) vcfg_remove_key_from_node(&parser, array, indexBuffer);
+				else vcfg_set_array_in_node(&parser, array, indexBuffer);
+				break;
+			}
+			default: vcfg_remove_key(&parser, sectionName, keyName); break;
+		}
+	}
+
+	for (uint32_t s = 0; s < parser.m_sectionCount; s++) {
+		CheckKeys(parser.m_parsedData[s].keys, parser.m_parsedData[s].keyCount, 0);
+	}
+	if (parser.m_index) CheckIndex(&parser);
+	if (parser.m_sectionTree) CheckSectionTree(&parser);
+	vcfg_fuzz::CheckRoundTrip(&parser);
+	if (parsed) CheckPreserved(&parser);
+
+	// Names and values are freed with the size given by strlen, so inputs with NUL bytes can't balance
+	vcfg_clear(&parser);
+	if (parser.m_parsedBytes && !std::memchr(data, 0, size)) std::abort();
+	return 0;
+}
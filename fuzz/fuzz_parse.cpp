@@ -0,0 +1,58 @@
+// libFuzzer / AFL++ harness for vcfg_parse and vcfg_write.
+// Inputs of odd length are parsed with the integer expressions folded and the durations and sizes converted,
+// inputs with the second bit of the length set with the references resolved.
+
+#include "fuzz_common.h"
+
+namespace {
+	// A checksummed write has to verify and strip down to the plain write, a changed byte has to fail it
+	void CheckChecksum(VCFG_Parser* parser) {
+		VCFGBufferSink_t plain, checked;
+		if (!vcfg_fuzz::WriteToBuffer(parser, VCFG_WRITE_COMPACT, &plain)) {
+			std::free(plain.data);
+			return;
+		}
+		if (!vcfg_fuzz::WriteToBuffer(parser, VCFG_WRITE_COMPACT | VCFG_WRITE_CHECKSUM, &checked)) std::abort();
+
+		size_t expectedLength = plain.length + ((plain.length && (plain.data[plain.length - 1] != '\n')) ? 1 : 0);
+		VCFG_Parser verified;
+		verified.m_configBuffer = checked.data;
+		verified.m_configBufferLength = checked.length;
+		if (!vcfg_verify_checksum(&verified) || (verified.m_configBufferLength != expectedLength)) std::abort();
+		if (plain.length && std::memcmp(checked.data, plain.data, plain.length)) std::abort();
+
+		// The new line before the trailer is left alone, without it there is no trailer to check
+		VCFG_Parser corrupted;
+		if (plain.length > 1) {
+			checked.data[(plain.length - 1) / 2] ^= 0x20;
+			corrupted.m_configBuffer = checked.data;
+			corrupted.m_configBufferLength = checked.length;
+			if (vcfg_verify_checksum(&corrupted)) std::abort();
+		}
+
+		verified.m_configBuffer = corrupted.m_configBuffer = nullptr;
+		std::free(plain.data);
+		std::free(checked.data);
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+	VCFG_Parser parser;
+	vcfg_set_options(&parser, VCFG_OPTION_COLLECT_ALL_ERRORS | ((size & 1) ? (VCFG_OPTION_EXPRESSIONS | VCFG_OPTION_UNITS) : 0) | ((size & 2) ? VCFG_OPTION_INTERPOLATE : 0));
+	vcfg_fuzz::ParseWithBudget(&parser, data, size);
+
+	// Every error has to point into the input
+	for (uint32_t i = 0; i < vcfg_get_error_count(&parser); i++) {
+		VCFGLocation_t location;
+		if (!vcfg_get_location(&parser, vcfg_get_error(&parser, i)->offset, &location)) std::abort();
+	}
+
+	// Whatever was parsed has to be written back to an equivalent configuration
+	if (vcfg_get_last_error(&parser) == VCFG_ERROR_NONE) {
+		vcfg_fuzz::CheckRoundTrip(&parser);
+		CheckChecksum(&parser);
+	}
+
+	vcfg_clear(&parser);
+	return 0;
+}
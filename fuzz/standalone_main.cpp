@@ -0,0 +1,63 @@
+// Driver for the fuzzing harnesses when libFuzzer is not available (e.g. GCC builds).
+//
+// Runs LLVMFuzzerTestOneInput on every file given on the command line (directories are
+// expanded one level deep) or on the standard input when there are no arguments,
+// which is what AFL++ expects from a target without its own driver.
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+	void RunInput(const std::vector<char>& input) {
+		LLVMFuzzerTestOneInput((const uint8_t*)input.data(), input.size());
+	}
+
+	bool RunFile(const std::filesystem::path& path) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			std::fprintf(stderr, "Failed to open %s\n", path.string().c_str());
+			return false;
+		}
+
+		std::vector<char> input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		std::printf("Running: %s (%zu bytes)\n", path.string().c_str(), input.size());
+		RunInput(input);
+		return true;
+	}
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::vector<char> input((std::istreambuf_iterator<char>(std::cin)), std::istreambuf_iterator<char>());
+		RunInput(input);
+		return 0;
+	}
+
+	size_t inputCount = 0;
+	for (int i = 1; i < argc; i++) {
+		std::filesystem::path path(argv[i]);
+		std::error_code error;
+		if (std::filesystem::is_directory(path, error)) {
+			for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(path, error)) {
+				if (!entry.is_regular_file()) continue;
+				if (!RunFile(entry.path())) return 1;
+				++inputCount;
+			}
+		}
+		else {
+			if (!RunFile(path)) return 1;
+			++inputCount;
+		}
+	}
+
+	std::printf("Executed %zu inputs\n", inputCount);
+	return 0;
+}
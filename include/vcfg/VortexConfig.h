@@ -29,7 +29,25 @@
 #define VORTEX_CONFIG_H 1
 
 #include "macros.h"
+#include "trace.h"
+#include "memory.h"
+#include "profile.h"
+#include "layout.h"
+#include "errors.h"
+#include "budget.h"
+#include "checksum.h"
+#include "index.h"
+#include "tree.h"
+#include "expressions.h"
+#include "units.h"
 #include "implementation.h"
+#include "mutation.h"
+#include "interpolation.h"
+#include "layers.h"
+#include "scopes.h"
+#include "overrides.h"
+#include "schema.h"
+#include "writer.h"
 #include "parser.h"
 #include "strconv.h"
 
@@ -0,0 +1,164 @@
+﻿/*
+ * budget.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef VCFG_BUDGET_H
+#define VCFG_BUDGET_H 1
+
+#include "parser.h"
+#include "macros.h"
+#include "errors.h"
+
+// The clock is read only once every VCFG_DEADLINE_CHECK_INTERVAL nodes
+#ifndef VCFG_DEADLINE_CHECK_INTERVAL
+	#define VCFG_DEADLINE_CHECK_INTERVAL 64
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+	#include <time.h>
+
+	/**
+	 *	@brief Read a nanosecond clock.
+	 *
+	 *	Uses the monotonic clock when it's available and falls back to the C11 calendar clock
+	 *
+	 *	@returns (uint64_t) current time in nanoseconds
+	 */
+	inline uint64_t vcfginternal_now_ns(void) {
+		struct timespec now;
+	#if defined(CLOCK_MONOTONIC)
+		clock_gettime(CLOCK_MONOTONIC, &now);
+	#else
+		timespec_get(&now, TIME_UTC);
+	#endif
+		return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+	}
+
+	/**
+	 *	@brief Set resource limits.
+	 *
+	 *	Limits the number of nodes, the nesting depth, the length of the strings, the total memory
+	 *	and the time of the following parses. When a limit is exceeded parsing stops immediately,
+	 *	vcfg_parse returns 0 and vcfg_get_last_error tells which limit it was.
+	 *	The data parsed before the failure stays available until vcfg_clear
+	 *
+	 *	@param limits - the limits (0 members are unlimited, NULL removes all the limits)
+	 */
+	inline void vcfg_set_limits(VCFG_Parser* parserObj, const VCFGLimits_t* limits) {
+		VCFGLimits_t noLimits = { 0 };
+		parserObj->m_limits = limits ? *limits : noLimits;
+	}
+
+	/**
+	 *	@brief Start enforcing the limits of a new parse.
+	 */
+	inline void vcfginternal_begin_budget(VCFG_Parser* parserObj) {
+		parserObj->m_lastError = VCFG_ERROR_NONE;
+		vcfginternal_clear_errors(parserObj);
+		parserObj->m_nodeCount = 0;
+		parserObj->m_nestingDepth = 0;
+		parserObj->m_deadlineCountdown = VCFG_DEADLINE_CHECK_INTERVAL;
+		parserObj->m_deadline = parserObj->m_limits.timeBudgetNs ? vcfginternal_now_ns() + parserObj->m_limits.timeBudgetNs : 0;
+	}
+
+	/**
+	 *	@brief Account a new section or key.
+	 *
+	 *	Checks the node limit and, every VCFG_DEADLINE_CHECK_INTERVAL nodes, the deadline
+	 *
+	 *	@returns 0 - A limit was exceeded, 1 - Success
+	 */
+	inline int vcfginternal_add_node(VCFG_Parser* parserObj) {
+		++(parserObj->m_nodeCount);
+		if (parserObj->m_limits.maxNodes && (parserObj->m_nodeCount > parserObj->m_limits.maxNodes)) {
+			vcfginternal_set_error(parserObj, VCFG_ERROR_TOO_MANY_NODES);
+			return 0;
+		}
+
+		if (parserObj->m_deadline && (--(parserObj->m_deadlineCountdown) == 0)) {
+			parserObj->m_deadlineCountdown = VCFG_DEADLINE_CHECK_INTERVAL;
+			if (vcfginternal_now_ns() > parserObj->m_deadline) {
+				vcfginternal_set_error(parserObj, VCFG_ERROR_TIMEOUT);
+				return 0;
+			}
+		}
+		return 1;
+	}
+
+	/**
+	 *	@brief Check the length of a name or value.
+	 *
+	 *	@returns 0 - The string is too long, 1 - Success
+	 */
+	inline int vcfginternal_check_string(VCFG_Parser* parserObj, size_t length) {
+		if (parserObj->m_limits.maxStringLength && (length > parserObj->m_limits.maxStringLength)) {
+			vcfginternal_set_error(parserObj, VCFG_ERROR_STRING_TOO_LONG);
+			return 0;
+		}
+		return 1;
+	}
+
+	/**
+	 *	@brief Check if the parsed data can grow by the given number of bytes.
+	 *
+	 *	@returns 0 - The byte limit would be exceeded, 1 - Success
+	 */
+	inline int vcfginternal_check_bytes(VCFG_Parser* parserObj, size_t size) {
+		size_t maxTotalBytes = parserObj->m_limits.maxTotalBytes;
+		if (maxTotalBytes && (parserObj->m_configBufferLength + parserObj->m_parsedBytes + size > maxTotalBytes)) {
+			vcfginternal_set_error(parserObj, VCFG_ERROR_TOO_LARGE);
+			return 0;
+		}
+		return 1;
+	}
+
+	/**
+	 *	@brief Enter an array or object.
+	 *
+	 *	Arrays and objects are parsed recursively, so the nesting depth is always limited to
+	 *	VCFG_MAX_NESTING_DEPTH, even when the limits allow more
+	 *
+	 *	@returns 0 - The maximum depth was reached, 1 - Success
+	 */
+	inline int vcfginternal_enter_nesting(VCFG_Parser* parserObj) {
+		uint32_t maxDepth = VCFG_MAX_NESTING_DEPTH;
+		if (parserObj->m_limits.maxDepth && (parserObj->m_limits.maxDepth < maxDepth)) maxDepth = parserObj->m_limits.maxDepth;
+
+		if (parserObj->m_nestingDepth >= maxDepth) {
+			vcfginternal_set_error(parserObj, VCFG_ERROR_TOO_DEEP);
+			return 0;
+		}
+		++(parserObj->m_nestingDepth);
+		return 1;
+	}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_BUDGET_H
\ No newline at end of file
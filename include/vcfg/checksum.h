@@ -0,0 +1,252 @@
+﻿/*
+ * checksum.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef VCFG_CHECKSUM_H
+#define VCFG_CHECKSUM_H 1
+
+#include "parser.h"
+#include "macros.h"
+#include "errors.h"
+
+// CRC-32C (Castagnoli) of the configuration files. The SSE4.2 and ARMv8 CRC instructions compute it
+// 8 bytes at a time. Without them a table is used (one byte at a time). On x86 compilers that can target SSE4.2
+// for a single function the instruction is used when the processor supports it, even if the rest
+// of the program is built without SSE4.2
+#if !defined(VCFG_NO_SIMD)
+	#if defined(__SSE4_2__)
+		#define VCFG_CRC32C_SSE42 1
+		#include <nmmintrin.h>
+	#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+		#define VCFG_CRC32C_SSE42 1
+		#define VCFG_CRC32C_DISPATCH 1
+		#include <nmmintrin.h>
+	#elif defined(__ARM_FEATURE_CRC32)
+		#define VCFG_CRC32C_ARM 1
+		#include <arm_acle.h>
+	#endif
+#endif
+
+// Last line of a file written with VCFG_WRITE_CHECKSUM: the prefix, 8 hexadecimal digits and a new line.
+// It's a comment, so the file can be parsed without verifying it
+#define VCFG_CHECKSUM_PREFIX "// vcfg-crc32c: "
+#define VCFG_CHECKSUM_PREFIX_LENGTH 16
+#define VCFG_CHECKSUM_TRAILER_LENGTH (VCFG_CHECKSUM_PREFIX_LENGTH + 9)
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+	/**
+	 *	@brief Update a CRC-32C with a table (one byte at a time).
+	 *
+	 *	@param crc - the inverted CRC of the preceding data
+	 *
+	 *	@returns (uint32_t) the inverted CRC including the data
+	 */
+	inline uint32_t vcfginternal_crc32c_table(uint32_t crc, const unsigned char* data, size_t length) {
+		static const uint32_t crcTable[256] = {
+			0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4, 0xc79a971f, 0x35f1141c, 0x26a1e7e8, 0xd4ca64eb,
+			0x8ad958cf, 0x78b2dbcc, 0x6be22838, 0x9989ab3b, 0x4d43cfd0, 0xbf284cd3, 0xac78bf27, 0x5e133c24,
+			0x105ec76f, 0xe235446c, 0xf165b798, 0x030e349b, 0xd7c45070, 0x25afd373, 0x36ff2087, 0xc494a384,
+			0x9a879fa0, 0x68ec1ca3, 0x7bbcef57, 0x89d76c54, 0x5d1d08bf, 0xaf768bbc, 0xbc267848, 0x4e4dfb4b,
+			0x20bd8ede, 0xd2d60ddd, 0xc186fe29, 0x33ed7d2a, 0xe72719c1, 0x154c9ac2, 0x061c6936, 0xf477ea35,
+			0xaa64d611, 0x580f5512, 0x4b5fa6e6, 0xb93425e5, 0x6dfe410e, 0x9f95c20d, 0x8cc531f9, 0x7eaeb2fa,
+			0x30e349b1, 0xc288cab2, 0xd1d83946, 0x23b3ba45, 0xf779deae, 0x05125dad, 0x1642ae59, 0xe4292d5a,
+			0xba3a117e, 0x4851927d, 0x5b016189, 0xa96ae28a, 0x7da08661, 0x8fcb0562, 0x9c9bf696, 0x6ef07595,
+			0x417b1dbc, 0xb3109ebf, 0xa0406d4b, 0x522bee48, 0x86e18aa3, 0x748a09a0, 0x67dafa54, 0x95b17957,
+			0xcba24573, 0x39c9c670, 0x2a993584, 0xd8f2b687, 0x0c38d26c, 0xfe53516f, 0xed03a29b, 0x1f682198,
+			0x5125dad3, 0xa34e59d0, 0xb01eaa24, 0x42752927, 0x96bf4dcc, 0x64d4cecf, 0x77843d3b, 0x85efbe38,
+			0xdbfc821c, 0x2997011f, 0x3ac7f2eb, 0xc8ac71e8, 0x1c661503, 0xee0d9600, 0xfd5d65f4, 0x0f36e6f7,
+			0x61c69362, 0x93ad1061, 0x80fde395, 0x72966096, 0xa65c047d, 0x5437877e, 0x4767748a, 0xb50cf789,
+			0xeb1fcbad, 0x197448ae, 0x0a24bb5a, 0xf84f3859, 0x2c855cb2, 0xdeeedfb1, 0xcdbe2c45, 0x3fd5af46,
+			0x7198540d, 0x83f3d70e, 0x90a324fa, 0x62c8a7f9, 0xb602c312, 0x44694011, 0x5739b3e5, 0xa55230e6,
+			0xfb410cc2, 0x092a8fc1, 0x1a7a7c35, 0xe811ff36, 0x3cdb9bdd, 0xceb018de, 0xdde0eb2a, 0x2f8b6829,
+			0x82f63b78, 0x709db87b, 0x63cd4b8f, 0x91a6c88c, 0x456cac67, 0xb7072f64, 0xa457dc90, 0x563c5f93,
+			0x082f63b7, 0xfa44e0b4, 0xe9141340, 0x1b7f9043, 0xcfb5f4a8, 0x3dde77ab, 0x2e8e845f, 0xdce5075c,
+			0x92a8fc17, 0x60c37f14, 0x73938ce0, 0x81f80fe3, 0x55326b08, 0xa759e80b, 0xb4091bff, 0x466298fc,
+			0x1871a4d8, 0xea1a27db, 0xf94ad42f, 0x0b21572c, 0xdfeb33c7, 0x2d80b0c4, 0x3ed04330, 0xccbbc033,
+			0xa24bb5a6, 0x502036a5, 0x4370c551, 0xb11b4652, 0x65d122b9, 0x97baa1ba, 0x84ea524e, 0x7681d14d,
+			0x2892ed69, 0xdaf96e6a, 0xc9a99d9e, 0x3bc21e9d, 0xef087a76, 0x1d63f975, 0x0e330a81, 0xfc588982,
+			0xb21572c9, 0x407ef1ca, 0x532e023e, 0xa145813d, 0x758fe5d6, 0x87e466d5, 0x94b49521, 0x66df1622,
+			0x38cc2a06, 0xcaa7a905, 0xd9f75af1, 0x2b9cd9f2, 0xff56bd19, 0x0d3d3e1a, 0x1e6dcdee, 0xec064eed,
+			0xc38d26c4, 0x31e6a5c7, 0x22b65633, 0xd0ddd530, 0x0417b1db, 0xf67c32d8, 0xe52cc12c, 0x1747422f,
+			0x49547e0b, 0xbb3ffd08, 0xa86f0efc, 0x5a048dff, 0x8ecee914, 0x7ca56a17, 0x6ff599e3, 0x9d9e1ae0,
+			0xd3d3e1ab, 0x21b862a8, 0x32e8915c, 0xc083125f, 0x144976b4, 0xe622f5b7, 0xf5720643, 0x07198540,
+			0x590ab964, 0xab613a67, 0xb831c993, 0x4a5a4a90, 0x9e902e7b, 0x6cfbad78, 0x7fab5e8c, 0x8dc0dd8f,
+			0xe330a81a, 0x115b2b19, 0x020bd8ed, 0xf0605bee, 0x24aa3f05, 0xd6c1bc06, 0xc5914ff2, 0x37faccf1,
+			0x69e9f0d5, 0x9b8273d6, 0x88d28022, 0x7ab90321, 0xae7367ca, 0x5c18e4c9, 0x4f48173d, 0xbd23943e,
+			0xf36e6f75, 0x0105ec76, 0x12551f82, 0xe03e9c81, 0x34f4f86a, 0xc69f7b69, 0xd5cf889d, 0x27a40b9e,
+			0x79b737ba, 0x8bdcb4b9, 0x988c474d, 0x6ae7c44e, 0xbe2da0a5, 0x4c4623a6, 0x5f16d052, 0xad7d5351
+		};
+
+		for (size_t i = 0; i < length; i++) crc = crcTable[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+		return crc;
+	}
+
+#if defined(VCFG_CRC32C_SSE42)
+	#if defined(VCFG_CRC32C_DISPATCH)
+		__attribute__((target("sse4.2")))
+	#endif
+	inline uint32_t vcfginternal_crc32c_sse42(uint32_t crc, const unsigned char* data, size_t length) {
+		size_t i = 0;
+	#if defined(__x86_64__) || defined(_M_X64)
+		uint64_t crc64 = crc;
+		for (; i + 8 <= length; i += 8) {
+			uint64_t block;
+			vcfginternal_memcpy((void*)&block, (const void*)(data + i), 8);
+			crc64 = _mm_crc32_u64(crc64, block);
+		}
+		crc = (uint32_t)crc64;
+	#else
+		for (; i + 4 <= length; i += 4) {
+			uint32_t block;
+			vcfginternal_memcpy((void*)&block, (const void*)(data + i), 4);
+			crc = _mm_crc32_u32(crc, block);
+		}
+	#endif
+		for (; i < length; i++) crc = _mm_crc32_u8(crc, data[i]);
+		return crc;
+	}
+#elif defined(VCFG_CRC32C_ARM)
+	inline uint32_t vcfginternal_crc32c_arm(uint32_t crc, const unsigned char* data, size_t length) {
+		size_t i = 0;
+		for (; i + 8 <= length; i += 8) {
+			uint64_t block;
+			vcfginternal_memcpy((void*)&block, (const void*)(data + i), 8);
+			crc = __crc32cd(crc, block);
+		}
+		for (; i < length; i++) crc = __crc32cb(crc, data[i]);
+		return crc;
+	}
+#endif
+
+	/**
+	 *	@brief Update a CRC-32C.
+	 *
+	 *	@param crc - the inverted CRC of the preceding data (0xffffffff at the start)
+	 *
+	 *	@returns (uint32_t) the inverted CRC including the data
+	 */
+	inline uint32_t vcfginternal_crc32c_update(uint32_t crc, const char* data, size_t length) {
+	#if defined(VCFG_CRC32C_DISPATCH)
+		if (__builtin_cpu_supports("sse4.2")) return vcfginternal_crc32c_sse42(crc, (const unsigned char*)data, length);
+		return vcfginternal_crc32c_table(crc, (const unsigned char*)data, length);
+	#elif defined(VCFG_CRC32C_SSE42)
+		return vcfginternal_crc32c_sse42(crc, (const unsigned char*)data, length);
+	#elif defined(VCFG_CRC32C_ARM)
+		return vcfginternal_crc32c_arm(crc, (const unsigned char*)data, length);
+	#else
+		return vcfginternal_crc32c_table(crc, (const unsigned char*)data, length);
+	#endif
+	}
+
+	/**
+	 *	@brief Compute the CRC-32C of a buffer.
+	 *
+	 *	@param data - the buffer
+	 *	@param length - length of the buffer
+	 *
+	 *	@returns (uint32_t) the checksum
+	 */
+	inline uint32_t vcfg_crc32c(const char* data, size_t length) {
+		return ~vcfginternal_crc32c_update(0xffffffff, data, length);
+	}
+
+	/**
+	 *	@brief Format a checksum trailer.
+	 *
+	 *	@param buffer - at least VCFG_CHECKSUM_TRAILER_LENGTH characters
+	 */
+	inline void vcfginternal_format_checksum(uint32_t checksum, char* buffer) {
+		vcfginternal_memcpy((void*)buffer, (const void*)VCFG_CHECKSUM_PREFIX, VCFG_CHECKSUM_PREFIX_LENGTH);
+		for (int i = 0; i < 8; i++) buffer[VCFG_CHECKSUM_PREFIX_LENGTH + i] = "0123456789abcdef"[(checksum >> (28 - 4 * i)) & 0xf];
+		buffer[VCFG_CHECKSUM_TRAILER_LENGTH - 1] = '\n';
+	}
+
+	/**
+	 *	@brief Find the checksum trailer at the end of a buffer.
+	 *
+	 *	@param checksum - set to the checksum stored in the trailer
+	 *
+	 *	@returns (int) 0 - No trailer, 1 - Success
+	 */
+	inline int vcfginternal_parse_checksum(const char* data, size_t length, uint32_t* checksum) {
+		if (length < VCFG_CHECKSUM_TRAILER_LENGTH) return 0;
+
+		const char* trailer = data + length - VCFG_CHECKSUM_TRAILER_LENGTH;
+		if ((trailer > data) && (*(trailer - 1) != '\n')) return 0;
+		if (trailer[VCFG_CHECKSUM_TRAILER_LENGTH - 1] != '\n') return 0;
+		for (int i = 0; i < VCFG_CHECKSUM_PREFIX_LENGTH; i++) {
+			if (trailer[i] != VCFG_CHECKSUM_PREFIX[i]) return 0;
+		}
+
+		uint32_t result = 0;
+		for (int i = 0; i < 8; i++) {
+			char digit = trailer[VCFG_CHECKSUM_PREFIX_LENGTH + i];
+			if (VCFG_IS_NUMBER(digit)) result = (result << 4) | (uint32_t)(digit - '0');
+			else if ((digit >= 'a') && (digit <= 'f')) result = (result << 4) | (uint32_t)(digit - 'a' + 10);
+			else return 0;
+		}
+		*checksum = result;
+		return 1;
+	}
+
+	/**
+	 *	@brief Verify the checksum of the configuration buffer.
+	 *
+	 *	Checks the trailer written by VCFG_WRITE_CHECKSUM against the rest of the buffer and hides it
+	 *	from the parser (it's left out of m_configBufferLength). A buffer without the trailer passes,
+	 *	unless VCFG_OPTION_REQUIRE_CHECKSUM is set. vcfg_open calls it before parsing
+	 *
+	 *	@returns 0 - Failure (VCFG_ERROR_CHECKSUM_MISMATCH), 1 - Success
+	 */
+	inline int vcfg_verify_checksum(VCFG_Parser* parserObj) {
+		if (!parserObj) return 0;
+
+		uint32_t expected;
+		if (!(parserObj->m_configBuffer) || !vcfginternal_parse_checksum(parserObj->m_configBuffer, parserObj->m_configBufferLength, &expected)) {
+			if (!(parserObj->m_options & VCFG_OPTION_REQUIRE_CHECKSUM)) return 1;
+
+			vcfginternal_set_error(parserObj, VCFG_ERROR_CHECKSUM_MISMATCH);
+			return 0;
+		}
+
+		size_t contentLength = parserObj->m_configBufferLength - VCFG_CHECKSUM_TRAILER_LENGTH;
+		if (vcfg_crc32c(parserObj->m_configBuffer, contentLength) != expected) {
+			vcfginternal_set_error(parserObj, VCFG_ERROR_CHECKSUM_MISMATCH);
+			return 0;
+		}
+
+		parserObj->m_configBufferLength = contentLength;
+		return 1;
+	}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_CHECKSUM_H
@@ -0,0 +1,312 @@
+﻿/*
+ * errors.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef VCFG_ERRORS_H
+#define VCFG_ERRORS_H 1
+
+#include "parser.h"
+#include "macros.h"
+
+#if defined(VCFG_SIMD_SSE2)
+	#include <emmintrin.h>
+#elif defined(VCFG_SIMD_NEON)
+	#include <arm_neon.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+	#include <stdlib.h>
+
+	/**
+	 *	@brief Record an error.
+	 *
+	 *	Only the first error is kept, as everything that fails after it is usually a consequence
+	 */
+	inline void vcfginternal_set_error(VCFG_Parser* parserObj, VCFGError error) {
+		if (parserObj->m_lastError == VCFG_ERROR_NONE) parserObj->m_lastError = error;
+	}
+
+	/**
+	 *	@brief Check if an error is a syntax error.
+	 *
+	 *	Syntax errors follow the I/O and resource limit errors in VCFGError
+	 */
+	inline int vcfginternal_is_syntax_error(VCFGError error) {
+		return (error >= VCFG_ERROR_UNEXPECTED_CHARACTER) ? 1 : 0;
+	}
+
+	/**
+	 *	@brief Append an error record.
+	 *
+	 *	The records are kept outside of the parsed data, so they don't count towards the byte limit.
+	 *	Errors at the same offset are recorded only once, as they are the same problem seen by
+	 *	different parts of the parser
+	 *
+	 *	@param error - kind of the error
+	 *	@param offset - byte offset of the error in the configuration buffer
+	 */
+	inline void vcfginternal_add_error_record(VCFG_Parser* parserObj, VCFGError error, size_t offset) {
+		uint32_t errorCount = parserObj->m_errorCount;
+		if (errorCount && (parserObj->m_errors[errorCount - 1].offset == offset)) return;
+
+		// Like the other arrays, the records grow geometrically and the capacity is always a power of two
+		if ((errorCount & (errorCount - 1)) == 0) {
+			size_t newCapacity = errorCount ? ((size_t)errorCount << 1) : 1;
+			VCFGErrorRecord_t* newErrors = (VCFGErrorRecord_t*)VCFG_REALLOC((void*)(parserObj->m_errors), newCapacity * sizeof(VCFGErrorRecord_t));
+			if (!newErrors) {
+				vcfginternal_set_error(parserObj, VCFG_ERROR_OUT_OF_MEMORY);
+				return;
+			}
+			parserObj->m_errors = newErrors;
+		}
+
+		parserObj->m_errors[errorCount].kind = error;
+		parserObj->m_errors[errorCount].offset = offset;
+		parserObj->m_errorCount = errorCount + 1;
+	}
+
+	/**
+	 *	@brief Report a syntax error.
+	 *
+	 *	Without VCFG_OPTION_COLLECT_ALL_ERRORS the first syntax error stops the parser.
+	 *	Otherwise the error is only recorded and the parser recovers from it
+	 *
+	 *	@param error - kind of the error
+	 *	@param errorPtr - position of the error in the configuration buffer
+	 */
+	inline void vcfginternal_syntax_error(VCFG_Parser* parserObj, VCFGError error, const char* errorPtr) {
+		if (!(parserObj->m_options & VCFG_OPTION_COLLECT_ALL_ERRORS)) {
+			if (parserObj->m_lastError != VCFG_ERROR_NONE) return;
+			parserObj->m_lastError = error;
+		}
+
+		vcfginternal_add_error_record(parserObj, error, (size_t)(errorPtr - parserObj->m_configBuffer));
+	}
+
+	/**
+	 *	@brief Remove all the error records.
+	 */
+	inline void vcfginternal_clear_errors(VCFG_Parser* parserObj) {
+		if (parserObj->m_errors) VCFG_FREE((void*)(parserObj->m_errors));
+		parserObj->m_errors = 0;
+		parserObj->m_errorCount = 0;
+	}
+
+	/**
+	 *	@brief Set parser options.
+	 *
+	 *	@param options - VCFGOption flags combined with |
+	 */
+	inline void vcfg_set_options(VCFG_Parser* parserObj, uint32_t options) {
+		parserObj->m_options = options;
+	}
+
+	/**
+	 *	@brief Get the number of errors found by the last parse.
+	 *
+	 *	Without VCFG_OPTION_COLLECT_ALL_ERRORS there's at most one error
+	 *
+	 *	@returns (uint32_t) number of error records
+	 */
+	inline uint32_t vcfg_get_error_count(VCFG_Parser* parserObj) {
+		return parserObj->m_errorCount;
+	}
+
+	/**
+	 *	@brief Get an error found by the last parse.
+	 *
+	 *	The errors are stored in the order they were found. Resource limit errors are recorded at
+	 *	the offset where the parser stopped
+	 *
+	 *	@param index - index of the error
+	 *
+	 *	@returns (const VCFGErrorRecord_t*) the error or NULL if the index is out of range
+	 */
+	inline const VCFGErrorRecord_t* vcfg_get_error(VCFG_Parser* parserObj, uint32_t index) {
+		if (index >= parserObj->m_errorCount) return 0;
+		return &(parserObj->m_errors[index]);
+	}
+
+	/**
+	 *	@brief Count the new lines in a buffer.
+	 *
+	 *	Compares 16 bytes at a time when SSE2 or NEON is available
+	 *
+	 *	@param data - the buffer
+	 *	@param length - length of the buffer
+	 *
+	 *	@returns (size_t) number of '\n' characters
+	 */
+	inline size_t vcfginternal_count_newlines(const char* data, size_t length) {
+		size_t newlineCount = 0;
+		size_t i = 0;
+
+	#if defined(VCFG_SIMD_SSE2)
+		const __m128i newline = _mm_set1_epi8('\n');
+		while (i + 16 <= length) {
+			// Every match subtracts -1 from its byte lane, so the lanes can't overflow within 255 blocks
+			size_t blockCount = (length - i) / 16;
+			if (blockCount > 255) blockCount = 255;
+
+			__m128i lanes = _mm_setzero_si128();
+			for (size_t block = 0; block < blockCount; block++, i += 16) {
+				lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i)), newline));
+			}
+
+			__m128i sums = _mm_sad_epu8(lanes, _mm_setzero_si128());
+			newlineCount += (size_t)_mm_cvtsi128_si32(sums) + (size_t)_mm_extract_epi16(sums, 4);
+		}
+	#elif defined(VCFG_SIMD_NEON)
+		const uint8x16_t newline = vdupq_n_u8('\n');
+		while (i + 16 <= length) {
+			size_t blockCount = (length - i) / 16;
+			if (blockCount > 255) blockCount = 255;
+
+			uint8x16_t lanes = vdupq_n_u8(0);
+			for (size_t block = 0; block < blockCount; block++, i += 16) {
+				lanes = vsubq_u8(lanes, vceqq_u8(vld1q_u8((const uint8_t*)(data + i)), newline));
+			}
+
+			newlineCount += vaddlvq_u8(lanes);
+		}
+	#endif
+
+		for (; i < length; i++) {
+			if (data[i] == '\n') ++newlineCount;
+		}
+		return newlineCount;
+	}
+
+	/**
+	 *	@brief Get the line and column of a byte offset.
+	 *
+	 *	Nothing is tracked while parsing, the location is computed from the configuration buffer
+	 *	only when it's needed, so it has to be called before vcfg_clear
+	 *
+	 *	@param offset - offset in the configuration buffer (e.g. the offset of an error record)
+	 *	@param location - the structure to fill
+	 *
+	 *	@returns 0 - Failure (the offset is out of range), 1 - Success
+	 */
+	inline int vcfg_get_location(VCFG_Parser* parserObj, size_t offset, VCFGLocation_t* location) {
+		if (!location || !(parserObj->m_configBuffer) || (offset > parserObj->m_configBufferLength)) return 0;
+
+		const char* data = parserObj->m_configBuffer;
+		size_t lineStart = offset;
+		while ((lineStart > 0) && (data[lineStart - 1] != '\n')) --lineStart;
+
+		location->line = vcfginternal_count_newlines(data, lineStart) + 1;
+		location->column = offset - lineStart + 1;
+		return 1;
+	}
+
+	/**
+	 *	@brief Get the last error.
+	 *
+	 *	Returns the reason why the last vcfg_open, vcfg_parse or vcfg_write failed
+	 *
+	 *	@returns (VCFGError) the error (VCFG_ERROR_NONE if the last call succeeded)
+	 */
+	inline VCFGError vcfg_get_last_error(VCFG_Parser* parserObj) {
+		return parserObj->m_lastError;
+	}
+
+	/**
+	 *	@brief Get error description.
+	 *
+	 *	@returns (const char*) a short description of the error
+	 */
+	inline const char* vcfg_error_string(VCFGError error) {
+		switch (error) {
+			case VCFG_ERROR_NONE: return "no error";
+			case VCFG_ERROR_IO: return "the file couldn't be read";
+			case VCFG_ERROR_OUT_OF_MEMORY: return "out of memory";
+			case VCFG_ERROR_TOO_LARGE: return "the configuration exceeds the byte limit";
+			case VCFG_ERROR_TOO_MANY_NODES: return "the configuration exceeds the node limit";
+			case VCFG_ERROR_TOO_DEEP: return "arrays or objects are nested too deep";
+			case VCFG_ERROR_STRING_TOO_LONG: return "a name or value exceeds the string length limit";
+			case VCFG_ERROR_TIMEOUT: return "parsing exceeded the time budget";
+			case VCFG_ERROR_NOT_REPRESENTABLE: return "a name or value can't be written in the configuration syntax";
+			case VCFG_ERROR_CHECKSUM_MISMATCH: return "the checksum doesn't match the file";
+			case VCFG_ERROR_INVALID_OVERRIDE: return "invalid override";
+			case VCFG_ERROR_INVALID_REFERENCE: return "a reference to a key that doesn't exist or isn't a value";
+			case VCFG_ERROR_REFERENCE_CYCLE: return "values refer to each other";
+			case VCFG_ERROR_INVALID_SCHEMA: return "invalid schema rule";
+			case VCFG_ERROR_UNEXPECTED_CHARACTER: return "unexpected character";
+			case VCFG_ERROR_UNTERMINATED_COMMENT: return "unterminated block comment";
+			case VCFG_ERROR_UNTERMINATED_SECTION: return "unterminated section name";
+			case VCFG_ERROR_EMPTY_SECTION_NAME: return "empty section name";
+			case VCFG_ERROR_UNTERMINATED_STRING: return "unterminated quoted string";
+			case VCFG_ERROR_EMPTY_KEY: return "empty key";
+			case VCFG_ERROR_MISSING_EQUALS: return "expected = after the key";
+			case VCFG_ERROR_MISSING_VALUE: return "missing value";
+			case VCFG_ERROR_UNTERMINATED_ARRAY: return "unterminated array";
+			case VCFG_ERROR_UNTERMINATED_OBJECT: return "unterminated object";
+			case VCFG_ERROR_UNKNOWN_PARENT: return "the parent section isn't defined before the section";
+			case VCFG_ERROR_INVALID_EXPRESSION: return "the expression overflows, divides by zero or is nested too deep";
+			case VCFG_ERROR_INVALID_QUANTITY: return "the duration or size doesn't fit in 64 bits";
+		}
+		return "unknown error";
+	}
+
+	/**
+	 *	@brief Get getter status description.
+	 *
+	 *	@returns (const char*) a short description of the status
+	 */
+	inline const char* vcfg_status_string(VCFGStatus status) {
+		switch (status) {
+			case VCFG_STATUS_OK: return "ok";
+			case VCFG_STATUS_NOT_FOUND: return "the section or the key doesn't exist";
+			case VCFG_STATUS_INVALID_FORMAT: return "the value has a different type";
+			case VCFG_STATUS_OUT_OF_RANGE: return "the number is out of range";
+		}
+		return "unknown status";
+	}
+
+	/**
+	 *	@brief Get schema violation description.
+	 *
+	 *	@returns (const char*) a short description of the violation
+	 */
+	inline const char* vcfg_violation_string(VCFGViolationKind kind) {
+		switch (kind) {
+			case VCFG_VIOLATION_MISSING: return "the required key doesn't exist";
+			case VCFG_VIOLATION_WRONG_TYPE: return "the value has a different type";
+			case VCFG_VIOLATION_OUT_OF_RANGE: return "the value is out of range";
+			case VCFG_VIOLATION_NO_MATCH: return "the value doesn't match the pattern";
+			case VCFG_VIOLATION_NOT_ALLOWED: return "the value isn't one of the allowed values";
+		}
+		return "unknown violation";
+	}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_ERRORS_H
\ No newline at end of file
@@ -0,0 +1,306 @@
+﻿/*
+ * expressions.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#ifndef VCFG_EXPRESSIONS_H
+#define VCFG_EXPRESSIONS_H 1
+
+#include "parser.h"
+#include "macros.h"
+#include "strconv.h"
+
+// With VCFG_OPTION_EXPRESSIONS an unquoted value can be an integer expression (4 * 1024 * 1024, 1 << 20) that is
+// folded to its result while parsing, so the getters read a plain number. The operators are the ones of C with the same
+// precedence: unary - + ~, * / %, + -, << >>, &, ^ and |, grouped with parentheses. The numbers are decimal or hexadecimal (0x).
+// The evaluation is done in 64bit integers and stops at the first overflow, division by zero or at VCFG_MAX_EXPRESSION_DEPTH
+// nested parentheses and unary operators. Values without a binary operator or parentheses ("-5", "10ms") aren't expressions.
+// Binary operators need blanks on both sides and decimal numbers can't have leading zeros, so dates (2020-01-01),
+// ranges (10-20) and times (08:00) are kept as they are
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+	#include <stdint.h>
+
+	// Maximum number of nested parentheses and unary operators in an expression
+	#ifndef VCFG_MAX_EXPRESSION_DEPTH
+		#define VCFG_MAX_EXPRESSION_DEPTH 32
+	#endif
+
+	// Result of vcfginternal_fold_expression
+	#define VCFG_EXPRESSION_NONE 0		// The value isn't an expression
+	#define VCFG_EXPRESSION_FOLDED 1
+	#define VCFG_EXPRESSION_INVALID 2	// An expression that overflows, divides by zero or is nested too deep
+
+	// State of the evaluation of a single expression
+	typedef struct VCFGExpression {
+		const char* ptr;
+		const char* end;
+		int operatorCount;		// Binary operators and parentheses
+		int invalid;			// Overflow or division by zero (the rest is still parsed to find out if it's an expression)
+		int malformed;			// Not an expression or nested too deep
+		int tooDeep;
+	} VCFGExpression_t;
+
+	/**
+	 *	@brief Skip the spaces and tabs in an expression (new lines end it).
+	 */
+	inline void vcfginternal_expression_skip_blanks(VCFGExpression_t* expression) {
+		while ((expression->ptr < expression->end) && ((*(expression->ptr) == ' ') || (*(expression->ptr) == '\t'))) ++(expression->ptr);
+	}
+
+	/**
+	 *	@brief Check if a character can continue a number or a name (it can't follow a number of an expression).
+	 */
+	inline int vcfginternal_is_word_character(char c) {
+		return VCFG_IS_NUMBER(c) || ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || (c == '_') || (c == '.');
+	}
+
+	/**
+	 *	@brief Parse a decimal or hexadecimal number.
+	 */
+	inline int64_t vcfginternal_expression_number(VCFGExpression_t* expression) {
+		const char* ptr = expression->ptr;
+		int hexadecimal = ((expression->end - ptr) > 2) && (ptr[0] == '0') && ((ptr[1] == 'x') || (ptr[1] == 'X'));
+		if (hexadecimal) ptr += 2;
+
+		uint64_t value = 0;
+		const char* digitsStart = ptr;
+		for (; ptr < expression->end; ++ptr) {
+			char c = *ptr;
+			uint64_t digit;
+			if (VCFG_IS_NUMBER(c)) digit = (uint64_t)(c - '0');
+			else if (hexadecimal && (c >= 'a') && (c <= 'f')) digit = (uint64_t)(c - 'a' + 10);
+			else if (hexadecimal && (c >= 'A') && (c <= 'F')) digit = (uint64_t)(c - 'A' + 10);
+			else break;
+
+			uint64_t base = hexadecimal ? 16 : 10;
+			if (value > ((uint64_t)INT64_MAX - digit) / base) expression->invalid = 1;
+			else value = value * base + digit;
+		}
+
+		// 1.5, 10ms, 0x without digits or 01 aren't numbers of an expression
+		if ((ptr == digitsStart) || ((ptr < expression->end) && vcfginternal_is_word_character(*ptr))) expression->malformed = 1;
+		if (!hexadecimal && (*digitsStart == '0') && ((ptr - digitsStart) > 1)) expression->malformed = 1;
+		expression->ptr = ptr;
+		return (int64_t)value;
+	}
+
+	/**
+	 *	@brief Get the precedence of the binary operator at the current position.
+	 *
+	 *	@param length - set to the length of the operator
+	 *
+	 *	@returns (int) the precedence (higher binds tighter) or 0 if there's no binary operator
+	 */
+	inline int vcfginternal_expression_operator(const VCFGExpression_t* expression, int* length) {
+		const char* ptr = expression->ptr;
+		*length = 1;
+		if (ptr >= expression->end) return 0;
+
+		int hasNext = (ptr + 1) < expression->end;
+		switch (*ptr) {
+			case '|': return 1;
+			case '^': return 2;
+			case '&': return 3;
+			case '<':
+			case '>':
+				if (!hasNext || (ptr[1] != ptr[0])) return 0;
+				*length = 2;
+				return 4;
+			case '+':
+			case '-': return 5;
+			// A comment (// or /*) ends the expression
+			case '/': return (hasNext && ((ptr[1] == '/') || (ptr[1] == '*'))) ? 0 : 6;
+			case '*':
+			case '%': return 6;
+		}
+		return 0;
+	}
+
+	/**
+	 *	@brief Apply a binary operator.
+	 *
+	 *	Overflows, divisions by zero and shifts by more than 63 bits mark the expression as invalid
+	 */
+	inline int64_t vcfginternal_expression_apply(VCFGExpression_t* expression, char op, int64_t left, int64_t right) {
+		uint64_t result = 0;
+		switch (op) {
+			case '|': return left | right;
+			case '^': return left ^ right;
+			case '&': return left & right;
+			case '<':
+				if ((right < 0) || (right > 63)) break;
+				result = (uint64_t)left << right;
+				if (((int64_t)result >> right) != left) break;
+				return (int64_t)result;
+			case '>':
+				if ((right < 0) || (right > 63)) break;
+				return left >> right;
+			case '+':
+				result = (uint64_t)left + (uint64_t)right;
+				if (((left < 0) == (right < 0)) && (((int64_t)result < 0) != (left < 0))) break;
+				return (int64_t)result;
+			case '-':
+				result = (uint64_t)left - (uint64_t)right;
+				if (((left < 0) != (right < 0)) && (((int64_t)result < 0) != (left < 0))) break;
+				return (int64_t)result;
+			case '*':
+				if (left && right) {
+					if ((left == -1 && right == INT64_MIN) || (right == -1 && left == INT64_MIN)) break;
+					int64_t product = (int64_t)((uint64_t)left * (uint64_t)right);
+					if ((product / right) != left) break;
+					return product;
+				}
+				return 0;
+			case '/':
+			case '%':
+				if (!right || ((left == INT64_MIN) && (right == -1))) break;
+				return (op == '/') ? (left / right) : (left % right);
+		}
+
+		expression->invalid = 1;
+		return 0;
+	}
+
+	inline int64_t vcfginternal_expression_binary(VCFGExpression_t* expression, int minPrecedence, int depth);
+
+	/**
+	 *	@brief Parse a number, a parenthesized expression or a unary operator.
+	 */
+	inline int64_t vcfginternal_expression_primary(VCFGExpression_t* expression, int depth) {
+		vcfginternal_expression_skip_blanks(expression);
+		if (expression->ptr >= expression->end) {
+			expression->malformed = 1;
+			return 0;
+		}
+
+		char c = *(expression->ptr);
+		if ((c == '(') || (c == '-') || (c == '+') || (c == '~')) {
+			if (depth >= VCFG_MAX_EXPRESSION_DEPTH) {
+				expression->malformed = 1;
+				expression->tooDeep = 1;
+				return 0;
+			}
+			++(expression->ptr);
+		}
+
+		if (c == '(') {
+			++(expression->operatorCount);
+			int64_t value = vcfginternal_expression_binary(expression, 1, depth + 1);
+			vcfginternal_expression_skip_blanks(expression);
+			if ((expression->ptr >= expression->end) || (*(expression->ptr) != ')')) expression->malformed = 1;
+			else ++(expression->ptr);
+			return value;
+		}
+		if ((c == '-') || (c == '+') || (c == '~')) {
+			int64_t value = vcfginternal_expression_primary(expression, depth + 1);
+			if (c == '~') return ~value;
+			if (c == '+') return value;
+			if (value == INT64_MIN) expression->invalid = 1;
+			return (value == INT64_MIN) ? 0 : -value;
+		}
+		if (!VCFG_IS_NUMBER(c)) {
+			expression->malformed = 1;
+			return 0;
+		}
+		return vcfginternal_expression_number(expression);
+	}
+
+	/**
+	 *	@brief Parse the binary operators of at least the given precedence (precedence climbing).
+	 *
+	 *	An operator without blanks on both sides (10-20) makes the value a plain string
+	 */
+	inline int64_t vcfginternal_expression_binary(VCFGExpression_t* expression, int minPrecedence, int depth) {
+		int64_t left = vcfginternal_expression_primary(expression, depth);
+		while (!(expression->malformed)) {
+			vcfginternal_expression_skip_blanks(expression);
+
+			int length = 0;
+			int precedence = vcfginternal_expression_operator(expression, &length);
+			if (!precedence || (precedence < minPrecedence)) break;
+
+			// There's always an operand before the operator
+			const char* next = expression->ptr + length;
+			char previous = expression->ptr[-1];
+			if (((previous != ' ') && (previous != '\t')) || (next >= expression->end) || ((*next != ' ') && (*next != '\t'))) {
+				expression->malformed = 1;
+				break;
+			}
+
+			char op = *(expression->ptr);
+			expression->ptr += length;
+			++(expression->operatorCount);
+
+			// The operators are left associative, so the right side only takes the ones that bind tighter
+			int64_t right = vcfginternal_expression_binary(expression, precedence + 1, depth);
+			if (!(expression->invalid)) left = vcfginternal_expression_apply(expression, op, left, right);
+		}
+		return left;
+	}
+
+	/**
+	 *	@brief Fold an unquoted value that is an integer expression.
+	 *
+	 *	The expression ends at the end of the line, a comment or the characters that end an unquoted value
+	 *
+	 *	@param start - start of the value
+	 *	@param end - end of the configuration buffer
+	 *	@param closingChar - the character that closes the array or object the value is in (0 for none)
+	 *	@param result - set to the folded value
+	 *	@param expressionEnd - set to the end of the expression (VCFG_EXPRESSION_FOLDED and VCFG_EXPRESSION_INVALID only)
+	 *
+	 *	@returns (int) VCFG_EXPRESSION_NONE, VCFG_EXPRESSION_FOLDED or VCFG_EXPRESSION_INVALID
+	 */
+	inline int vcfginternal_fold_expression(const char* start, const char* end, char closingChar, int64_t* result, const char** expressionEnd) {
+		VCFGExpression_t expression = { start, end, 0, 0, 0, 0 };
+		int64_t value = vcfginternal_expression_binary(&expression, 1, 0);
+		const char* lastToken = expression.ptr;
+		vcfginternal_expression_skip_blanks(&expression);
+
+		// Whatever follows has to end the value
+		const char* ptr = expression.ptr;
+		int ended = (ptr >= end) || (*ptr == '\n') || (*ptr == '\r') || (*ptr == ',') || (*ptr == ';') || (closingChar && (*ptr == closingChar)) ||
+			((*ptr == '/') && ((ptr + 1) < end) && ((ptr[1] == '/') || (ptr[1] == '*')));
+		if (expression.tooDeep) {
+			while ((ptr < end) && (*ptr != '\n') && (*ptr != ',') && (*ptr != ';') && (!closingChar || (*ptr != closingChar))) ++ptr;
+			*expressionEnd = ptr;
+			return VCFG_EXPRESSION_INVALID;
+		}
+		if (expression.malformed || !ended || !(expression.operatorCount)) return VCFG_EXPRESSION_NONE;
+
+		*expressionEnd = lastToken;
+		if (expression.invalid) return VCFG_EXPRESSION_INVALID;
+		*result = value;
+		return VCFG_EXPRESSION_FOLDED;
+	}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_EXPRESSIONS_H
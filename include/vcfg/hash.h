@@ -0,0 +1,65 @@
+﻿/*
+ * hash.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef VCFG_HASH_H
+#define VCFG_HASH_H 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+	#include <stdint.h>
+
+	// FNV-1a offset basis, the hash of an empty path
+	#define VCFG_HASH_SEED 14695981039346656037ull
+
+	/**
+	 *	@brief Append a name to a path hash.
+	 *
+	 *	Paths are hashed one name at a time (section, key, child key, ...) with a separator
+	 *	after every name, so that "ab"/"c" and "a"/"bc" don't collide
+	 *
+	 *	@param hash - hash of the parent path (VCFG_HASH_SEED for an empty path)
+	 *	@param name - the name to append (NULL is hashed as an empty name, e.g. the root section)
+	 *
+	 *	@returns (uint64_t) hash of the path (never 0)
+	 */
+	inline uint64_t vcfginternal_hash_append(uint64_t hash, const char* name) {
+		for (const char* ch = name; ch && *ch; ch++) {
+			hash ^= (unsigned char)(*ch);
+			hash *= 1099511628211ull;
+		}
+
+		hash ^= 0xFF;
+		hash *= 1099511628211ull;
+		return (hash ? hash : 1);
+	}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_HASH_H
\ No newline at end of file
@@ -31,6 +31,16 @@
 #include "parser.h"
 #include "macros.h"
 #include "strconv.h"
+#include "memory.h"
+#include "trace.h"
+#include "profile.h"
+#include "errors.h"
+#include "budget.h"
+#include "checksum.h"
+#include "index.h"
+#include "tree.h"
+#include "expressions.h"
+#include "units.h"
 
 // All the necessary C code
 #ifdef __cplusplus
@@ -51,7 +61,7 @@ extern "C" {
 	inline void vcfg_set_buffer(VCFG_Parser* parserObj, const char* inputBuffer, size_t dataLength) {
 		// If the buffer was already set try to free it
 		if (parserObj->m_configBuffer) {
-			free((void*)(parserObj->m_configBuffer));
+			VCFG_FREE((void*)(parserObj->m_configBuffer));
 			parserObj->m_configBuffer = 0;
 		}
 
@@ -75,7 +85,7 @@ extern "C" {
 		if (!internalDataPtr) return 0;
 
 		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
-		while (VCFG_IS_WHITESPACE(*internalDataPtr) && (internalDataPtr < dataEndPtr)) {
+		while ((internalDataPtr < dataEndPtr) && VCFG_IS_WHITESPACE(*internalDataPtr)) {
 			++internalDataPtr;
 		}
 
@@ -102,14 +112,14 @@ extern "C" {
 		if (!internalDataPtr) return 0;
 
 		// Check if we have a comment "//"
-		if ((*internalDataPtr != '/') || (*(internalDataPtr + 1) != '/')) return 0;
-
 		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
+		if ((internalDataPtr + 1 >= dataEndPtr) || (*internalDataPtr != '/') || (*(internalDataPtr + 1) != '/')) return 0;
+
 		while ((internalDataPtr < dataEndPtr) && (*internalDataPtr != '\n')) {
 			++internalDataPtr;
 		}
 
-		if (*internalDataPtr == '\n') ++internalDataPtr;
+		if ((internalDataPtr < dataEndPtr) && (*internalDataPtr == '\n')) ++internalDataPtr;
 
 		if (internalDataPtr == *dataPtr) return 0;
 
@@ -134,19 +144,22 @@ extern "C" {
 		if (!internalDataPtr) return 0;
 
 		// Check if we have a comment block "/*"
-		if ((*internalDataPtr != '/') || (*(internalDataPtr + 1) != '*')) return 0;
+		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
+		if ((internalDataPtr + 1 >= dataEndPtr) || (*internalDataPtr != '/') || (*(internalDataPtr + 1) != '*')) return 0;
 
 		// Skip the first comment block characters to avoid something like this: "/*/"
 		internalDataPtr += 2;
 
-		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
+		int commentClosed = 0;
 		while ((internalDataPtr < dataEndPtr)) {
-			if ((*internalDataPtr == '*') && (*(internalDataPtr + 1) == '/')) {
+			if ((*internalDataPtr == '*') && (internalDataPtr + 1 < dataEndPtr) && (*(internalDataPtr + 1) == '/')) {
 				internalDataPtr += 2;
+				commentClosed = 1;
 				break;
 			}
 			++internalDataPtr;
 		}
+		if (!commentClosed) vcfginternal_syntax_error(parserObj, VCFG_ERROR_UNTERMINATED_COMMENT, *dataPtr);
 
 		if (internalDataPtr == *dataPtr) return 0;
 
@@ -180,6 +193,38 @@ extern "C" {
 		return skippedCount;
 	}
 
+	/**
+	 *	@brief Find the section a section inherits from.
+	 *
+	 *	The first [name : parent] header builds the hash index of the sections parsed so far, the sections
+	 *	after it are added to the index as they are created, so every parent takes a single probe.
+	 *	vcfg_parse drops the index again (it doesn't hold the keys parsed after it was built)
+	 *
+	 *	@param parentName - name of the parent in the configuration buffer
+	 *	@param nameLength - length of the name
+	 *
+	 *	@returns (uint32_t) position of the parent or 0 if there's no section with the name
+	 */
+	inline uint32_t vcfginternal_find_parent(VCFG_Parser* parserObj, const char* parentName, size_t nameLength) {
+		if (!nameLength || !vcfginternal_check_string(parserObj, nameLength)) return 0;
+		if (!(parserObj->m_index) && !vcfg_build_index(parserObj)) {
+			vcfginternal_set_error(parserObj, VCFG_ERROR_OUT_OF_MEMORY);
+			return 0;
+		}
+
+		char* name = (char*)vcfginternal_malloc(parserObj, nameLength + 1);
+		if (!name) {
+			vcfginternal_set_error(parserObj, VCFG_ERROR_OUT_OF_MEMORY);
+			return 0;
+		}
+		vcfginternal_memcpy((void*)name, (void*)parentName, nameLength);
+		name[nameLength] = '\0';
+
+		VCFGSection_t* parent = vcfginternal_index_find_section(parserObj, name);
+		vcfginternal_free(parserObj, (void*)name, nameLength + 1);
+		return parent ? (uint32_t)(parent - parserObj->m_parsedData) : 0;
+	}
+
 	/**
 	 *	@brief Create a new section in the parsed data structure.
 	 *
@@ -196,47 +241,230 @@ extern "C" {
 		const char* internalDataPtr = *dataPtr;
 		if (!internalDataPtr) return 0;
 
-		if (*internalDataPtr != '[') return 0;
+		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
+		if ((internalDataPtr >= dataEndPtr) || (*internalDataPtr != '[')) return 0;
 
 		// If we have a [ it means we have to create a new section that we "push" on top
 		// of the previously added section (for that reason section names have to be unique)
 		++internalDataPtr;
 		size_t nameLength = 0;
-		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
-		while ((*internalDataPtr != ']') && (internalDataPtr < dataEndPtr)) {
+		const char* nameStart = internalDataPtr;
+		while ((internalDataPtr < dataEndPtr) && (*internalDataPtr != ']')) {
 			++internalDataPtr;
 			++nameLength;
 		}
-		if (*internalDataPtr == ']') ++internalDataPtr;
+		if ((internalDataPtr < dataEndPtr) && (*internalDataPtr == ']')) ++internalDataPtr;
+		else vcfginternal_syntax_error(parserObj, VCFG_ERROR_UNTERMINATED_SECTION, *dataPtr);
 		size_t skippedCount = internalDataPtr - *dataPtr;
+		const char* sectionStart = *dataPtr;
 		*dataPtr = internalDataPtr;
 
-		// We don't allow empty sections -> []
-		if (nameLength == 0) return skippedCount;
+		// [name : parent] -> the section inherits the keys it doesn't have from the parent
+		const char* parentStart = 0;
+		size_t parentLength = 0;
+		for (size_t i = 0; (i < nameLength) && !parentStart; i++) {
+			if (nameStart[i] != ':') continue;
+
+			parentStart = nameStart + i + 1;
+			parentLength = nameLength - i - 1;
+			nameLength = i;
+			while (nameLength && ((nameStart[nameLength - 1] == ' ') || (nameStart[nameLength - 1] == '\t'))) --nameLength;
+			while (parentLength && ((*parentStart == ' ') || (*parentStart == '\t'))) {
+				++parentStart;
+				--parentLength;
+			}
+		}
 
-		++(parserObj->m_sectionCount);
-		VCFGSection_t* newSections = (VCFGSection_t*)realloc(parserObj->m_parsedData, (parserObj->m_sectionCount) * sizeof(VCFGSection_t));
-		if (!newSections) {
-			--(parserObj->m_sectionCount);
+		// We don't allow empty sections -> []
+		if (nameLength == 0) {
+			vcfginternal_syntax_error(parserObj, VCFG_ERROR_EMPTY_SECTION_NAME, sectionStart);
 			return skippedCount;
 		}
+		if (!vcfginternal_check_string(parserObj, nameLength) || !vcfginternal_add_node(parserObj)) return skippedCount;
+
+		uint32_t parent = 0;
+		if (parentStart) {
+			parent = vcfginternal_find_parent(parserObj, parentStart, parentLength);
+			if (parserObj->m_lastError && !vcfginternal_is_syntax_error(parserObj->m_lastError)) return skippedCount;
+			if (!parent) vcfginternal_syntax_error(parserObj, VCFG_ERROR_UNKNOWN_PARENT, sectionStart);
+		}
+
+		VCFGSection_t* newSections = (VCFGSection_t*)vcfginternal_grow_array(parserObj, parserObj->m_parsedData, parserObj->m_sectionCount, sizeof(VCFGSection_t));
+		if (!newSections) return skippedCount;
+		parserObj->m_parsedData = newSections;
+		++(parserObj->m_sectionCount);
 
 		newSections[(parserObj->m_sectionCount) - 1].keyCount = 0;
+		newSections[(parserObj->m_sectionCount) - 1].parent = parent;
 		newSections[(parserObj->m_sectionCount) - 1].keys = 0;
-		newSections[(parserObj->m_sectionCount) - 1].name = (char*)malloc(nameLength + 1);
+	#if defined(VCFG_ENABLE_LOSSLESS)
+		newSections[(parserObj->m_sectionCount) - 1].headerEnd = (size_t)(internalDataPtr - parserObj->m_configBuffer);
+		newSections[(parserObj->m_sectionCount) - 1].sourceFlags = VCFG_SOURCE_PARSED;
+	#endif
+		newSections[(parserObj->m_sectionCount) - 1].name = (char*)vcfginternal_malloc(parserObj, nameLength + 1);
 		if (!(newSections[(parserObj->m_sectionCount) - 1].name)) {
 			--(parserObj->m_sectionCount);
 			return skippedCount;
 		}
 
-		vcfginternal_memcpy((void*)(newSections[(parserObj->m_sectionCount) - 1].name), (void*)(internalDataPtr - nameLength - 1), nameLength);
+		vcfginternal_memcpy((void*)(newSections[(parserObj->m_sectionCount) - 1].name), (void*)nameStart, nameLength);
 		newSections[(parserObj->m_sectionCount) - 1].name[nameLength] = '\0';
+		vcfginternal_index_add(parserObj, (parserObj->m_sectionCount) - 1, VCFG_INDEX_SECTION);
 
-		parserObj->m_parsedData = newSections;
+		VCFG_TRACE_EVENT(parserObj, VCFG_TRACE_SECTION, section, newSections[(parserObj->m_sectionCount) - 1].name, (parserObj->m_sectionCount) - 1);
 
 		return skippedCount;
 	}
 
+	/**
+	 *	@brief Initialize a key.
+	 *
+	 *	Sets all the members of a newly added key to their default values
+	 */
+	inline void vcfginternal_init_key(VCFGKey_t* key) {
+		VCFGKey_t emptyKey = { 0 };
+		*key = emptyKey;
+	}
+
+	/**
+	 *	@brief Skip to the end of an array or object.
+	 *
+	 *	Skips everything up to the closing character of the current array or object,
+	 *	stepping over nested arrays, objects and quoted strings. The closing character is not skipped
+	 *
+	 *	@param dataPtr - pointer to the raw data buffer
+	 *	@param closingChar - the closing character (']' or '}')
+	 *
+	 *	@returns (size_t) number of bytes skipped
+	 */
+	inline size_t vcfginternal_skiptoclosing(VCFG_Parser* parserObj, const char** dataPtr, char closingChar) {
+		if (!dataPtr) return 0;
+
+		const char* internalDataPtr = *dataPtr;
+		if (!internalDataPtr) return 0;
+
+		// Iterative, so that deeply nested input can't overflow the stack
+		size_t nestingDepth = 0;
+		int inQuotes = 0;
+		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
+		while (internalDataPtr < dataEndPtr) {
+			char currentChar = *internalDataPtr;
+			if (inQuotes) {
+				if (currentChar == '"') inQuotes = 0;
+			}
+			else if (currentChar == '"') inQuotes = 1;
+			else if ((currentChar == '[') || (currentChar == '{')) ++nestingDepth;
+			else if ((currentChar == ']') || (currentChar == '}')) {
+				if (!nestingDepth && (currentChar == closingChar)) break;
+				if (nestingDepth) --nestingDepth;
+			}
+			++internalDataPtr;
+		}
+
+		size_t skippedCount = internalDataPtr - *dataPtr;
+		*dataPtr = internalDataPtr;
+		return skippedCount;
+	}
+
+#if defined(VCFG_ENABLE_LOSSLESS)
+	// The parser remembers where every key is in the configuration buffer. Everything between the keys
+	// (whitespace, comments and separators) is never copied, it stays a view into m_configBuffer and
+	// vcfg_write with VCFG_WRITE_PRESERVE_FORMATTING copies it from there around the changed values
+
+	/**
+	 *	@brief Record the start of a parsed key.
+	 *
+	 *	@param entryStart - start of the name (of the value for array elements)
+	 *	@param valueStart - start of the value
+	 */
+	inline void vcfginternal_source_begin(VCFG_Parser* parserObj, VCFGKey_t* key, const char* entryStart, const char* valueStart) {
+		key->entryOffset = (size_t)(entryStart - parserObj->m_configBuffer);
+		key->valueOffset = (size_t)(valueStart - parserObj->m_configBuffer);
+		key->valueLength = 0;
+		key->sourceFlags = VCFG_SOURCE_PARSED;
+	}
+
+	/**
+	 *	@brief Record the end of the value of a parsed key.
+	 */
+	inline void vcfginternal_source_end(VCFG_Parser* parserObj, VCFGKey_t* key, const char* valueEnd) {
+		key->valueLength = (size_t)(valueEnd - parserObj->m_configBuffer) - key->valueOffset;
+	}
+
+	#define VCFG_SOURCE_BEGIN(parserObj, key, entryStart, valueStart) vcfginternal_source_begin(parserObj, key, entryStart, valueStart)
+	#define VCFG_SOURCE_END(parserObj, key, valueEnd) vcfginternal_source_end(parserObj, key, valueEnd)
+
+	/**
+	 *	@brief Get the text of a parsed key.
+	 *
+	 *	The key, its value and the separator after it. A key that is alone on its line takes the whole line with it
+	 *
+	 *	@returns (VCFGSpan_t) range of the configuration buffer
+	 */
+	inline VCFGSpan_t vcfginternal_source_span(VCFG_Parser* parserObj, const VCFGKey_t* key) {
+		const char* data = parserObj->m_configBuffer;
+		size_t length = parserObj->m_configBufferLength;
+		size_t start = key->entryOffset;
+		size_t end = key->valueOffset + key->valueLength;
+		if (end > length) end = length;
+		if (start > end) start = end;
+
+		while ((end < length) && ((data[end] == ' ') || (data[end] == '\t'))) ++end;
+		if ((end < length) && (data[end] == ',')) {
+			++end;
+			while ((end < length) && ((data[end] == ' ') || (data[end] == '\t'))) ++end;
+		}
+
+		size_t lineStart = start;
+		while ((lineStart > 0) && ((data[lineStart - 1] == ' ') || (data[lineStart - 1] == '\t'))) --lineStart;
+		if (((lineStart == 0) || (data[lineStart - 1] == '\n')) && ((end == length) || (data[end] == '\n') || (data[end] == '\r'))) {
+			start = lineStart;
+			if ((end < length) && (data[end] == '\r')) ++end;
+			if ((end < length) && (data[end] == '\n')) ++end;
+		}
+
+		VCFGSpan_t span = { start, end - start };
+		return span;
+	}
+
+	/**
+	 *	@brief Remember the text of a parsed key that is being removed.
+	 *
+	 *	@returns 0 - Failure, 1 - Success (also for keys that weren't parsed)
+	 */
+	inline int vcfginternal_log_removal(VCFG_Parser* parserObj, const VCFGKey_t* key) {
+		if (!(key->sourceFlags & VCFG_SOURCE_PARSED)) return 1;
+
+		// The capacity is always a power of two, like the capacity of the error records
+		uint32_t removedCount = parserObj->m_removedCount;
+		if ((removedCount & (removedCount - 1)) == 0) {
+			size_t newCapacity = removedCount ? ((size_t)removedCount << 1) : 1;
+			VCFGSpan_t* newSpans = (VCFGSpan_t*)VCFG_REALLOC((void*)(parserObj->m_removedSpans), newCapacity * sizeof(VCFGSpan_t));
+			if (!newSpans) {
+				vcfginternal_set_error(parserObj, VCFG_ERROR_OUT_OF_MEMORY);
+				return 0;
+			}
+			parserObj->m_removedSpans = newSpans;
+		}
+
+		parserObj->m_removedSpans[removedCount] = vcfginternal_source_span(parserObj, key);
+		parserObj->m_removedCount = removedCount + 1;
+		return 1;
+	}
+
+	/**
+	 *	@brief Forget the removed keys.
+	 */
+	inline void vcfginternal_clear_removals(VCFG_Parser* parserObj) {
+		if (parserObj->m_removedSpans) VCFG_FREE((void*)(parserObj->m_removedSpans));
+		parserObj->m_removedSpans = 0;
+		parserObj->m_removedCount = 0;
+	}
+#else
+	#define VCFG_SOURCE_BEGIN(parserObj, key, entryStart, valueStart)
+	#define VCFG_SOURCE_END(parserObj, key, valueEnd)
+#endif // VCFG_ENABLE_LOSSLESS
+
 	// Forward declare the needed function
 	inline size_t vcfginternal_parsearray_keyvalue(VCFG_Parser* parserObj, const char** dataPtr, size_t valueIndex, VCFGKey_t* keyValuePair);
 	inline size_t vcfginternal_parsearray(VCFG_Parser* parserObj, const char** dataPtr, VCFGKey_t* keyValuePair) {
@@ -245,35 +473,58 @@ extern "C" {
 		const char* internalDataPtr = *dataPtr;
 		if (!internalDataPtr) return 0;
 
-		if (*internalDataPtr != '[') return 0;
+		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
+		if ((internalDataPtr >= dataEndPtr) || (*internalDataPtr != '[')) return 0;
 		++internalDataPtr;
 
-		keyValuePair->value = (char*)malloc(8 * sizeof(char));
+		if (!vcfginternal_enter_nesting(parserObj)) {
+			vcfginternal_skiptoclosing(parserObj, &internalDataPtr, ']');
+			if (internalDataPtr < dataEndPtr) ++internalDataPtr;
+
+			size_t skippedCount = internalDataPtr - *dataPtr;
+			*dataPtr = internalDataPtr;
+			return skippedCount;
+		}
+
+		keyValuePair->value = (char*)vcfginternal_malloc(parserObj, 8 * sizeof(char));
 		if (keyValuePair->value) {
 			vcfginternal_memcpy((void*)(keyValuePair->value), (void*)"[array]\0", 8);
 		}
 
 		vcfginternal_skipwhitespace(parserObj, &internalDataPtr);
 
-		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
 		size_t arrayIndex = 0;
-		while ((internalDataPtr < dataEndPtr) && (*internalDataPtr != ']')) {
+		while ((internalDataPtr < dataEndPtr) && (*internalDataPtr != ']') && !(parserObj->m_lastError)) {
 			// Skip all whitespaces and comments
 			if (vcfginternal_skipwhitespace(parserObj, &internalDataPtr)) continue;
 			if (vcfginternal_skipcomments(parserObj, &internalDataPtr)) continue;
 
-			if (vcfginternal_parsearray_keyvalue(parserObj, &internalDataPtr, arrayIndex, keyValuePair)) {
-				vcfginternal_skipwhitespace(parserObj, &internalDataPtr);
-				if (*internalDataPtr == ',') {
+			size_t elementLength = vcfginternal_parsearray_keyvalue(parserObj, &internalDataPtr, arrayIndex, keyValuePair);
+			vcfginternal_skipwhitespace(parserObj, &internalDataPtr);
+			if ((internalDataPtr < dataEndPtr) && (*internalDataPtr == ',')) {
+				++internalDataPtr;
+				if (elementLength) ++arrayIndex;
+				continue;
+			}
+
+			// Always make progress, even on characters that can't start a value
+			if (!elementLength) {
+				if (internalDataPtr < dataEndPtr) {
+					vcfginternal_syntax_error(parserObj, VCFG_ERROR_UNEXPECTED_CHARACTER, internalDataPtr);
 					++internalDataPtr;
-					++arrayIndex;
-					continue;
 				}
+				continue;
+			}
 
-				// If there was no comma skip to the end of the array
-				while ((internalDataPtr < dataEndPtr) && (*internalDataPtr != ']')) ++internalDataPtr;
+			// If there was no comma skip to the end of the array
+			if ((internalDataPtr < dataEndPtr) && (*internalDataPtr != ']')) {
+				vcfginternal_syntax_error(parserObj, VCFG_ERROR_UNEXPECTED_CHARACTER, internalDataPtr);
+				vcfginternal_skiptoclosing(parserObj, &internalDataPtr, ']');
 			}
 		}
+		if (internalDataPtr < dataEndPtr) ++internalDataPtr;
+		else vcfginternal_syntax_error(parserObj, VCFG_ERROR_UNTERMINATED_ARRAY, *dataPtr);
+		--(parserObj->m_nestingDepth);
 
 		size_t skippedCount = internalDataPtr - *dataPtr;
 		*dataPtr = internalDataPtr;
@@ -288,68 +539,126 @@ extern "C" {
 		const char* internalDataPtr = *dataPtr;
 		if (!internalDataPtr) return 0;
 
-		if (*internalDataPtr != '{') return 0;
+		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
+		if ((internalDataPtr >= dataEndPtr) || (*internalDataPtr != '{')) return 0;
 		++internalDataPtr;
 
-		keyValuePair->value = (char*)malloc(9 * sizeof(char));
+		if (!vcfginternal_enter_nesting(parserObj)) {
+			vcfginternal_skiptoclosing(parserObj, &internalDataPtr, '}');
+			if (internalDataPtr < dataEndPtr) ++internalDataPtr;
+
+			size_t skippedCount = internalDataPtr - *dataPtr;
+			*dataPtr = internalDataPtr;
+			return skippedCount;
+		}
+
+		keyValuePair->value = (char*)vcfginternal_malloc(parserObj, 9 * sizeof(char));
 		if (keyValuePair->value) {
 			vcfginternal_memcpy((void*)(keyValuePair->value), (void*)"{object}\0", 9);
 		}
 
 		vcfginternal_skipwhitespace(parserObj, &internalDataPtr);
 
-		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
-		while ((internalDataPtr < dataEndPtr) && (*internalDataPtr != '}')) {
+		while ((internalDataPtr < dataEndPtr) && (*internalDataPtr != '}') && !(parserObj->m_lastError)) {
 			// Skip all whitespaces and comments
 			if (vcfginternal_skipwhitespace(parserObj, &internalDataPtr)) continue;
 			if (vcfginternal_skipcomments(parserObj, &internalDataPtr)) continue;
 
-			if (vcfginternal_parseobject_keyvalue(parserObj, &internalDataPtr, keyValuePair)) {
-				vcfginternal_skipwhitespace(parserObj, &internalDataPtr);
-				if (*internalDataPtr == ',') {
+			size_t pairLength = vcfginternal_parseobject_keyvalue(parserObj, &internalDataPtr, keyValuePair);
+			vcfginternal_skipwhitespace(parserObj, &internalDataPtr);
+			if ((internalDataPtr < dataEndPtr) && (*internalDataPtr == ',')) {
+				++internalDataPtr;
+				continue;
+			}
+
+			// Always make progress, even on characters that can't start a key
+			if (!pairLength) {
+				if (internalDataPtr < dataEndPtr) {
+					vcfginternal_syntax_error(parserObj, VCFG_ERROR_UNEXPECTED_CHARACTER, internalDataPtr);
 					++internalDataPtr;
-					continue;
 				}
-				// If there was no comma skip to the end of the object
-				while ((internalDataPtr < dataEndPtr) && (*internalDataPtr != '}')) ++internalDataPtr;
+				continue;
+			}
+
+			// If there was no comma skip to the end of the object
+			if ((internalDataPtr < dataEndPtr) && (*internalDataPtr != '}')) {
+				vcfginternal_syntax_error(parserObj, VCFG_ERROR_UNEXPECTED_CHARACTER, internalDataPtr);
+				vcfginternal_skiptoclosing(parserObj, &internalDataPtr, '}');
 			}
 		}
+		if (internalDataPtr < dataEndPtr) ++internalDataPtr;
+		else vcfginternal_syntax_error(parserObj, VCFG_ERROR_UNTERMINATED_OBJECT, *dataPtr);
+		--(parserObj->m_nestingDepth);
 
 		size_t skippedCount = internalDataPtr - *dataPtr;
 		*dataPtr = internalDataPtr;
 		return skippedCount;
 	}
-	inline size_t vcfginternal_parsevalue(VCFG_Parser* parserObj, const char** dataPtr, VCFGKey_t* keyValuePair) {
+	/**
+	 *	@brief Parse a value.
+	 *
+	 *	Parses a single quoted or unquoted value and stores it in the key
+	 *
+	 *	@param dataPtr - pointer to the raw data buffer
+	 *	@param closingChar - closing character of the enclosing array or object that ends an unquoted value (0 for none)
+	 *
+	 *	@returns (size_t) number of bytes skipped
+	 */
+	inline size_t vcfginternal_parsevalue(VCFG_Parser* parserObj, const char** dataPtr, VCFGKey_t* keyValuePair, char closingChar) {
 		if (!dataPtr) return 0;
 
 		const char* internalDataPtr = *dataPtr;
 		if (!internalDataPtr) return 0;
 
+		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
+		if (internalDataPtr >= dataEndPtr) return 0;
+
 		int valueInQuotes = (*internalDataPtr == '"') ? 1 : 0;
 		if (valueInQuotes) ++internalDataPtr;
 
 		size_t valueLength = 0;
 		const char* valueStart = internalDataPtr;
-		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
-		while ((internalDataPtr < dataEndPtr)) {
+		int valueClosed = !valueInQuotes;
+
+		// An unquoted integer expression is replaced by its result (see VCFG_OPTION_EXPRESSIONS)
+		char foldedBuffer[24];
+		int expression = VCFG_EXPRESSION_NONE;
+		if (!valueInQuotes && (parserObj->m_options & VCFG_OPTION_EXPRESSIONS)) {
+			int64_t folded = 0;
+			const char* expressionEnd = internalDataPtr;
+			expression = vcfginternal_fold_expression(internalDataPtr, dataEndPtr, closingChar, &folded, &expressionEnd);
+			if (expression != VCFG_EXPRESSION_NONE) internalDataPtr = expressionEnd;
+			if (expression == VCFG_EXPRESSION_FOLDED) {
+				valueLength = vcfginternal_int64tobuf(folded, foldedBuffer);
+				valueStart = foldedBuffer;
+			}
+			else if (expression == VCFG_EXPRESSION_INVALID) vcfginternal_syntax_error(parserObj, VCFG_ERROR_INVALID_EXPRESSION, *dataPtr);
+		}
+
+		while ((internalDataPtr < dataEndPtr) && (expression == VCFG_EXPRESSION_NONE)) {
 			if (valueInQuotes && (*internalDataPtr == '"')) {
 				++internalDataPtr;
+				valueClosed = 1;
 				break;
 			}
-			if (!valueInQuotes && (VCFG_IS_WHITESPACE(*internalDataPtr) || (*internalDataPtr == ',') || (*internalDataPtr == ';'))) break;
+			if (!valueInQuotes && (VCFG_IS_WHITESPACE(*internalDataPtr) || (*internalDataPtr == ',') || (*internalDataPtr == ';') || (closingChar && (*internalDataPtr == closingChar)))) break;
 
 			++internalDataPtr;
 			++valueLength;
 		}
 
+		// "" is an empty value, but an unquoted value has to have at least one character
+		if (!valueClosed) vcfginternal_syntax_error(parserObj, VCFG_ERROR_UNTERMINATED_STRING, *dataPtr);
+		else if (!valueInQuotes && (valueLength == 0) && (expression == VCFG_EXPRESSION_NONE)) vcfginternal_syntax_error(parserObj, VCFG_ERROR_MISSING_VALUE, *dataPtr);
+
 		size_t skippedCount = internalDataPtr - *dataPtr;
-		if (valueLength == 0) {
+		if ((valueLength == 0) || !vcfginternal_check_string(parserObj, valueLength)) {
 			*dataPtr = internalDataPtr;
 			return skippedCount;
 		}
 
 		// Allocate memory for the value
-		keyValuePair->value = (char*)malloc(valueLength + 1);
+		keyValuePair->value = (char*)vcfginternal_malloc(parserObj, valueLength + 1);
 		if (!(keyValuePair->value)) {
 			keyValuePair->value = 0;
 			*dataPtr = internalDataPtr;
@@ -357,6 +666,18 @@ extern "C" {
 		}
 		vcfginternal_memcpy((void*)(keyValuePair->value), (void*)valueStart, valueLength);
 		keyValuePair->value[valueLength] = '\0';
+		keyValuePair->typeTag = vcfginternal_classify_bool(keyValuePair->value);
+
+		// Durations and sizes are stored in nanoseconds and bytes next to the text (see VCFG_OPTION_UNITS),
+		// an unquoted one that doesn't fit is an error
+		if (parserObj->m_options & VCFG_OPTION_UNITS) {
+			vcfginternal_cache_quantity(keyValuePair, valueLength);
+			VCFGQuantity_t quantity;
+			if (!valueInQuotes && (expression == VCFG_EXPRESSION_NONE) && (keyValuePair->quantityTag == VCFG_QUANTITY_UNKNOWN) &&
+				(vcfginternal_parse_quantity(valueStart, valueLength, &quantity) == VCFG_STATUS_OUT_OF_RANGE) && (quantity.kind != VCFG_UNIT_NONE)) {
+				vcfginternal_syntax_error(parserObj, VCFG_ERROR_INVALID_QUANTITY, *dataPtr);
+			}
+		}
 
 		*dataPtr = internalDataPtr;
 		return skippedCount;
@@ -368,8 +689,16 @@ extern "C" {
 		const char* internalDataPtr = *dataPtr;
 		if (!internalDataPtr) return 0;
 
-		char* keyName = vcfginternal_unsignednumtostr(valueIndex);
+		// Empty elements -> [1, , 2] aren't added to the array
+		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
+		if ((internalDataPtr >= dataEndPtr) || (*internalDataPtr == ',') || (*internalDataPtr == ';') || (*internalDataPtr == ']')) return 0;
+
+		// Array elements are named after their index
+		char indexBuffer[24];
+		size_t indexLength = vcfginternal_unsignednumtobuf(valueIndex, indexBuffer);
+		char* keyName = (char*)vcfginternal_malloc(parserObj, indexLength + 1);
 		if (!keyName) return 0;
+		vcfginternal_memcpy((void*)keyName, (void*)indexBuffer, indexLength + 1);
 
 		vcfginternal_skipwhitespace(parserObj, &internalDataPtr);
 
@@ -377,21 +706,19 @@ extern "C" {
 		size_t skippedCount = internalDataPtr - *dataPtr;
 
 		// Add the key to the parent key
-		keyValuePair->childCount++;
-		VCFGKey_t* newChildren = (VCFGKey_t*)realloc((void*)(keyValuePair->children), keyValuePair->childCount * sizeof(VCFGKey_t));
+		VCFGKey_t* newChildren = 0;
+		if (vcfginternal_add_node(parserObj)) newChildren = (VCFGKey_t*)vcfginternal_grow_array(parserObj, (void*)(keyValuePair->children), keyValuePair->childCount, sizeof(VCFGKey_t));
 		if (!newChildren) {
-			keyValuePair->childCount--;
+			vcfginternal_free(parserObj, (void*)keyName, indexLength + 1);
 			*dataPtr = internalDataPtr;
 			return skippedCount;
 		}
-		newChildren[keyValuePair->childCount - 1].childCount = 0;
-		newChildren[keyValuePair->childCount - 1].children = 0;
-		newChildren[keyValuePair->childCount - 1].value = 0;
-		newChildren[keyValuePair->childCount - 1].name = keyName;
-
 		keyValuePair->children = newChildren;
-
-		vcfginternal_skipwhitespace(parserObj, &internalDataPtr);
+		keyValuePair->childCount++;
+		vcfginternal_init_key(&(newChildren[keyValuePair->childCount - 1]));
+		newChildren[keyValuePair->childCount - 1].sourceIndex = keyValuePair->childCount - 1;
+		newChildren[keyValuePair->childCount - 1].name = keyName;
+		VCFG_SOURCE_BEGIN(parserObj, &(newChildren[keyValuePair->childCount - 1]), internalDataPtr, internalDataPtr);
 
 		// Check if the value is an array or object
 		if (*internalDataPtr == '{') {
@@ -401,8 +728,9 @@ extern "C" {
 			vcfginternal_parsearray(parserObj, &internalDataPtr, &(newChildren[keyValuePair->childCount - 1]));
 		}
 		else {
-			vcfginternal_parsevalue(parserObj, &internalDataPtr, &(newChildren[keyValuePair->childCount - 1]));
+			vcfginternal_parsevalue(parserObj, &internalDataPtr, &(newChildren[keyValuePair->childCount - 1]), ']');
 		}
+		VCFG_SOURCE_END(parserObj, &(newChildren[keyValuePair->childCount - 1]), internalDataPtr);
 
 		skippedCount = internalDataPtr - *dataPtr;
 		*dataPtr = internalDataPtr;
@@ -415,48 +743,60 @@ extern "C" {
 		const char* internalDataPtr = *dataPtr;
 		if (!internalDataPtr) return 0;
 
+		// Empty entries -> { a = 1, , b = 2 } are skipped like the empty array elements
+		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
+		if ((internalDataPtr >= dataEndPtr) || (*internalDataPtr == ',') || (*internalDataPtr == '}')) return 0;
+
 		int keyInQuotes = (*internalDataPtr == '"') ? 1 : 0;
 		if (keyInQuotes) ++internalDataPtr;
 
 		size_t keyLength = 0;
 		const char* keyStart = internalDataPtr;
-		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
+		int keyClosed = !keyInQuotes;
 		while ((internalDataPtr < dataEndPtr)) {
 			if (keyInQuotes && (*internalDataPtr == '"')) {
 				++internalDataPtr;
+				keyClosed = 1;
 				break;
 			}
-			if (!keyInQuotes && (VCFG_IS_WHITESPACE(*internalDataPtr) || (*internalDataPtr == '='))) break;
+			if (!keyInQuotes && (VCFG_IS_WHITESPACE(*internalDataPtr) || (*internalDataPtr == '=') || (*internalDataPtr == ',') || (*internalDataPtr == '}'))) break;
 
 			++internalDataPtr;
 			++keyLength;
 		}
+		if (!keyClosed) vcfginternal_syntax_error(parserObj, VCFG_ERROR_UNTERMINATED_STRING, *dataPtr);
 
+		const char* keyEnd = internalDataPtr;
 		vcfginternal_skipwhitespace(parserObj, &internalDataPtr);
 
 		// Don't allow empty keys
 		size_t skippedCount = internalDataPtr - *dataPtr;
 		if (keyLength == 0) {
+			vcfginternal_syntax_error(parserObj, VCFG_ERROR_EMPTY_KEY, *dataPtr);
 			*dataPtr = internalDataPtr;
 			return skippedCount;
 		}
 		// If there's no = it's not a valid key-value pair
-		if (*internalDataPtr != '=') {
+		if ((internalDataPtr >= dataEndPtr) || (*internalDataPtr != '=')) {
+			vcfginternal_syntax_error(parserObj, VCFG_ERROR_MISSING_EQUALS, keyEnd);
+			*dataPtr = internalDataPtr;
+			return skippedCount;
+		}
+		if (!vcfginternal_check_string(parserObj, keyLength) || !vcfginternal_add_node(parserObj)) {
 			*dataPtr = internalDataPtr;
 			return skippedCount;
 		}
 		// Add the key to the parent key
-		keyValuePair->childCount++;
-		VCFGKey_t* newChildren = (VCFGKey_t*)realloc((void*)(keyValuePair->children), keyValuePair->childCount * sizeof(VCFGKey_t));
+		VCFGKey_t* newChildren = (VCFGKey_t*)vcfginternal_grow_array(parserObj, (void*)(keyValuePair->children), keyValuePair->childCount, sizeof(VCFGKey_t));
 		if (!newChildren) {
-			keyValuePair->childCount--;
 			*dataPtr = internalDataPtr;
 			return skippedCount;
 		}
-		newChildren[keyValuePair->childCount - 1].childCount = 0;
-		newChildren[keyValuePair->childCount - 1].children = 0;
-		newChildren[keyValuePair->childCount - 1].value = 0;
-		newChildren[keyValuePair->childCount - 1].name = (char*)malloc(keyLength + 1);
+		keyValuePair->children = newChildren;
+		keyValuePair->childCount++;
+		vcfginternal_init_key(&(newChildren[keyValuePair->childCount - 1]));
+		newChildren[keyValuePair->childCount - 1].sourceIndex = keyValuePair->childCount - 1;
+		newChildren[keyValuePair->childCount - 1].name = (char*)vcfginternal_malloc(parserObj, keyLength + 1);
 		if (!(newChildren[keyValuePair->childCount - 1].name)) {
 			keyValuePair->childCount--;
 			*dataPtr = internalDataPtr;
@@ -465,23 +805,26 @@ extern "C" {
 		vcfginternal_memcpy((void*)(newChildren[keyValuePair->childCount - 1].name), (void*)keyStart, keyLength);
 		newChildren[keyValuePair->childCount - 1].name[keyLength] = '\0';
 
-		keyValuePair->children = newChildren;
-
 		// Skip the equal sign
 		++internalDataPtr;
 
 		vcfginternal_skipwhitespace(parserObj, &internalDataPtr);
+		VCFG_SOURCE_BEGIN(parserObj, &(newChildren[keyValuePair->childCount - 1]), keyStart - keyInQuotes, internalDataPtr);
 
 		// Check if the value is an array or object
-		if (*internalDataPtr == '{') {
+		if (internalDataPtr >= dataEndPtr) {
+			vcfginternal_syntax_error(parserObj, VCFG_ERROR_MISSING_VALUE, internalDataPtr);
+		}
+		else if (*internalDataPtr == '{') {
 			vcfginternal_parseobject(parserObj, &internalDataPtr, &(newChildren[keyValuePair->childCount - 1]));
 		}
 		else if (*internalDataPtr == '[') {
 			vcfginternal_parsearray(parserObj, &internalDataPtr, &(newChildren[keyValuePair->childCount - 1]));
 		}
 		else {
-			vcfginternal_parsevalue(parserObj, &internalDataPtr, &(newChildren[keyValuePair->childCount - 1]));
+			vcfginternal_parsevalue(parserObj, &internalDataPtr, &(newChildren[keyValuePair->childCount - 1]), '}');
 		}
+		VCFG_SOURCE_END(parserObj, &(newChildren[keyValuePair->childCount - 1]), internalDataPtr);
 
 		skippedCount = internalDataPtr - *dataPtr;
 		*dataPtr = internalDataPtr;
@@ -501,9 +844,11 @@ extern "C" {
 		size_t keyLength = 0;
 		const char* keyStart = internalDataPtr;
 		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
+		int keyClosed = !keyInQuotes;
 		while ((internalDataPtr < dataEndPtr)) {
 			if (keyInQuotes && (*internalDataPtr == '"')) {
 				++internalDataPtr;
+				keyClosed = 1;
 				break;
 			}
 			if (!keyInQuotes && (VCFG_IS_WHITESPACE(*internalDataPtr) || (*internalDataPtr == '='))) break;
@@ -511,32 +856,42 @@ extern "C" {
 			++internalDataPtr;
 			++keyLength;
 		}
+		if (!keyClosed) vcfginternal_syntax_error(parserObj, VCFG_ERROR_UNTERMINATED_STRING, *dataPtr);
 
+		const char* keyEnd = internalDataPtr;
 		vcfginternal_skipwhitespace(parserObj, &internalDataPtr);
 
 		// Don't allow empty keys
 		size_t skippedCount = internalDataPtr - *dataPtr;
-		if (keyLength == 0) {
+		int missingEquals = (internalDataPtr >= dataEndPtr) || (*internalDataPtr != '=');
+		if ((keyLength == 0) || missingEquals) {
+			// If there's no = it's not a valid key-value pair
+			if (keyLength == 0) vcfginternal_syntax_error(parserObj, VCFG_ERROR_EMPTY_KEY, *dataPtr);
+			else vcfginternal_syntax_error(parserObj, VCFG_ERROR_MISSING_EQUALS, keyEnd);
+
+			// The rest of the line can't be a valid entry either
+			internalDataPtr = keyEnd;
+			while ((internalDataPtr < dataEndPtr) && (*internalDataPtr != '\n')) ++internalDataPtr;
+
+			skippedCount = internalDataPtr - *dataPtr;
 			*dataPtr = internalDataPtr;
 			return skippedCount;
 		}
-		// If there's no = it's not a valid key-value pair
-		if (*internalDataPtr != '=') {
+		if (!vcfginternal_check_string(parserObj, keyLength) || !vcfginternal_add_node(parserObj)) {
 			*dataPtr = internalDataPtr;
 			return skippedCount;
 		}
 		// Add the key to the current section
-		parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount++;
-		VCFGKey_t* newKeys = (VCFGKey_t*)realloc((void*)(parserObj->m_parsedData[parserObj->m_sectionCount - 1].keys), parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount * sizeof(VCFGKey_t));
+		VCFGKey_t* newKeys = (VCFGKey_t*)vcfginternal_grow_array(parserObj, (void*)(parserObj->m_parsedData[parserObj->m_sectionCount - 1].keys), parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount, sizeof(VCFGKey_t));
 		if (!newKeys) {
-			parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount--;
 			*dataPtr = internalDataPtr;
 			return skippedCount;
 		}
-		newKeys[parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1].childCount = 0;
-		newKeys[parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1].children = 0;
-		newKeys[parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1].value = 0;
-		newKeys[parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1].name = (char*)malloc(keyLength + 1);
+		parserObj->m_parsedData[parserObj->m_sectionCount - 1].keys = newKeys;
+		parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount++;
+		vcfginternal_init_key(&(newKeys[parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1]));
+		newKeys[parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1].sourceIndex = parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1;
+		newKeys[parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1].name = (char*)vcfginternal_malloc(parserObj, keyLength + 1);
 		if (!(newKeys[parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1].name)) {
 			parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount--;
 			*dataPtr = internalDataPtr;
@@ -545,23 +900,26 @@ extern "C" {
 		vcfginternal_memcpy((void*)(newKeys[parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1].name), (void*)keyStart, keyLength);
 		newKeys[parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1].name[keyLength] = '\0';
 
-		parserObj->m_parsedData[parserObj->m_sectionCount - 1].keys = newKeys;
-
 		// Skip the equal sign
 		++internalDataPtr;
 
 		vcfginternal_skipwhitespace(parserObj, &internalDataPtr);
+		VCFG_SOURCE_BEGIN(parserObj, &(newKeys[parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1]), keyStart - keyInQuotes, internalDataPtr);
 
 		// Check if the value is an array or object
-		if (*internalDataPtr == '{') {
+		if (internalDataPtr >= dataEndPtr) {
+			vcfginternal_syntax_error(parserObj, VCFG_ERROR_MISSING_VALUE, internalDataPtr);
+		}
+		else if (*internalDataPtr == '{') {
 			vcfginternal_parseobject(parserObj, &internalDataPtr, &(newKeys[parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1]));
 		}
 		else if (*internalDataPtr == '[') {
 			vcfginternal_parsearray(parserObj, &internalDataPtr, &(newKeys[parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1]));
 		}
 		else {
-			vcfginternal_parsevalue(parserObj, &internalDataPtr, &(newKeys[parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1]));
+			vcfginternal_parsevalue(parserObj, &internalDataPtr, &(newKeys[parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1]), 0);
 		}
+		VCFG_SOURCE_END(parserObj, &(newKeys[parserObj->m_parsedData[parserObj->m_sectionCount - 1].keyCount - 1]), internalDataPtr);
 
 		skippedCount = internalDataPtr - *dataPtr;
 		*dataPtr = internalDataPtr;
@@ -573,12 +931,15 @@ extern "C" {
 	 *
 	 *	Parses the configuration data stored in the raw data buffer.
 	 *	This function has to be called explicitly when using static buffers.
-	 *	When using vcfg_open, this function is called automatically
+	 *	When using vcfg_open, this function is called automatically.
+	 *	Parsing stops at the first resource limit that is exceeded (see vcfg_set_limits)
+	 *	and at the first syntax error, unless VCFG_OPTION_COLLECT_ALL_ERRORS is set (see vcfg_get_error)
 	 *
-	 *	@returns 0 - Failure, 1 - Success
+	 *	@returns 0 - Failure (see vcfg_get_last_error), 1 - Success
 	 */
 	inline int vcfg_parse(VCFG_Parser* parserObj) {
 		if (!(parserObj->m_configBuffer) || !(parserObj->m_configBufferLength)) return 0;
+		vcfginternal_begin_budget(parserObj);
 
 		// We need to store the end of the buffer to avoid overflowing
 		const char* dataEndPtr = parserObj->m_configBuffer + parserObj->m_configBufferLength;
@@ -586,15 +947,23 @@ extern "C" {
 		// We work on a temporary variable to ensure the original pointer is in tact
 		const char* internalDataPtr = parserObj->m_configBuffer;
 
+		VCFG_TRACE_EVENT(parserObj, VCFG_TRACE_PARSE_BEGIN, parse_begin, (const char*)0, parserObj->m_configBufferLength);
+	#if defined(VCFG_ENABLE_TRACING)
+		// The allocations are measured separately, so we subtract them from the scan time at the end
+		uint64_t allocCyclesBefore = parserObj->m_timings.cycles[VCFG_PHASE_ALLOC];
+		VCFG_TIMER_START(scanTimer);
+	#endif
+
 		// Allocate buffer for the root section
-		parserObj->m_parsedData = (VCFGSection_t*)calloc(1, sizeof(VCFGSection_t));
+		parserObj->m_parsedData = (VCFGSection_t*)vcfginternal_calloc(parserObj, 1, sizeof(VCFGSection_t));
 		if (!(parserObj->m_parsedData)) return 0;
 		parserObj->m_sectionCount = 1;
+		++(parserObj->m_nodeCount);
+	#if defined(VCFG_ENABLE_LOSSLESS)
+		parserObj->m_parsedData[0].sourceFlags = VCFG_SOURCE_PARSED;
+	#endif
 
-		// TODO:
-		//	- Maybe a better error handling?
-		//	- Test for edge cases
-		while (internalDataPtr < dataEndPtr) {
+		while ((internalDataPtr < dataEndPtr) && !(parserObj->m_lastError)) {
 			// Skip all whitespaces and comments
 			if (vcfginternal_skipwhitespace(parserObj, &internalDataPtr)) continue;
 			if (vcfginternal_skipcomments(parserObj, &internalDataPtr)) continue;
@@ -606,11 +975,32 @@ extern "C" {
 			// The only thing left to do is to parse the key-value pairs
 			if (vcfginternal_parsekeyvalue(parserObj, &internalDataPtr)) continue;
 
-			// If everything returned with 0 (no data was parsed) just break
-			break;
+			// Nothing was parsed, so we can only skip the character
+			vcfginternal_syntax_error(parserObj, VCFG_ERROR_UNEXPECTED_CHARACTER, internalDataPtr);
+			++internalDataPtr;
 		}
 
-		return 1;
+		// The syntax errors are recorded as they are found, the other errors where the parser stopped
+		if ((parserObj->m_lastError != VCFG_ERROR_NONE) && !vcfginternal_is_syntax_error(parserObj->m_lastError)) {
+			vcfginternal_add_error_record(parserObj, parserObj->m_lastError, (size_t)(internalDataPtr - parserObj->m_configBuffer));
+		}
+		else if ((parserObj->m_lastError == VCFG_ERROR_NONE) && parserObj->m_errorCount) {
+			parserObj->m_lastError = parserObj->m_errors[0].kind;
+		}
+
+	#if defined(VCFG_ENABLE_TRACING)
+		VCFG_TIMER_STOP(parserObj, VCFG_PHASE_SCAN, scanTimer);
+		parserObj->m_timings.cycles[VCFG_PHASE_SCAN] -= parserObj->m_timings.cycles[VCFG_PHASE_ALLOC] - allocCyclesBefore;
+	#endif
+		VCFG_TRACE_EVENT(parserObj, VCFG_TRACE_PARSE_END, parse_end, (const char*)0, parserObj->m_sectionCount);
+
+		// The index built to find the parent sections doesn't hold all the keys
+		if (parserObj->m_index) vcfginternal_free_index(parserObj);
+		if ((parserObj->m_lastError == VCFG_ERROR_NONE) && (parserObj->m_options & VCFG_OPTION_BUILD_INDEX)) vcfg_build_index(parserObj);
+		if ((parserObj->m_lastError == VCFG_ERROR_NONE) && (parserObj->m_options & VCFG_OPTION_NESTED_SECTIONS)) vcfg_build_section_tree(parserObj);
+		if ((parserObj->m_lastError == VCFG_ERROR_NONE) && (parserObj->m_options & VCFG_OPTION_INTERPOLATE)) vcfg_interpolate(parserObj);
+
+		return (parserObj->m_lastError == VCFG_ERROR_NONE) ? 1 : 0;
 	}
 
 	// For embedded systems we can avoid using file operations and use only statically defined buffers
@@ -621,7 +1011,8 @@ extern "C" {
 /**
  *	@brief Open configuration file.
  *
- *	Opens the configuration file and reads the content to the internal buffer
+ *	Opens the configuration file and reads the content to the internal buffer.
+ *	The checksum trailer is verified before parsing (see vcfg_verify_checksum)
  *
  *	@param s_path - path to the configuration file
  *
@@ -634,10 +1025,15 @@ extern "C" {
 			parserObj->m_currentConfigFile = 0;
 		}
 
+		VCFG_TRACE_EVENT(parserObj, VCFG_TRACE_OPEN_BEGIN, open_begin, s_path, 0);
+		VCFG_TIMER_START(ioTimer);
+		parserObj->m_lastError = VCFG_ERROR_NONE;
+
 		// Open the desired file
 		parserObj->m_currentConfigFile = fopen(s_path, "rb");
 		if (!(parserObj->m_currentConfigFile)) {
 			perror("FOPEN()");
+			vcfginternal_set_error(parserObj, VCFG_ERROR_IO);
 			return 0; // Failure
 		}
 
@@ -646,28 +1042,44 @@ extern "C" {
 		size_t fileSize = ftell(parserObj->m_currentConfigFile);
 		fseek(parserObj->m_currentConfigFile, 0, SEEK_SET);
 
+		// Don't even read files that exceed the byte limit
+		if (parserObj->m_limits.maxTotalBytes && (fileSize > parserObj->m_limits.maxTotalBytes)) {
+			vcfginternal_set_error(parserObj, VCFG_ERROR_TOO_LARGE);
+			return 0;
+		}
+
 		// Clear the previously used buffer
 		if (parserObj->m_configBuffer) {
-			free((void*)(parserObj->m_configBuffer));
+			VCFG_FREE((void*)(parserObj->m_configBuffer));
 			parserObj->m_configBuffer = 0;
 		}
 
 		// Allocate memory
-		parserObj->m_configBuffer = (char*)malloc((fileSize + 1) * sizeof(char));
+		parserObj->m_configBuffer = (char*)VCFG_MALLOC((fileSize + 1) * sizeof(char));
 		if (!(parserObj->m_configBuffer)) {
 			perror("MALLOC()");
+			vcfginternal_set_error(parserObj, VCFG_ERROR_OUT_OF_MEMORY);
 			return 0;
 		}
 
 		// Read the file contents into the buffer
 		if (fread((void*)(parserObj->m_configBuffer), sizeof(char), fileSize, parserObj->m_currentConfigFile) != fileSize) {
 			perror("FREAD()");
+			vcfginternal_set_error(parserObj, VCFG_ERROR_IO);
 			return 0;
 		};
 
 		parserObj->m_configBufferLength = fileSize;
 
-		return vcfg_parse(parserObj);
+		VCFG_TIMER_STOP(parserObj, VCFG_PHASE_IO, ioTimer);
+
+		// A file that was cut short or corrupted isn't parsed at all
+		if (!vcfg_verify_checksum(parserObj)) return 0;
+
+		int result = vcfg_parse(parserObj);
+		VCFG_TRACE_EVENT(parserObj, VCFG_TRACE_OPEN_END, open_end, s_path, fileSize);
+
+		return result;
 	}
 #endif // VCFG_BUFFER_ONLY
 
@@ -677,20 +1089,22 @@ extern "C" {
 	 *	Clears the entire key by freeing the allocated memory and recursively calling
 	 *	itself for all the nested child keys
 	 */
-	inline void vcfginternal_clear_key(VCFGKey_t key) {
-		free((void*)(key.name));
-		key.name = 0;
+	inline void vcfginternal_clear_key(VCFG_Parser* parserObj, VCFGKey_t key) {
+		if (key.name) {
+			vcfginternal_free(parserObj, (void*)(key.name), vcfginternal_strlen(key.name) + 1);
+			key.name = 0;
+		}
 
 		if (key.value) {
-			free((void*)(key.value));
+			vcfginternal_free(parserObj, (void*)(key.value), vcfginternal_strlen(key.value) + 1);
 			key.value = 0;
 		}
 
 		if (key.childCount) {
 			for (uint32_t i = 0; i < key.childCount; i++) {
-				vcfginternal_clear_key(key.children[i]);
+				vcfginternal_clear_key(parserObj, key.children[i]);
 			}
-			free((void*)(key.children));
+			vcfginternal_free(parserObj, (void*)(key.children), vcfginternal_array_capacity(key.childCount) * sizeof(VCFGKey_t));
 			key.children = 0;
 
 			key.childCount = 0;
@@ -702,17 +1116,17 @@ extern "C" {
 	 *
 	 *	Clears the entire section by clearing all the keys and freeing the allocated memory
 	 */
-	inline void vcfginternal_clear_section(VCFGSection_t section) {
+	inline void vcfginternal_clear_section(VCFG_Parser* parserObj, VCFGSection_t section) {
 		if (section.name) {
-			free((void*)(section.name));
+			vcfginternal_free(parserObj, (void*)(section.name), vcfginternal_strlen(section.name) + 1);
 			section.name = 0;
 		}
 
 		if (section.keyCount) {
 			for (uint32_t i = 0; i < section.keyCount; i++) {
-				vcfginternal_clear_key(section.keys[i]);
+				vcfginternal_clear_key(parserObj, section.keys[i]);
 			}
-			free(section.keys);
+			vcfginternal_free(parserObj, (void*)(section.keys), vcfginternal_array_capacity(section.keyCount) * sizeof(VCFGKey_t));
 			section.keys = 0;
 			section.keyCount = 0;
 		}
@@ -726,16 +1140,23 @@ extern "C" {
 	 */
 	inline void vcfg_clear(VCFG_Parser* parserObj) {
 		if (parserObj->m_configBuffer) {
-			free((void*)(parserObj->m_configBuffer));
+			VCFG_FREE((void*)(parserObj->m_configBuffer));
 			parserObj->m_configBuffer = 0;
 		}
 
+		vcfginternal_clear_errors(parserObj);
+		vcfginternal_free_index(parserObj);
+		vcfginternal_free_section_tree(parserObj);
+	#if defined(VCFG_ENABLE_LOSSLESS)
+		vcfginternal_clear_removals(parserObj);
+	#endif
+
 		if (parserObj->m_sectionCount) {
 			for (uint32_t i = 0; i < parserObj->m_sectionCount; i++) {
-				vcfginternal_clear_section(parserObj->m_parsedData[i]);
+				vcfginternal_clear_section(parserObj, parserObj->m_parsedData[i]);
 			}
 
-			free((void*)(parserObj->m_parsedData));
+			vcfginternal_free(parserObj, (void*)(parserObj->m_parsedData), vcfginternal_array_capacity(parserObj->m_sectionCount) * sizeof(VCFGSection_t));
 			parserObj->m_parsedData = 0;
 
 			parserObj->m_sectionCount = 0;
@@ -765,6 +1186,8 @@ extern "C" {
 	 *	@returns (VCFGSection_t*) section pointer
 	 */
 	inline VCFGSection_t* vcfg_get_section(VCFG_Parser* parserObj, const char* sectionName) {
+		if (parserObj->m_index) return vcfginternal_index_find_section(parserObj, sectionName);
+
 		for (uint32_t i = 0; i < parserObj->m_sectionCount; i++) {
 			if (vcfginternal_strcmp(sectionName, parserObj->m_parsedData[i].name) == 0) {
 				return &(parserObj->m_parsedData[i]);
@@ -773,6 +1196,124 @@ extern "C" {
 		return 0;
 	}
 
+	/**
+	 *	@brief Find key in section or in the sections it inherits from.
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key
+	 *
+	 *	@returns (VCFGKey_t*) the key or NULL if the section or the key doesn't exist
+	 */
+	inline VCFGKey_t* vcfginternal_find_section_key(VCFG_Parser* parserObj, const char* sectionName, const char* keyName) {
+		VCFGKey_t* key = 0;
+		if (parserObj->m_index) {
+			key = vcfginternal_index_find_key(parserObj, sectionName, keyName);
+
+			// The parents are the first sections of their names, so their keys are indexed
+			const VCFGSection_t* section = key ? 0 : vcfginternal_index_find_section(parserObj, sectionName);
+			while (!key && section && section->parent) {
+				section = &(parserObj->m_parsedData[section->parent]);
+				key = vcfginternal_index_find_key(parserObj, section->name, keyName);
+			}
+		}
+		else {
+			VCFGSection_t* section = vcfg_get_section(parserObj, sectionName);
+			while (section) {
+				for (uint32_t i = 0; (i < section->keyCount) && !key; i++) {
+					if (vcfginternal_strcmp(section->keys[i].name, keyName) == 0) key = &(section->keys[i]);
+				}
+				section = (!key && section->parent) ? &(parserObj->m_parsedData[section->parent]) : 0;
+			}
+		}
+		return key;
+	}
+
+	/**
+	 *	@brief Find key in the dotted parents of a section.
+	 *
+	 *	@param key - set to the key when it's found
+	 *
+	 *	@returns (VCFGSection_t*) the nearest parent that has the key or NULL if none of them has it
+	 */
+	inline VCFGSection_t* vcfginternal_find_in_parent_sections(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, VCFGKey_t** key) {
+		for (size_t length = vcfginternal_strlen(sectionName); length; ) {
+			while (length && (sectionName[--length] != '.'));
+			VCFGSection_t* section = length ? vcfginternal_find_section_path(parserObj, sectionName, length) : 0;
+			if (section && (*key = vcfginternal_find_section_key(parserObj, section->name, keyName))) return section;
+		}
+		return 0;
+	}
+
+	/**
+	 *	@brief Get the nearest section that has a key.
+	 *
+	 *	Looks up the key in the section and then in its dotted parents, nearest first
+	 *	([db.primary.pool], [db.primary], [db]). The parents don't have to exist and the keys they inherit count as theirs.
+	 *	The parents are found through the section tree when it's built (see vcfg_build_section_tree)
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section, which has no parents)
+	 *	@param keyName - name of the key
+	 *
+	 *	@returns (VCFGSection_t*) the section or NULL if none of them has the key
+	 */
+	inline VCFGSection_t* vcfg_get_nearest_section(VCFG_Parser* parserObj, const char* sectionName, const char* keyName) {
+		if (!parserObj || !keyName) return 0;
+		if (vcfginternal_find_section_key(parserObj, sectionName, keyName)) return vcfg_get_section(parserObj, sectionName);
+
+		VCFGKey_t* key = 0;
+		return sectionName ? vcfginternal_find_in_parent_sections(parserObj, sectionName, keyName, &key) : 0;
+	}
+
+	/**
+	 *	@brief Find key in section.
+	 *
+	 *	All the getters that look up a key in a section go through this function.
+	 *	A key the section doesn't have is looked up in the sections it inherits from, nearest first.
+	 *	With VCFG_OPTION_NESTED_SECTIONS a key of [db.primary.pool] is then looked up in [db.primary] and [db]
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key
+	 *
+	 *	@returns (VCFGKey_t*) the key or NULL if the section or the key doesn't exist
+	 */
+	inline VCFGKey_t* vcfginternal_find_key(VCFG_Parser* parserObj, const char* sectionName, const char* keyName) {
+		VCFGKey_t* key = vcfginternal_find_section_key(parserObj, sectionName, keyName);
+		if (!key && sectionName && (parserObj->m_options & VCFG_OPTION_NESTED_SECTIONS)) vcfginternal_find_in_parent_sections(parserObj, sectionName, keyName, &key);
+
+		if (key) {
+			VCFG_PROFILE_HIT(parserObj, key);
+			return key;
+		}
+
+		VCFG_PROFILE_MISS(parserObj, sectionName, keyName);
+		return 0;
+	}
+
+	/**
+	 *	@brief Find key in node.
+	 *
+	 *	All the getters that look up a key in a parent node go through this function
+	 *
+	 *	@param parentNode - node of the element to search in (NULL for the root section)
+	 *	@param keyName - name of the key
+	 *
+	 *	@returns (VCFGKey_t*) the key or NULL if the key doesn't exist
+	 */
+	inline VCFGKey_t* vcfginternal_find_child(VCFG_Parser* parserObj, const VCFG_Node* parentNode, const char* keyName) {
+		// If there's no parent use the root section as parent
+		if (!parentNode) return vcfginternal_find_key(parserObj, 0, keyName);
+
+		for (uint32_t i = 0; i < parentNode->childCount; i++) {
+			if (vcfginternal_strcmp(parentNode->children[i].name, keyName) == 0) {
+				VCFG_PROFILE_HIT(parserObj, &(parentNode->children[i]));
+				return &(parentNode->children[i]);
+			}
+		}
+
+		VCFG_PROFILE_MISS(parserObj, parentNode->name, keyName);
+		return 0;
+	}
+
 	/**
 	 *	@brief Get string value from key.
 	 *
@@ -784,14 +1325,8 @@ extern "C" {
 	 *	@returns (const char*) value of the given key
 	 */
 	inline const char* vcfg_get_string(VCFG_Parser* parserObj, const char* sectionName, const char* keyName) {
-		VCFGSection_t* section = vcfg_get_section(parserObj, sectionName);
-
-		for (uint32_t i = 0; i < section->keyCount; i++) {
-			if (vcfginternal_strcmp(section->keys[i].name, keyName) == 0) {
-				return section->keys[i].value;
-			}
-		}
-		return 0;
+		const VCFGKey_t* key = vcfginternal_find_key(parserObj, sectionName, keyName);
+		return (key ? key->value : 0);
 	}
 
 	/**
@@ -806,7 +1341,11 @@ extern "C" {
 	 */
 	inline int64_t vcfg_get_int(VCFG_Parser* parserObj, const char* sectionName, const char* keyName) {
 		const char* stringValue = vcfg_get_string(parserObj, sectionName, keyName);
-		return vcfginternal_strtoint(stringValue);
+
+		VCFG_TIMER_START(timer);
+		int64_t result = vcfginternal_strtoint(stringValue);
+		VCFG_TIMER_STOP(parserObj, VCFG_PHASE_NUMCONV, timer);
+		return result;
 	}
 
 	/**
@@ -821,13 +1360,18 @@ extern "C" {
 	 */
 	inline double vcfg_get_float(VCFG_Parser* parserObj, const char* sectionName, const char* keyName) {
 		const char* stringValue = vcfg_get_string(parserObj, sectionName, keyName);
-		return vcfginternal_strtofloat(stringValue);
+
+		VCFG_TIMER_START(timer);
+		double result = vcfginternal_strtofloat(stringValue);
+		VCFG_TIMER_STOP(parserObj, VCFG_PHASE_NUMCONV, timer);
+		return result;
 	}
 
 	/**
-	 *	@brief Get boolean value (true|false) from key.
+	 *	@brief Get boolean value (true|yes|on|1, false|no|off|0 in any case) from key.
 	 *
-	 *	Returns the value associated with the given key in the desired section
+	 *	Returns the value associated with the given key in the desired section. The value was classified
+	 *	while parsing, so only its type tag is read (see vcfg_try_get_bool to tell a missing key or an invalid literal from false)
 	 *
 	 *	@param sectionName - name of the section (NULL for the root section)
 	 *	@param keyName - name of the key holding the desired value
@@ -835,8 +1379,9 @@ extern "C" {
 	 *	@returns (int [1-true; 0-false]) value of the given key
 	 */
 	inline int vcfg_get_bool(VCFG_Parser* parserObj, const char* sectionName, const char* keyName) {
-		const char* stringValue = vcfg_get_string(parserObj, sectionName, keyName);
-		return (vcfginternal_strcmp(stringValue, "true") == 0 ? 1 : 0);
+		int value = 0;
+		vcfg_try_get_bool(parserObj, sectionName, keyName, &value);
+		return value;
 	}
 
 	/**
@@ -850,14 +1395,7 @@ extern "C" {
 	 *	@returns (const VCFG_Node*) entire node of the given key
 	 */
 	inline const VCFG_Node* vcfg_get_node(VCFG_Parser* parserObj, const char* sectionName, const char* keyName) {
-		VCFGSection_t* section = vcfg_get_section(parserObj, sectionName);
-
-		for (uint32_t i = 0; i < section->keyCount; i++) {
-			if (vcfginternal_strcmp(section->keys[i].name, keyName) == 0) {
-				return &(section->keys[i]);
-			}
-		}
-		return 0;
+		return vcfginternal_find_key(parserObj, sectionName, keyName);
 	}
 
 	/**
@@ -871,15 +1409,7 @@ extern "C" {
 	 *	@returns (const VCFG_Node*) entire node of the given key
 	 */
 	inline const VCFG_Node* vcfg_get_node_from_node(VCFG_Parser* parserObj, const VCFG_Node* parentNode, const char* keyName) {
-		// If there's no parent use the root section as parent
-		if (!parentNode) return vcfg_get_node(parserObj, 0, keyName);
-
-		for (uint32_t i = 0; i < parentNode->childCount; i++) {
-			if (vcfginternal_strcmp(parentNode->children[i].name, keyName) == 0) {
-				return &(parentNode->children[i]);
-			}
-		}
-		return 0;
+		return vcfginternal_find_child(parserObj, parentNode, keyName);
 	}
 
 	/**
@@ -893,15 +1423,8 @@ extern "C" {
 	 *	@returns (const char*) value of the given key
 	 */
 	inline const char* vcfg_get_string_from_node(VCFG_Parser* parserObj, const VCFG_Node* parentNode, const char* keyName) {
-		// If there's no parent use the root section as parent
-		if (!parentNode) return vcfg_get_string(parserObj, 0, keyName);
-
-		for (uint32_t i = 0; i < parentNode->childCount; i++) {
-			if (vcfginternal_strcmp(parentNode->children[i].name, keyName) == 0) {
-				return parentNode->children[i].value;
-			}
-		}
-		return 0;
+		const VCFGKey_t* key = vcfginternal_find_child(parserObj, parentNode, keyName);
+		return (key ? key->value : 0);
 	}
 
 	/**
@@ -919,7 +1442,11 @@ extern "C" {
 		if (!parentNode) return vcfg_get_int(parserObj, 0, keyName);
 
 		const char* stringValue = vcfg_get_string_from_node(parserObj, parentNode, keyName);
-		return vcfginternal_strtoint(stringValue);
+
+		VCFG_TIMER_START(timer);
+		int64_t result = vcfginternal_strtoint(stringValue);
+		VCFG_TIMER_STOP(parserObj, VCFG_PHASE_NUMCONV, timer);
+		return result;
 	}
 
 	/**
@@ -937,11 +1464,15 @@ extern "C" {
 		if (!parentNode) return vcfg_get_float(parserObj, 0, keyName);
 
 		const char* stringValue = vcfg_get_string_from_node(parserObj, parentNode, keyName);
-		return vcfginternal_strtofloat(stringValue);
+
+		VCFG_TIMER_START(timer);
+		double result = vcfginternal_strtofloat(stringValue);
+		VCFG_TIMER_STOP(parserObj, VCFG_PHASE_NUMCONV, timer);
+		return result;
 	}
 
 	/**
-	 *	@brief Get boolean value (true|false) from key inside the given node.
+	 *	@brief Get boolean value (true|yes|on|1, false|no|off|0 in any case) from key inside the given node.
 	 *
 	 *	Returns the value associated with the given key in the desired node
 	 *
@@ -954,8 +1485,255 @@ extern "C" {
 		// If there's no parent use the root section as parent
 		if (!parentNode) return vcfg_get_bool(parserObj, 0, keyName);
 
-		const char* stringValue = vcfg_get_string_from_node(parserObj, parentNode, keyName);
-		return (vcfginternal_strcmp(stringValue, "true") == 0 ? 1 : 0);
+		int value = 0;
+		vcfg_try_get_bool_from_node(parserObj, parentNode, keyName, &value);
+		return value;
+	}
+
+	/****************************************************/
+	/*				Status returning getters			*/
+	/****************************************************/
+
+	/**
+	 *	@brief Read the string value of a found key.
+	 */
+	inline VCFGStatus vcfginternal_key_to_string(const VCFGKey_t* key, const char** value) {
+		if (!key) return VCFG_STATUS_NOT_FOUND;
+
+		// An empty quoted value ("") isn't stored
+		*value = key->value ? key->value : "";
+		return VCFG_STATUS_OK;
+	}
+
+	/**
+	 *	@brief Convert the value of a found key to an integer.
+	 */
+	inline VCFGStatus vcfginternal_key_to_int(VCFG_Parser* parserObj, const VCFGKey_t* key, int64_t* value) {
+		if (!key) return VCFG_STATUS_NOT_FOUND;
+		if (!(key->value)) return VCFG_STATUS_INVALID_FORMAT;
+
+		VCFG_TIMER_START(timer);
+		VCFGStatus status = vcfginternal_parseint(key->value, value);
+		VCFG_TIMER_STOP(parserObj, VCFG_PHASE_NUMCONV, timer);
+		(void)parserObj;
+		return status;
+	}
+
+	/**
+	 *	@brief Convert the value of a found key to a floating point number.
+	 */
+	inline VCFGStatus vcfginternal_key_to_float(VCFG_Parser* parserObj, const VCFGKey_t* key, double* value) {
+		if (!key) return VCFG_STATUS_NOT_FOUND;
+		if (!(key->value)) return VCFG_STATUS_INVALID_FORMAT;
+
+		VCFG_TIMER_START(timer);
+		VCFGStatus status = vcfginternal_parsefloat(key->value, value);
+		VCFG_TIMER_STOP(parserObj, VCFG_PHASE_NUMCONV, timer);
+		(void)parserObj;
+		return status;
+	}
+
+	/**
+	 *	@brief Convert the value of a found key to a boolean.
+	 */
+	inline VCFGStatus vcfginternal_key_to_bool(const VCFGKey_t* key, int* value) {
+		if (!key) return VCFG_STATUS_NOT_FOUND;
+
+		uint32_t tag = key->typeTag ? key->typeTag : vcfginternal_classify_bool(key->value);
+		if (tag == VCFG_TAG_OTHER) return VCFG_STATUS_INVALID_FORMAT;
+		*value = (tag == VCFG_TAG_TRUE);
+		return VCFG_STATUS_OK;
+	}
+
+	/**
+	 *	@brief Try to get string value from key.
+	 *
+	 *	Looks the key up only once and tells a missing key apart from an empty value
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key holding the desired value
+	 *	@param value - receives the value (only on success, "" for an empty value)
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK or VCFG_STATUS_NOT_FOUND
+	 */
+	inline VCFGStatus vcfg_try_get_string(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, const char** value) {
+		return vcfginternal_key_to_string(vcfginternal_find_key(parserObj, sectionName, keyName), value);
+	}
+
+	/**
+	 *	@brief Try to get integer value from key.
+	 *
+	 *	Looks the key up only once. The whole value has to be a number that fits in 64 bits,
+	 *	so a missing key, an invalid value and a legitimate -1 can be told apart
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key holding the desired value
+	 *	@param value - receives the value (only on success)
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK, VCFG_STATUS_NOT_FOUND, VCFG_STATUS_INVALID_FORMAT or VCFG_STATUS_OUT_OF_RANGE
+	 */
+	inline VCFGStatus vcfg_try_get_int(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, int64_t* value) {
+		return vcfginternal_key_to_int(parserObj, vcfginternal_find_key(parserObj, sectionName, keyName), value);
+	}
+
+	/**
+	 *	@brief Try to get floating point value from key.
+	 *
+	 *	Looks the key up only once. The whole value has to be a number
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key holding the desired value
+	 *	@param value - receives the value (only on success)
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK, VCFG_STATUS_NOT_FOUND, VCFG_STATUS_INVALID_FORMAT or VCFG_STATUS_OUT_OF_RANGE
+	 */
+	inline VCFGStatus vcfg_try_get_float(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, double* value) {
+		return vcfginternal_key_to_float(parserObj, vcfginternal_find_key(parserObj, sectionName, keyName), value);
+	}
+
+	/**
+	 *	@brief Try to get boolean value (true|yes|on|1, false|no|off|0 in any case) from key.
+	 *
+	 *	Looks the key up only once, so a missing key and false can be told apart
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key holding the desired value
+	 *	@param value - receives 1 for true and 0 for false (only on success)
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK, VCFG_STATUS_NOT_FOUND or VCFG_STATUS_INVALID_FORMAT
+	 */
+	inline VCFGStatus vcfg_try_get_bool(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, int* value) {
+		return vcfginternal_key_to_bool(vcfginternal_find_key(parserObj, sectionName, keyName), value);
+	}
+
+	/**
+	 *	@brief Try to get string value from key inside the given node.
+	 *
+	 *	@param parentNode - node of the element to search in (NULL for the root section)
+	 *	@param keyName - name of the key holding the desired value
+	 *	@param value - receives the value (only on success, "" for an empty value)
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK or VCFG_STATUS_NOT_FOUND
+	 */
+	inline VCFGStatus vcfg_try_get_string_from_node(VCFG_Parser* parserObj, const VCFG_Node* parentNode, const char* keyName, const char** value) {
+		return vcfginternal_key_to_string(vcfginternal_find_child(parserObj, parentNode, keyName), value);
+	}
+
+	/**
+	 *	@brief Try to get integer value from key inside the given node.
+	 *
+	 *	@param parentNode - node of the element to search in (NULL for the root section)
+	 *	@param keyName - name of the key holding the desired value
+	 *	@param value - receives the value (only on success)
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK, VCFG_STATUS_NOT_FOUND, VCFG_STATUS_INVALID_FORMAT or VCFG_STATUS_OUT_OF_RANGE
+	 */
+	inline VCFGStatus vcfg_try_get_int_from_node(VCFG_Parser* parserObj, const VCFG_Node* parentNode, const char* keyName, int64_t* value) {
+		return vcfginternal_key_to_int(parserObj, vcfginternal_find_child(parserObj, parentNode, keyName), value);
+	}
+
+	/**
+	 *	@brief Try to get floating point value from key inside the given node.
+	 *
+	 *	@param parentNode - node of the element to search in (NULL for the root section)
+	 *	@param keyName - name of the key holding the desired value
+	 *	@param value - receives the value (only on success)
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK, VCFG_STATUS_NOT_FOUND, VCFG_STATUS_INVALID_FORMAT or VCFG_STATUS_OUT_OF_RANGE
+	 */
+	inline VCFGStatus vcfg_try_get_float_from_node(VCFG_Parser* parserObj, const VCFG_Node* parentNode, const char* keyName, double* value) {
+		return vcfginternal_key_to_float(parserObj, vcfginternal_find_child(parserObj, parentNode, keyName), value);
+	}
+
+	/**
+	 *	@brief Try to get boolean value (true|yes|on|1, false|no|off|0 in any case) from key inside the given node.
+	 *
+	 *	@param parentNode - node of the element to search in (NULL for the root section)
+	 *	@param keyName - name of the key holding the desired value
+	 *	@param value - receives 1 for true and 0 for false (only on success)
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK, VCFG_STATUS_NOT_FOUND or VCFG_STATUS_INVALID_FORMAT
+	 */
+	inline VCFGStatus vcfg_try_get_bool_from_node(VCFG_Parser* parserObj, const VCFG_Node* parentNode, const char* keyName, int* value) {
+		return vcfginternal_key_to_bool(vcfginternal_find_child(parserObj, parentNode, keyName), value);
+	}
+
+	/**
+	 *	@brief Convert the value of a found key to nanoseconds or bytes.
+	 *
+	 *	@param kind - VCFG_UNIT_DURATION or VCFG_UNIT_SIZE
+	 */
+	inline VCFGStatus vcfginternal_key_to_quantity(VCFG_Parser* parserObj, const VCFGKey_t* key, uint32_t kind, int64_t* value) {
+		if (!key) return VCFG_STATUS_NOT_FOUND;
+		if (!(key->value)) return VCFG_STATUS_INVALID_FORMAT;
+
+		VCFG_TIMER_START(timer);
+		VCFGStatus status = vcfginternal_key_quantity(key, kind, value);
+		VCFG_TIMER_STOP(parserObj, VCFG_PHASE_NUMCONV, timer);
+		(void)parserObj;
+		return status;
+	}
+
+	/**
+	 *	@brief Try to get duration from key.
+	 *
+	 *	Looks the key up only once. The value has to be a number with a duration unit (250ms, 1.5s) or a whole number
+	 *	of nanoseconds. With VCFG_OPTION_UNITS it was converted while parsing, so the nanoseconds are only loaded
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key holding the desired value
+	 *	@param value - receives the duration in nanoseconds (only on success)
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK, VCFG_STATUS_NOT_FOUND, VCFG_STATUS_INVALID_FORMAT or VCFG_STATUS_OUT_OF_RANGE
+	 */
+	inline VCFGStatus vcfg_try_get_duration_ns(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, int64_t* value) {
+		return vcfginternal_key_to_quantity(parserObj, vcfginternal_find_key(parserObj, sectionName, keyName), VCFG_UNIT_DURATION, value);
+	}
+
+	/**
+	 *	@brief Try to get size from key.
+	 *
+	 *	Looks the key up only once. The value has to be a number with a size unit (64KiB, 1.5MB) or a whole number
+	 *	of bytes. With VCFG_OPTION_UNITS it was converted while parsing, so the bytes are only loaded
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key holding the desired value
+	 *	@param value - receives the size in bytes (only on success)
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK, VCFG_STATUS_NOT_FOUND, VCFG_STATUS_INVALID_FORMAT or VCFG_STATUS_OUT_OF_RANGE
+	 */
+	inline VCFGStatus vcfg_try_get_bytes(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, int64_t* value) {
+		return vcfginternal_key_to_quantity(parserObj, vcfginternal_find_key(parserObj, sectionName, keyName), VCFG_UNIT_SIZE, value);
+	}
+
+	/**
+	 *	@brief Get duration from key.
+	 *
+	 *	Returns the value associated with the given key in the desired section in nanoseconds (see vcfg_try_get_duration_ns)
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key holding the desired value
+	 *
+	 *	@returns (int64_t) the duration in nanoseconds or -1 if the key doesn't exist or isn't a duration
+	 */
+	inline int64_t vcfg_get_duration_ns(VCFG_Parser* parserObj, const char* sectionName, const char* keyName) {
+		int64_t value = -1;
+		return (vcfg_try_get_duration_ns(parserObj, sectionName, keyName, &value) == VCFG_STATUS_OK) ? value : -1;
+	}
+
+	/**
+	 *	@brief Get size from key.
+	 *
+	 *	Returns the value associated with the given key in the desired section in bytes (see vcfg_try_get_bytes)
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key holding the desired value
+	 *
+	 *	@returns (int64_t) the size in bytes or -1 if the key doesn't exist or isn't a size
+	 */
+	inline int64_t vcfg_get_bytes(VCFG_Parser* parserObj, const char* sectionName, const char* keyName) {
+		int64_t value = -1;
+		return (vcfg_try_get_bytes(parserObj, sectionName, keyName, &value) == VCFG_STATUS_OK) ? value : -1;
 	}
 
 #ifdef __cplusplus
@@ -0,0 +1,259 @@
+﻿/*
+ * index.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef VCFG_INDEX_H
+#define VCFG_INDEX_H 1
+
+#include "parser.h"
+#include "macros.h"
+#include "hash.h"
+#include "memory.h"
+#include "compatibility.h"
+
+// The hash index maps the path hash of every section and of every key of a section to its position
+// in the parsed data, so that vcfg_get_section and the getters find them with a single probe instead of
+// comparing the names one by one. It's an open addressing table with linear probing that is never more than
+// half full. Only the first of the sections or keys with the same name is indexed (the one the linear
+// lookup would find). The keys nested in arrays and objects are still searched linearly.
+// The mutation functions keep the index up to date, vcfg_optimize_layout and vcfg_restore_source_order rebuild it
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+	#include <stdint.h>
+
+	// Key position of the entries that index a section
+	#define VCFG_INDEX_SECTION 0xFFFFFFFFu
+	#define VCFG_INDEX_MIN_CAPACITY 16
+
+	/**
+	 *	@brief Get the first slot to probe for a hash.
+	 */
+	inline uint32_t vcfginternal_index_home(uint64_t hash, uint32_t capacity) {
+		return (uint32_t)(hash ^ (hash >> 32)) & (capacity - 1);
+	}
+
+	/**
+	 *	@brief Find an indexed section or key.
+	 *
+	 *	@param hash - path hash of the section or key
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key (ignored for sections)
+	 *	@param isSection - 1 to find the section itself, 0 to find its key
+	 *
+	 *	@returns (VCFGIndexEntry_t*) the matching entry or the empty slot where it would be
+	 */
+	inline VCFGIndexEntry_t* vcfginternal_index_probe(VCFG_Parser* parserObj, uint64_t hash, const char* sectionName, const char* keyName, int isSection) {
+		uint32_t mask = parserObj->m_indexCapacity - 1;
+		for (uint32_t i = vcfginternal_index_home(hash, parserObj->m_indexCapacity); ; i = (i + 1) & mask) {
+			VCFGIndexEntry_t* entry = &(parserObj->m_index[i]);
+			if (!(entry->hash)) return entry;
+			if ((entry->hash != hash) || ((entry->key == VCFG_INDEX_SECTION) != isSection)) continue;
+
+			const VCFGSection_t* section = &(parserObj->m_parsedData[entry->section]);
+			if (vcfginternal_strcmp(section->name, sectionName) != 0) continue;
+			if (isSection || (vcfginternal_strcmp(section->keys[entry->key].name, keyName) == 0)) return entry;
+		}
+	}
+
+	/**
+	 *	@brief Add a section or a key that isn't indexed yet to a table with a free slot.
+	 *
+	 *	@returns (int) 1 - added, 0 - an earlier one with the same name is indexed already
+	 */
+	inline int vcfginternal_index_place(VCFG_Parser* parserObj, uint32_t sectionIndex, uint32_t keyIndex) {
+		const VCFGSection_t* section = &(parserObj->m_parsedData[sectionIndex]);
+		uint64_t hash = vcfginternal_hash_append(VCFG_HASH_SEED, section->name);
+		const char* keyName = 0;
+		if (keyIndex != VCFG_INDEX_SECTION) {
+			keyName = section->keys[keyIndex].name;
+			hash = vcfginternal_hash_append(hash, keyName);
+		}
+
+		VCFGIndexEntry_t* entry = vcfginternal_index_probe(parserObj, hash, section->name, keyName, keyIndex == VCFG_INDEX_SECTION);
+		if (entry->hash) return 0;
+
+		entry->hash = hash;
+		entry->section = sectionIndex;
+		entry->key = keyIndex;
+		++(parserObj->m_indexCount);
+		return 1;
+	}
+
+	/**
+	 *	@brief Free the index.
+	 *
+	 *	The lookups go back to comparing the names
+	 */
+	inline void vcfginternal_free_index(VCFG_Parser* parserObj) {
+		vcfginternal_free(parserObj, (void*)(parserObj->m_index), parserObj->m_indexCapacity * sizeof(VCFGIndexEntry_t));
+		parserObj->m_index = 0;
+		parserObj->m_indexCapacity = 0;
+		parserObj->m_indexCount = 0;
+	}
+
+	/**
+	 *	@brief Index all the sections and keys in a table of the given capacity.
+	 *
+	 *	@returns 0 - Failure (the index is freed), 1 - Success
+	 */
+	inline int vcfginternal_rebuild_index(VCFG_Parser* parserObj, uint32_t capacity) {
+		vcfginternal_free_index(parserObj);
+
+		VCFGIndexEntry_t* index = (VCFGIndexEntry_t*)vcfginternal_calloc(parserObj, capacity, sizeof(VCFGIndexEntry_t));
+		if (!index) return 0;
+		parserObj->m_index = index;
+		parserObj->m_indexCapacity = capacity;
+
+		for (uint32_t i = 0; i < parserObj->m_sectionCount; i++) {
+			// The keys of a repeated section can't be found by name
+			if (!vcfginternal_index_place(parserObj, i, VCFG_INDEX_SECTION)) continue;
+			for (uint32_t k = 0; k < parserObj->m_parsedData[i].keyCount; k++) {
+				vcfginternal_index_place(parserObj, i, k);
+			}
+		}
+		return 1;
+	}
+
+	/**
+	 *	@brief Build the hash index.
+	 *
+	 *	Indexes all the sections and the keys of the sections, so that the lookups take a single probe
+	 *	instead of a comparison per section and key. The index is kept up to date by the mutation functions and
+	 *	freed by vcfg_clear. With VCFG_OPTION_BUILD_INDEX vcfg_parse builds it after parsing
+	 *
+	 *	@returns 0 - Failure (see vcfg_get_last_error), 1 - Success
+	 */
+	inline int vcfg_build_index(VCFG_Parser* parserObj) {
+		if (!parserObj) return 0;
+
+		uint32_t entryCount = parserObj->m_sectionCount;
+		for (uint32_t i = 0; i < parserObj->m_sectionCount; i++) entryCount += parserObj->m_parsedData[i].keyCount;
+
+		uint32_t capacity = VCFG_INDEX_MIN_CAPACITY;
+		while (capacity < 2 * (size_t)entryCount) capacity <<= 1;
+		return vcfginternal_rebuild_index(parserObj, capacity);
+	}
+
+	/**
+	 *	@brief Index a section or key added to the parsed data.
+	 *
+	 *	Doubles the table when it would become more than half full
+	 *
+	 *	@param keyIndex - position of the key in the section (VCFG_INDEX_SECTION for the section itself)
+	 *
+	 *	@returns 0 - Failure (the index is freed), 1 - Success
+	 */
+	inline int vcfginternal_index_add(VCFG_Parser* parserObj, uint32_t sectionIndex, uint32_t keyIndex) {
+		if (!(parserObj->m_index)) return 1;
+		if (2 * ((size_t)(parserObj->m_indexCount) + 1) > parserObj->m_indexCapacity) return vcfginternal_rebuild_index(parserObj, parserObj->m_indexCapacity << 1);
+
+		vcfginternal_index_place(parserObj, sectionIndex, keyIndex);
+		return 1;
+	}
+
+	/**
+	 *	@brief Remove a key from the index before it's removed from its section.
+	 *
+	 *	Closes the gap in the probe sequence and moves the positions of the following keys one down.
+	 *	A key of the same name further in the section (a duplicate) has to take the place of the removed one,
+	 *	the caller indexes it with vcfginternal_index_add once the key is gone. Takes time linear in the number
+	 *	of keys of the section, not of the whole index
+	 *
+	 *	@param keyIndex - position of the key in the section
+	 *
+	 *	@returns (uint32_t) position of the duplicate after the removal or VCFG_INDEX_SECTION when there's none
+	 */
+	inline uint32_t vcfginternal_index_remove(VCFG_Parser* parserObj, uint32_t sectionIndex, uint32_t keyIndex) {
+		if (!(parserObj->m_index)) return VCFG_INDEX_SECTION;
+
+		const VCFGSection_t* section = &(parserObj->m_parsedData[sectionIndex]);
+		const char* keyName = section->keys[keyIndex].name;
+		uint64_t sectionHash = vcfginternal_hash_append(VCFG_HASH_SEED, section->name);
+		uint64_t hash = vcfginternal_hash_append(sectionHash, keyName);
+		uint32_t mask = parserObj->m_indexCapacity - 1;
+
+		// Removing a later duplicate (it isn't indexed) only moves the positions after it
+		uint32_t duplicate = VCFG_INDEX_SECTION;
+		VCFGIndexEntry_t* entry = vcfginternal_index_probe(parserObj, hash, section->name, keyName, 0);
+		if (entry->hash && (entry->key == keyIndex)) {
+			// Backward shift deletion: the entries after the hole that may live in it are moved into it
+			uint32_t hole = (uint32_t)(entry - parserObj->m_index);
+			for (uint32_t i = (hole + 1) & mask; parserObj->m_index[i].hash; i = (i + 1) & mask) {
+				uint32_t home = vcfginternal_index_home(parserObj->m_index[i].hash, parserObj->m_indexCapacity);
+				int staysAfterHole = (hole <= i) ? ((hole < home) && (home <= i)) : ((hole < home) || (home <= i));
+				if (staysAfterHole) continue;
+
+				parserObj->m_index[hole] = parserObj->m_index[i];
+				hole = i;
+			}
+			parserObj->m_index[hole].hash = 0;
+			--(parserObj->m_indexCount);
+
+			for (uint32_t k = keyIndex + 1; (k < section->keyCount) && (duplicate == VCFG_INDEX_SECTION); k++) {
+				if (vcfginternal_strcmp(section->keys[k].name, keyName) == 0) duplicate = k - 1;
+			}
+		}
+
+		// Only the keys after the removed one move, their entries are found by their hashes and positions
+		for (uint32_t k = keyIndex + 1; k < section->keyCount; k++) {
+			uint64_t keyHash = vcfginternal_hash_append(sectionHash, section->keys[k].name);
+			for (uint32_t i = vcfginternal_index_home(keyHash, parserObj->m_indexCapacity); parserObj->m_index[i].hash; i = (i + 1) & mask) {
+				VCFGIndexEntry_t* other = &(parserObj->m_index[i]);
+				if ((other->hash != keyHash) || (other->section != sectionIndex) || (other->key != k)) continue;
+				--(other->key);
+				break;
+			}
+		}
+		return duplicate;
+	}
+
+	/**
+	 *	@brief Find a section through the index.
+	 *
+	 *	@returns (VCFGSection_t*) the section or NULL if it doesn't exist
+	 */
+	inline VCFGSection_t* vcfginternal_index_find_section(VCFG_Parser* parserObj, const char* sectionName) {
+		VCFGIndexEntry_t* entry = vcfginternal_index_probe(parserObj, vcfginternal_hash_append(VCFG_HASH_SEED, sectionName), sectionName, 0, 1);
+		return entry->hash ? &(parserObj->m_parsedData[entry->section]) : 0;
+	}
+
+	/**
+	 *	@brief Find a key of a section through the index.
+	 *
+	 *	@returns (VCFGKey_t*) the key or NULL if the section or the key doesn't exist
+	 */
+	inline VCFGKey_t* vcfginternal_index_find_key(VCFG_Parser* parserObj, const char* sectionName, const char* keyName) {
+		uint64_t hash = vcfginternal_hash_append(vcfginternal_hash_append(VCFG_HASH_SEED, sectionName), keyName);
+		VCFGIndexEntry_t* entry = vcfginternal_index_probe(parserObj, hash, sectionName, keyName, 0);
+		return entry->hash ? &(parserObj->m_parsedData[entry->section].keys[entry->key]) : 0;
+	}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_INDEX_H
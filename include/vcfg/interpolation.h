@@ -0,0 +1,379 @@
+﻿/*
+ * interpolation.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#ifndef VCFG_INTERPOLATION_H
+#define VCFG_INTERPOLATION_H 1
+
+#include "parser.h"
+#include "macros.h"
+#include "memory.h"
+#include "errors.h"
+#include "index.h"
+#include "tree.h"
+#include "implementation.h"
+#include "mutation.h"
+#include "compatibility.h"
+
+// Values can refer to the values of other keys: url = "http://${server.host}:${server.port}/". The references
+// are resolved once after parsing and the result replaces the value, so reading it costs as much as reading any other value.
+// The values with references form a dependency graph that is walked depth-first: a value is resolved after all the values
+// it refers to, every value is resolved only once and a reference back to a value that is still being resolved is a cycle.
+// The path is split at the last dot, ${key} refers to a key of the root section and ${db.primary.port} to port in [db.primary].
+// $${ is written as a literal ${
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+	#include <stdint.h>
+
+	// Resolution state of a value with references
+	#define VCFG_REFERENCE_PENDING 0
+	#define VCFG_REFERENCE_ACTIVE 1		// On the stack of the depth-first walk
+	#define VCFG_REFERENCE_RESOLVED 2
+
+	// The values with references, sorted by the address of their key
+	typedef struct VCFGReferences {
+		VCFGKey_t** keys;
+		uint8_t* states;
+		uint32_t* stack;		// Positions of the values being resolved
+		size_t* offsets;		// Where the next reference of every value on the stack is looked for
+		size_t* firstTarget;	// Where the targets of every value on the stack start
+		VCFGKey_t** targets;	// Keys the references of the values on the stack refer to, in order
+		uint32_t count;
+		uint32_t capacity;
+		size_t referenceCount;	// Upper bound of the number of references in all the values
+		char* path;				// Room for the longest path (copied to split it into the section and key names)
+		size_t pathSize;
+	} VCFGReferences_t;
+
+	/**
+	 *	@brief Find the next reference in a value.
+	 *
+	 *	Skips the escaped references ($${)
+	 *
+	 *	@param offset - where to start looking
+	 *	@param pathEnd - set to the position of the closing } (or of the end of the value when it's missing)
+	 *
+	 *	@returns (size_t) position of the $ of the reference or the length of the value if there's none
+	 */
+	inline size_t vcfginternal_next_reference(const char* value, size_t offset, size_t* pathEnd) {
+		for (size_t i = offset; value[i]; i++) {
+			if (value[i] != '$') continue;
+			if ((value[i + 1] == '$') && (value[i + 2] == '{')) {
+				i += 2;
+				continue;
+			}
+			if (value[i + 1] != '{') continue;
+
+			size_t end = i + 2;
+			while (value[end] && (value[end] != '}')) ++end;
+			*pathEnd = end;
+			return i;
+		}
+		*pathEnd = 0;
+		return offset + vcfginternal_strlen(value + offset);
+	}
+
+	/**
+	 *	@brief Count the references in a value (the escaped ones included).
+	 */
+	inline size_t vcfginternal_count_references(const char* value) {
+		size_t count = 0;
+		for (const char* c = value; c && *c; c++) {
+			if ((c[0] == '$') && (c[1] == '{')) ++count;
+		}
+		return count;
+	}
+
+	/**
+	 *	@brief Add the values with references of keys and all their children.
+	 *
+	 *	@returns 0 - Failure (out of memory), 1 - Success
+	 */
+	inline int vcfginternal_collect_references(VCFGReferences_t* references, VCFGKey_t* keys, uint32_t keyCount) {
+		for (uint32_t i = 0; i < keyCount; i++) {
+			VCFGKey_t* key = &(keys[i]);
+			if (key->childCount) {
+				if (!vcfginternal_collect_references(references, key->children, key->childCount)) return 0;
+				continue;
+			}
+			size_t referenceCount = vcfginternal_count_references(key->value);
+			if (!referenceCount) continue;
+
+			if (references->count == references->capacity) {
+				uint32_t capacity = references->capacity ? references->capacity * 2 : 64;
+				VCFGKey_t** grown = (VCFGKey_t**)VCFG_REALLOC((void*)(references->keys), capacity * sizeof(VCFGKey_t*));
+				if (!grown) return 0;
+				references->keys = grown;
+				references->capacity = capacity;
+			}
+			references->keys[references->count++] = key;
+			references->referenceCount += referenceCount;
+
+			size_t length = vcfginternal_strlen(key->value);
+			if (length + 2 > references->pathSize) references->pathSize = length + 2;
+		}
+		return 1;
+	}
+
+	/**
+	 *	@brief Sort the keys of the values with references by address.
+	 */
+	inline int vcfginternal_compare_key_addresses(const void* first, const void* second) {
+		uintptr_t firstKey = (uintptr_t)(*(VCFGKey_t* const*)first);
+		uintptr_t secondKey = (uintptr_t)(*(VCFGKey_t* const*)second);
+		return (firstKey < secondKey) ? -1 : (firstKey > secondKey);
+	}
+
+	/**
+	 *	@brief Find the position of a key among the values with references.
+	 *
+	 *	@returns (uint32_t) the position or the number of values if the key has no references
+	 */
+	inline uint32_t vcfginternal_find_reference(const VCFGReferences_t* references, const VCFGKey_t* key) {
+		uint32_t low = 0;
+		uint32_t high = references->count;
+		while (low < high) {
+			uint32_t middle = low + (high - low) / 2;
+			if ((uintptr_t)(references->keys[middle]) < (uintptr_t)key) low = middle + 1;
+			else high = middle;
+		}
+		return ((low < references->count) && (references->keys[low] == key)) ? low : references->count;
+	}
+
+	/**
+	 *	@brief Find the key a reference refers to.
+	 *
+	 *	The key is looked up like by the getters (in the sections the section inherits from and, with
+	 *	VCFG_OPTION_NESTED_SECTIONS, in its dotted parents) but without being counted by the profiling
+	 *
+	 *	@param path - the path between ${ and }
+	 *	@param pathLength - length of the path
+	 *
+	 *	@returns (VCFGKey_t*) the key or NULL if it doesn't exist or isn't a plain value
+	 */
+	inline VCFGKey_t* vcfginternal_reference_target(VCFG_Parser* parserObj, const VCFGReferences_t* references, const char* path, size_t pathLength) {
+		if (!pathLength) return 0;
+
+		size_t dot = pathLength;
+		while (dot && (path[dot - 1] != '.')) --dot;
+		if (dot == 1 || dot == pathLength) return 0;
+
+		// "section.key" becomes "section\0key\0", a path without a dot is a key of the root section
+		char* names = references->path;
+		vcfginternal_memcpy((void*)names, (const void*)path, pathLength);
+		names[pathLength] = '\0';
+		const char* sectionName = dot ? names : 0;
+		const char* keyName = names + dot;
+		if (dot) names[dot - 1] = '\0';
+
+		VCFGKey_t* key = vcfginternal_find_section_key(parserObj, sectionName, keyName);
+		if (!key && sectionName && (parserObj->m_options & VCFG_OPTION_NESTED_SECTIONS)) vcfginternal_find_in_parent_sections(parserObj, sectionName, keyName, &key);
+		if (!key || key->childCount || vcfginternal_is_array(key) || vcfginternal_is_object(key)) return 0;
+		return key;
+	}
+
+	/**
+	 *	@brief Write a value with all its references replaced.
+	 *
+	 *	@param targets - the resolved keys the references refer to, in order
+	 *	@param result - where to write the value (NULL to only measure it)
+	 *
+	 *	@returns (size_t) length of the value
+	 */
+	inline size_t vcfginternal_write_references(const char* value, VCFGKey_t* const* targets, char* result) {
+		size_t length = 0;
+		for (size_t i = 0, pathEnd = 0; value[i]; i = pathEnd + 1) {
+			size_t reference = vcfginternal_next_reference(value, i, &pathEnd);
+			for (size_t c = i; c < reference; c++) {
+				// $${ is copied without the first $
+				if ((value[c] == '$') && (value[c + 1] == '$') && (value[c + 2] == '{')) continue;
+				if (result) result[length] = value[c];
+				++length;
+			}
+			if (!value[reference]) break;
+
+			const VCFGKey_t* target = *(targets++);
+			size_t targetLength = target->value ? vcfginternal_strlen(target->value) : 0;
+			if (result && targetLength) vcfginternal_memcpy((void*)(result + length), (const void*)(target->value), targetLength);
+			length += targetLength;
+		}
+		return length;
+	}
+
+	/**
+	 *	@brief Replace a value whose references are all resolved with its result.
+	 *
+	 *	@returns 0 - Failure (see vcfg_get_last_error), 1 - Success
+	 */
+	inline int vcfginternal_substitute_references(VCFG_Parser* parserObj, VCFGKey_t* key, VCFGKey_t* const* targets) {
+		size_t length = vcfginternal_write_references(key->value, targets, 0);
+
+		// An empty result is stored like an empty value set by vcfg_set_string
+		char* result = 0;
+		if (length) {
+			result = (char*)vcfginternal_malloc(parserObj, length + 1);
+			if (!result) {
+				vcfginternal_set_error(parserObj, VCFG_ERROR_OUT_OF_MEMORY);
+				return 0;
+			}
+			vcfginternal_write_references(key->value, targets, result);
+			result[length] = '\0';
+		}
+
+		vcfginternal_free(parserObj, (void*)(key->value), vcfginternal_strlen(key->value) + 1);
+		key->value = result;
+		key->enumCache = 0;
+		key->typeTag = vcfginternal_classify_bool(result);
+		key->quantityTag = VCFG_QUANTITY_UNKNOWN;
+		if (parserObj->m_options & VCFG_OPTION_UNITS) vcfginternal_cache_quantity(key, length);
+		return 1;
+	}
+
+	/**
+	 *	@brief Resolve a value and all the values it depends on.
+	 *
+	 *	Walks the references depth-first with an explicit stack, so long chains of references
+	 *	don't overflow the call stack. Every reference is looked up once, the targets of a value are kept
+	 *	on a stack of their own until it's substituted (its dependencies push and pop theirs above them)
+	 *
+	 *	@returns 0 - Failure (see vcfg_get_last_error), 1 - Success
+	 */
+	inline int vcfginternal_resolve_reference(VCFG_Parser* parserObj, VCFGReferences_t* references, uint32_t first) {
+		uint32_t* stack = references->stack;
+		size_t* offsets = references->offsets;
+		uint32_t depth = 0;
+		size_t targetCount = 0;
+		stack[depth] = first;
+		references->firstTarget[depth] = 0;
+		offsets[depth++] = 0;
+		references->states[first] = VCFG_REFERENCE_ACTIVE;
+
+		while (depth) {
+			uint32_t current = stack[depth - 1];
+			const char* value = references->keys[current]->value;
+
+			size_t pathEnd = 0;
+			size_t reference = vcfginternal_next_reference(value, offsets[depth - 1], &pathEnd);
+			if (!value[reference]) {
+				targetCount = references->firstTarget[depth - 1];
+				if (!vcfginternal_substitute_references(parserObj, references->keys[current], references->targets + targetCount)) return 0;
+				references->states[current] = VCFG_REFERENCE_RESOLVED;
+				--depth;
+				continue;
+			}
+
+			VCFGKey_t* target = value[pathEnd] ? vcfginternal_reference_target(parserObj, references, value + reference + 2, pathEnd - reference - 2) : 0;
+			if (!target) {
+				vcfginternal_set_error(parserObj, VCFG_ERROR_INVALID_REFERENCE);
+				return 0;
+			}
+
+			offsets[depth - 1] = pathEnd + 1;
+			references->targets[targetCount++] = target;
+			// Most targets are plain values, which aren't searched for
+			uint32_t dependency = vcfginternal_count_references(target->value) ? vcfginternal_find_reference(references, target) : references->count;
+			if (dependency == references->count) continue;
+			if (references->states[dependency] == VCFG_REFERENCE_ACTIVE) {
+				vcfginternal_set_error(parserObj, VCFG_ERROR_REFERENCE_CYCLE);
+				return 0;
+			}
+			if (references->states[dependency] == VCFG_REFERENCE_RESOLVED) continue;
+
+			references->states[dependency] = VCFG_REFERENCE_ACTIVE;
+			stack[depth] = dependency;
+			references->firstTarget[depth] = targetCount;
+			offsets[depth++] = 0;
+		}
+		return 1;
+	}
+
+	/**
+	 *	@brief Resolve the references in the values.
+	 *
+	 *	Replaces every ${section.key} in the values of the sections, arrays and objects with the value of the key.
+	 *	Referenced values are resolved first, every value only once. The result becomes the value of the key,
+	 *	so the getters read it like any other value and vcfg_write writes it. With VCFG_ENABLE_LOSSLESS the key isn't
+	 *	marked as changed, VCFG_WRITE_PRESERVE_FORMATTING keeps the references. Uses the hash index (a temporary one
+	 *	when the parser has none). With VCFG_OPTION_INTERPOLATE vcfg_parse resolves the references after parsing.
+	 *	A successful call sets the option, so that vcfg_write escapes the literal ${ left in the values as $${
+	 *
+	 *	@returns 0 - Failure (VCFG_ERROR_INVALID_REFERENCE for a reference to a missing key, an array or an object or without the closing },
+	 *	VCFG_ERROR_REFERENCE_CYCLE for values that refer to each other, see vcfg_get_last_error), 1 - Success
+	 */
+	inline int vcfg_interpolate(VCFG_Parser* parserObj) {
+		if (!parserObj) return 0;
+
+		VCFGReferences_t references = { 0 };
+		int result = 1;
+		for (uint32_t i = 0; (i < parserObj->m_sectionCount) && result; i++) {
+			result = vcfginternal_collect_references(&references, parserObj->m_parsedData[i].keys, parserObj->m_parsedData[i].keyCount);
+		}
+		if (result && !(references.count)) {
+			VCFG_FREE((void*)(references.keys));
+			return 1;
+		}
+
+		// Every value is on the stack at most once
+		if (result) {
+			references.states = (uint8_t*)VCFG_CALLOC(references.count, sizeof(uint8_t));
+			references.stack = (uint32_t*)VCFG_MALLOC(references.count * sizeof(uint32_t));
+			references.offsets = (size_t*)VCFG_MALLOC(references.count * sizeof(size_t));
+			references.firstTarget = (size_t*)VCFG_MALLOC(references.count * sizeof(size_t));
+			references.targets = (VCFGKey_t**)VCFG_MALLOC(references.referenceCount * sizeof(VCFGKey_t*));
+			references.path = (char*)VCFG_MALLOC(references.pathSize);
+			result = references.states && references.stack && references.offsets && references.firstTarget && references.targets && references.path;
+		}
+
+		int temporaryIndex = !(parserObj->m_index);
+		if (result) {
+			qsort(references.keys, references.count, sizeof(VCFGKey_t*), vcfginternal_compare_key_addresses);
+			if (temporaryIndex) vcfg_build_index(parserObj);
+		}
+		if (!result) vcfginternal_set_error(parserObj, VCFG_ERROR_OUT_OF_MEMORY);
+
+		for (uint32_t i = 0; (i < references.count) && result; i++) {
+			if (references.states[i] == VCFG_REFERENCE_PENDING) result = vcfginternal_resolve_reference(parserObj, &references, i);
+		}
+
+		if (temporaryIndex && parserObj->m_index) vcfginternal_free_index(parserObj);
+		VCFG_FREE((void*)(references.keys));
+		VCFG_FREE((void*)(references.states));
+		VCFG_FREE((void*)(references.stack));
+		VCFG_FREE((void*)(references.offsets));
+		VCFG_FREE((void*)(references.firstTarget));
+		VCFG_FREE((void*)(references.targets));
+		VCFG_FREE((void*)(references.path));
+		if (result) parserObj->m_options |= VCFG_OPTION_INTERPOLATE;
+		return result;
+	}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_INTERPOLATION_H
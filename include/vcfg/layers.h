@@ -0,0 +1,330 @@
+﻿/*
+ * layers.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef VCFG_LAYERS_H
+#define VCFG_LAYERS_H 1
+
+#include "parser.h"
+#include "macros.h"
+#include "strconv.h"
+#include "memory.h"
+#include "errors.h"
+#include "layout.h"
+#include "index.h"
+#include "implementation.h"
+#include "mutation.h"
+
+// Layers look up keys in several parsed configurations (e.g. defaults, region and host files) as if they were
+// merged, without copying anything. A key is taken from the highest layer that has it, every layer is searched
+// through its hash index, so a lookup costs at most one probe per layer. Arrays and objects aren't merged,
+// the highest layer that has the key provides all of its elements. vcfg_layers_flatten copies the merged view
+// to a single parser when a lookup should take one probe regardless of the number of layers
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+	#include <stdlib.h>
+
+	/**
+	 *	@brief Add a layer on top of the others.
+	 *
+	 *	The keys of the added layer hide the keys with the same path in the layers added before it.
+	 *	The layer gets a hash index (see vcfg_build_index) when it doesn't have one. Changes made to a layer
+	 *	afterwards are visible through the layers right away
+	 *
+	 *	@param parserObj - a parsed configuration (has to outlive the layers)
+	 *
+	 *	@returns 0 - Failure (VCFG_MAX_LAYERS layers already or out of memory), 1 - Success
+	 */
+	inline int vcfg_layers_push(VCFGLayers_t* layers, VCFG_Parser* parserObj) {
+		if (!layers || !parserObj || (layers->layerCount >= VCFG_MAX_LAYERS)) return 0;
+		if (!(parserObj->m_index) && !vcfg_build_index(parserObj)) return 0;
+
+		layers->layers[layers->layerCount++] = parserObj;
+		return 1;
+	}
+
+	/**
+	 *	@brief Find a key in the highest layer that has it.
+	 *
+	 *	@param owner - set to the layer of the key (can be NULL)
+	 *
+	 *	@returns (VCFGKey_t*) the key or NULL if no layer has it
+	 */
+	inline VCFGKey_t* vcfginternal_layers_find(const VCFGLayers_t* layers, const char* sectionName, const char* keyName, VCFG_Parser** owner) {
+		for (uint32_t i = layers->layerCount; i > 0; i--) {
+			VCFGKey_t* key = vcfginternal_find_key(layers->layers[i - 1], sectionName, keyName);
+			if (!key) continue;
+
+			if (owner) *owner = layers->layers[i - 1];
+			return key;
+		}
+		return 0;
+	}
+
+	/**
+	 *	@brief Get the layer that provides a key.
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key
+	 *
+	 *	@returns (VCFG_Parser*) the highest layer that has the key or NULL if none has it
+	 */
+	inline VCFG_Parser* vcfg_layers_get_owner(const VCFGLayers_t* layers, const char* sectionName, const char* keyName) {
+		VCFG_Parser* owner = 0;
+		vcfginternal_layers_find(layers, sectionName, keyName, &owner);
+		return owner;
+	}
+
+	/**
+	 *	@brief Get key node from the layers.
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key node
+	 *
+	 *	@returns (const VCFG_Node*) node of the key in the highest layer that has it
+	 */
+	inline const VCFG_Node* vcfg_layers_get_node(const VCFGLayers_t* layers, const char* sectionName, const char* keyName) {
+		return vcfginternal_layers_find(layers, sectionName, keyName, 0);
+	}
+
+	/**
+	 *	@brief Get string value from the layers.
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key holding the desired value
+	 *
+	 *	@returns (const char*) value of the key in the highest layer that has it
+	 */
+	inline const char* vcfg_layers_get_string(const VCFGLayers_t* layers, const char* sectionName, const char* keyName) {
+		const VCFGKey_t* key = vcfginternal_layers_find(layers, sectionName, keyName, 0);
+		return (key ? key->value : 0);
+	}
+
+	/**
+	 *	@brief Get integer value from the layers.
+	 *
+	 *	@returns (int64_t) value of the key in the highest layer that has it
+	 */
+	inline int64_t vcfg_layers_get_int(const VCFGLayers_t* layers, const char* sectionName, const char* keyName) {
+		return vcfginternal_strtoint(vcfg_layers_get_string(layers, sectionName, keyName));
+	}
+
+	/**
+	 *	@brief Get floating point value from the layers.
+	 *
+	 *	@returns (double) value of the key in the highest layer that has it
+	 */
+	inline double vcfg_layers_get_float(const VCFGLayers_t* layers, const char* sectionName, const char* keyName) {
+		return vcfginternal_strtofloat(vcfg_layers_get_string(layers, sectionName, keyName));
+	}
+
+	/**
+	 *	@brief Get boolean value (true|yes|on|1, false|no|off|0 in any case) from the layers.
+	 *
+	 *	@returns (int [1-true; 0-false]) value of the key in the highest layer that has it
+	 */
+	inline int vcfg_layers_get_bool(const VCFGLayers_t* layers, const char* sectionName, const char* keyName) {
+		int value = 0;
+		vcfginternal_key_to_bool(vcfginternal_layers_find(layers, sectionName, keyName, 0), &value);
+		return value;
+	}
+
+	/**
+	 *	@brief Try to get string value from the layers.
+	 *
+	 *	Only the highest layer that has the key is used, even when its value can't be converted
+	 *
+	 *	@param value - set to the value on success
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK or the reason of the failure
+	 */
+	inline VCFGStatus vcfg_layers_try_get_string(const VCFGLayers_t* layers, const char* sectionName, const char* keyName, const char** value) {
+		return vcfginternal_key_to_string(vcfginternal_layers_find(layers, sectionName, keyName, 0), value);
+	}
+
+	/**
+	 *	@brief Try to get integer value from the layers.
+	 */
+	inline VCFGStatus vcfg_layers_try_get_int(const VCFGLayers_t* layers, const char* sectionName, const char* keyName, int64_t* value) {
+		VCFG_Parser* owner = 0;
+		const VCFGKey_t* key = vcfginternal_layers_find(layers, sectionName, keyName, &owner);
+		return vcfginternal_key_to_int(owner, key, value);
+	}
+
+	/**
+	 *	@brief Try to get floating point value from the layers.
+	 */
+	inline VCFGStatus vcfg_layers_try_get_float(const VCFGLayers_t* layers, const char* sectionName, const char* keyName, double* value) {
+		VCFG_Parser* owner = 0;
+		const VCFGKey_t* key = vcfginternal_layers_find(layers, sectionName, keyName, &owner);
+		return vcfginternal_key_to_float(owner, key, value);
+	}
+
+	/**
+	 *	@brief Try to get boolean value from the layers.
+	 */
+	inline VCFGStatus vcfg_layers_try_get_bool(const VCFGLayers_t* layers, const char* sectionName, const char* keyName, int* value) {
+		return vcfginternal_key_to_bool(vcfginternal_layers_find(layers, sectionName, keyName, 0), value);
+	}
+
+	/**
+	 *	@brief Copy the children of a key to a key without children.
+	 *
+	 *	The children start empty, so a partial copy is freed with the key
+	 *
+	 *	@returns 0 - Failure, 1 - Success
+	 */
+	inline int vcfginternal_copy_children(VCFG_Parser* parserObj, VCFGKey_t* destination, const VCFGKey_t* source) {
+		if (!(source->childCount)) return 1;
+
+		VCFGKey_t* children = (VCFGKey_t*)vcfginternal_calloc(parserObj, vcfginternal_array_capacity(source->childCount), sizeof(VCFGKey_t));
+		if (!children) return 0;
+		destination->children = children;
+		destination->childCount = source->childCount;
+
+		for (uint32_t i = 0; i < source->childCount; i++) {
+			const VCFGKey_t* child = &(source->children[i]);
+			VCFGKey_t* copy = &(children[i]);
+			copy->sourceIndex = child->sourceIndex;
+
+			if (child->name && !(copy->name = vcfginternal_copy_string(parserObj, child->name, vcfginternal_strlen(child->name)))) return 0;
+			if (child->value && !(copy->value = vcfginternal_copy_string(parserObj, child->value, vcfginternal_strlen(child->value)))) return 0;
+			if (!vcfginternal_copy_children(parserObj, copy, child)) return 0;
+		}
+		return 1;
+	}
+
+	/**
+	 *	@brief Copy a section of a layer to the flattened configuration.
+	 *
+	 *	The keys are copied in the source order, the keys that already exist get the value of the layer
+	 *
+	 *	@param sectionName - name of the section in the flattened configuration
+	 *	@param layer - the layer of the section
+	 *	@param section - the section of the layer (the section itself or a section it inherits from)
+	 *
+	 *	@returns 0 - Failure, 1 - Success
+	 */
+	inline int vcfginternal_flatten_section(VCFG_Parser* parserObj, const char* sectionName, const VCFG_Parser* layer, const VCFGSection_t* section) {
+		if (!vcfg_add_section(parserObj, sectionName)) return 0;
+
+		uint32_t* order = 0;
+		if (section->keyCount > 1) {
+			order = (uint32_t*)VCFG_MALLOC(section->keyCount * sizeof(uint32_t));
+			if (!order) {
+				vcfginternal_set_error(parserObj, VCFG_ERROR_OUT_OF_MEMORY);
+				return 0;
+			}
+			vcfg_get_source_order(section->keys, section->keyCount, order);
+		}
+
+		int result = 1;
+		for (uint32_t i = 0; (i < section->keyCount) && result; i++) {
+			const VCFGKey_t* source = &(section->keys[order ? order[i] : i]);
+
+			// Lookups find only the first of the keys with the same name (the one in the index of the layer)
+			VCFGKey_t* first = layer->m_index ? vcfginternal_index_find_key((VCFG_Parser*)layer, section->name, source->name) : vcfginternal_find_in_keys(section->keys, section->keyCount, source->name);
+			if (first != source) continue;
+
+			VCFGKey_t* key = vcfginternal_section_key(parserObj, sectionName, source->name);
+			result = key && vcfginternal_replace_value(parserObj, key, source->value, source->value ? vcfginternal_strlen(source->value) : 0) && vcfginternal_copy_children(parserObj, key, source);
+		}
+
+		VCFG_FREE(order);
+		return result;
+	}
+
+	/**
+	 *	@brief Copy a section of a layer with the keys it inherits to the flattened configuration.
+	 *
+	 *	The sections it inherits from are copied first, the farthest one first, so that the nearer
+	 *	sections replace their keys like the lookups would
+	 *
+	 *	@returns 0 - Failure, 1 - Success
+	 */
+	inline int vcfginternal_flatten_inherited(VCFG_Parser* parserObj, const VCFG_Parser* layer, const VCFGSection_t* section) {
+		if (!(section->parent)) return vcfginternal_flatten_section(parserObj, section->name, layer, section);
+
+		uint32_t depth = 0;
+		for (const VCFGSection_t* ancestor = section; ancestor->parent; ancestor = &(layer->m_parsedData[ancestor->parent])) ++depth;
+
+		const VCFGSection_t** chain = (const VCFGSection_t**)VCFG_MALLOC((depth + 1) * sizeof(const VCFGSection_t*));
+		if (!chain) {
+			vcfginternal_set_error(parserObj, VCFG_ERROR_OUT_OF_MEMORY);
+			return 0;
+		}
+
+		chain[0] = section;
+		for (uint32_t i = 1; i <= depth; i++) chain[i] = &(layer->m_parsedData[chain[i - 1]->parent]);
+
+		int result = 1;
+		for (uint32_t i = depth + 1; (i > 0) && result; i--) result = vcfginternal_flatten_section(parserObj, section->name, layer, chain[i - 1]);
+
+		VCFG_FREE((void*)chain);
+		return result;
+	}
+
+	/**
+	 *	@brief Flatten the layers to a single configuration.
+	 *
+	 *	Copies every section and key of the layers, from the lowest to the highest one, to an empty parser,
+	 *	so that it holds the values the layers would return. The keys a section inherits ([name : parent]) are copied
+	 *	to the section. The copy is independent of the layers and gets a hash index (see vcfg_build_index) before
+	 *	the first key is copied, so copying takes time linear in the number of keys and a lookup takes one probe
+	 *	regardless of the number of layers. The names and values are allocated one by one like the parsed ones
+	 *	(not from a single block), so the copy can be changed and cleared like any other parser. It costs the memory
+	 *	of all the names and values, keep the layers when the memory matters more than the lookup time
+	 *
+	 *	@param parserObj - an empty parser (cleared or never used)
+	 *
+	 *	@returns 0 - Failure (see vcfg_get_last_error), 1 - Success
+	 */
+	inline int vcfg_layers_flatten(const VCFGLayers_t* layers, VCFG_Parser* parserObj) {
+		if (!layers || !parserObj || parserObj->m_sectionCount) return 0;
+		if (!(parserObj->m_index) && !vcfg_build_index(parserObj)) return 0;
+
+		for (uint32_t i = 0; i < layers->layerCount; i++) {
+			VCFG_Parser* layer = layers->layers[i];
+			for (uint32_t s = 0; s < layer->m_sectionCount; s++) {
+				const VCFGSection_t* section = &(layer->m_parsedData[s]);
+
+				// Like the keys, only the first of the sections with the same name is visible
+				if (vcfg_get_section(layer, section->name) != section) continue;
+				if (!vcfginternal_flatten_inherited(parserObj, layer, section)) return 0;
+			}
+		}
+
+		// A failed index update frees the index
+		if (!(parserObj->m_index) && !vcfg_build_index(parserObj)) return 0;
+		return (parserObj->m_lastError == VCFG_ERROR_NONE) ? 1 : 0;
+	}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_LAYERS_H
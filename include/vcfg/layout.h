@@ -0,0 +1,265 @@
+﻿/*
+ * layout.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef VCFG_LAYOUT_H
+#define VCFG_LAYOUT_H 1
+
+#include "parser.h"
+#include "macros.h"
+#include "hash.h"
+#include "index.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+	#include <stdlib.h>
+
+	// Sort key of a single key while reordering
+	typedef struct VCFGLayoutEntry {
+		uint64_t count;
+		uint32_t sourceIndex;
+		uint32_t position;
+	} VCFGLayoutEntry_t;
+
+	/**
+	 *	@brief Sort the keys from the most to the least accessed, keeping the source order for equal counts.
+	 */
+	inline int vcfginternal_compare_layout_entries(const void* first, const void* second) {
+		const VCFGLayoutEntry_t* firstEntry = (const VCFGLayoutEntry_t*)first;
+		const VCFGLayoutEntry_t* secondEntry = (const VCFGLayoutEntry_t*)second;
+		if (firstEntry->count != secondEntry->count) return (firstEntry->count < secondEntry->count) ? 1 : -1;
+		return (firstEntry->sourceIndex < secondEntry->sourceIndex) ? -1 : (firstEntry->sourceIndex > secondEntry->sourceIndex);
+	}
+
+	/**
+	 *	@brief Find the access count of a key in a profile.
+	 *
+	 *	@param pathHash - hash of the path of the key
+	 *
+	 *	@returns (uint64_t) the number of recorded accesses (0 if the key is not in the profile)
+	 */
+	inline uint64_t vcfginternal_profile_count(const VCFGAccessProfile_t* profile, uint64_t pathHash) {
+		// The entries are sorted by their hash
+		uint32_t low = 0;
+		uint32_t high = profile->entryCount;
+		while (low < high) {
+			uint32_t middle = low + (high - low) / 2;
+			if (profile->entries[middle].pathHash < pathHash) low = middle + 1;
+			else high = middle;
+		}
+
+		if (low < profile->entryCount && profile->entries[low].pathHash == pathHash) return profile->entries[low].count;
+		return 0;
+	}
+
+	/**
+	 *	@brief Reorder an array of keys and recursively all of their children.
+	 *
+	 *	@param keys - the keys to reorder
+	 *	@param keyCount - number of keys
+	 *	@param parentHash - hash of the path of the parent (section or key)
+	 *	@param profile - access counts to sort by (NULL - use the counters of the keys if useCounters is set)
+	 *	@param useCounters - sort by the counters stored in the keys, otherwise restore the source order when there's no profile
+	 *
+	 *	@returns 0 - Failure (out of memory), 1 - Success
+	 */
+	inline int vcfginternal_reorder_keys(VCFGKey_t* keys, uint32_t keyCount, uint64_t parentHash, const VCFGAccessProfile_t* profile, int useCounters) {
+		if (keyCount > 1) {
+			VCFGLayoutEntry_t* entries = (VCFGLayoutEntry_t*)VCFG_MALLOC(keyCount * sizeof(VCFGLayoutEntry_t));
+			VCFGKey_t* reordered = (VCFGKey_t*)VCFG_MALLOC(keyCount * sizeof(VCFGKey_t));
+			if (!entries || !reordered) {
+				VCFG_FREE(entries);
+				VCFG_FREE(reordered);
+				return 0;
+			}
+
+			for (uint32_t i = 0; i < keyCount; i++) {
+				entries[i].count = 0;
+				if (profile) entries[i].count = vcfginternal_profile_count(profile, vcfginternal_hash_append(parentHash, keys[i].name));
+			#if defined(VCFG_ENABLE_PROFILING)
+				else if (useCounters) entries[i].count = keys[i].accessCount;
+			#endif
+				entries[i].sourceIndex = keys[i].sourceIndex;
+				entries[i].position = i;
+			}
+			(void)useCounters;
+
+			qsort(entries, keyCount, sizeof(VCFGLayoutEntry_t), vcfginternal_compare_layout_entries);
+
+			for (uint32_t i = 0; i < keyCount; i++) reordered[i] = keys[entries[i].position];
+			vcfginternal_memcpy((void*)keys, (void*)reordered, keyCount * sizeof(VCFGKey_t));
+
+			VCFG_FREE(entries);
+			VCFG_FREE(reordered);
+		}
+
+		for (uint32_t i = 0; i < keyCount; i++) {
+			if (!keys[i].childCount) continue;
+			if (!vcfginternal_reorder_keys(keys[i].children, keys[i].childCount, vcfginternal_hash_append(parentHash, keys[i].name), profile, useCounters)) return 0;
+		}
+		return 1;
+	}
+
+	/**
+	 *	@brief Optimize the memory layout of the parsed data.
+	 *
+	 *	Reorders the keys of every section and the children of every node from the most to the least
+	 *	frequently accessed one, so that the linear lookups find the hot keys in the first cache lines.
+	 *	The sourceIndex of every key still holds its position in the configuration file.
+	 *	WARNING: all the node pointers obtained before the call are invalidated!
+	 *
+	 *	@param profile - the access counts to use (NULL - use the counters recorded with VCFG_ENABLE_PROFILING)
+	 *
+	 *	@returns 0 - Failure, 1 - Success
+	 */
+	inline int vcfg_optimize_layout(VCFG_Parser* parserObj, const VCFGAccessProfile_t* profile) {
+		int result = 1;
+		for (uint32_t i = 0; (i < parserObj->m_sectionCount) && result; i++) {
+			VCFGSection_t* section = &(parserObj->m_parsedData[i]);
+			result = vcfginternal_reorder_keys(section->keys, section->keyCount, vcfginternal_hash_append(VCFG_HASH_SEED, section->name), profile, 1);
+		}
+
+		// The keys moved, so the positions in the index have to be found again
+		if (parserObj->m_index && !vcfginternal_rebuild_index(parserObj, parserObj->m_indexCapacity)) result = 0;
+		return result;
+	}
+
+	/**
+	 *	@brief Restore the source order of the parsed data.
+	 *
+	 *	Puts all the keys back in the order they appear in the configuration file.
+	 *	WARNING: all the node pointers obtained before the call are invalidated!
+	 *
+	 *	@returns 0 - Failure, 1 - Success
+	 */
+	inline int vcfg_restore_source_order(VCFG_Parser* parserObj) {
+		int result = 1;
+		for (uint32_t i = 0; (i < parserObj->m_sectionCount) && result; i++) {
+			VCFGSection_t* section = &(parserObj->m_parsedData[i]);
+			result = vcfginternal_reorder_keys(section->keys, section->keyCount, VCFG_HASH_SEED, 0, 0);
+		}
+
+		if (parserObj->m_index && !vcfginternal_rebuild_index(parserObj, parserObj->m_indexCapacity)) result = 0;
+		return result;
+	}
+
+	/**
+	 *	@brief Get the source order of keys.
+	 *
+	 *	Fills the order array with the positions of the keys in the order they appear in the
+	 *	configuration file, so that they can be iterated in the source order after vcfg_optimize_layout.
+	 *	Example: for (i = 0; i < section->keyCount; i++) section->keys[order[i]]
+	 *
+	 *	@param keys - section keys or node children
+	 *	@param keyCount - number of keys
+	 *	@param order - array of at least keyCount elements
+	 */
+	inline void vcfg_get_source_order(const VCFGKey_t* keys, uint32_t keyCount, uint32_t* order) {
+		for (uint32_t i = 0; i < keyCount; i++) order[i] = i;
+		for (uint32_t i = 0; i < keyCount; i++) {
+			if (keys[i].sourceIndex < keyCount) order[keys[i].sourceIndex] = i;
+		}
+	}
+
+#if defined(VCFG_ENABLE_PROFILING)
+	/**
+	 *	@brief Add the recorded counters of the keys to the profile entries.
+	 */
+	inline void vcfginternal_capture_key_profile(const VCFGKey_t* keys, uint32_t keyCount, uint64_t parentHash, VCFGAccessProfileEntry_t* entries, uint32_t* entryCount) {
+		for (uint32_t i = 0; i < keyCount; i++) {
+			uint64_t pathHash = vcfginternal_hash_append(parentHash, keys[i].name);
+			if (keys[i].accessCount) {
+				entries[*entryCount].pathHash = pathHash;
+				entries[*entryCount].count = keys[i].accessCount;
+				++(*entryCount);
+			}
+			vcfginternal_capture_key_profile(keys[i].children, keys[i].childCount, pathHash, entries, entryCount);
+		}
+	}
+
+	inline uint32_t vcfginternal_count_keys(const VCFGKey_t* keys, uint32_t keyCount) {
+		uint32_t result = keyCount;
+		for (uint32_t i = 0; i < keyCount; i++) result += vcfginternal_count_keys(keys[i].children, keys[i].childCount);
+		return result;
+	}
+
+	inline int vcfginternal_compare_profile_hashes(const void* first, const void* second) {
+		uint64_t firstHash = ((const VCFGAccessProfileEntry_t*)first)->pathHash;
+		uint64_t secondHash = ((const VCFGAccessProfileEntry_t*)second)->pathHash;
+		return (firstHash < secondHash) ? -1 : (firstHash > secondHash);
+	}
+
+	/**
+	 *	@brief Capture the access profile.
+	 *
+	 *	Stores the access counters of all the keys that were read, so that they can be used to
+	 *	optimize the layout of another parser (e.g. after a reload, or in a build without profiling).
+	 *	The profile has to be freed with vcfg_free_access_profile
+	 *
+	 *	@param profile - the profile to fill
+	 *
+	 *	@returns 0 - Failure, 1 - Success
+	 */
+	inline int vcfg_capture_access_profile(VCFG_Parser* parserObj, VCFGAccessProfile_t* profile) {
+		if (!parserObj || !profile) return 0;
+		profile->entries = 0;
+		profile->entryCount = 0;
+
+		uint32_t keyCount = 0;
+		for (uint32_t i = 0; i < parserObj->m_sectionCount; i++) {
+			keyCount += vcfginternal_count_keys(parserObj->m_parsedData[i].keys, parserObj->m_parsedData[i].keyCount);
+		}
+		if (!keyCount) return 1;
+
+		profile->entries = (VCFGAccessProfileEntry_t*)VCFG_MALLOC(keyCount * sizeof(VCFGAccessProfileEntry_t));
+		if (!(profile->entries)) return 0;
+
+		for (uint32_t i = 0; i < parserObj->m_sectionCount; i++) {
+			const VCFGSection_t* section = &(parserObj->m_parsedData[i]);
+			vcfginternal_capture_key_profile(section->keys, section->keyCount, vcfginternal_hash_append(VCFG_HASH_SEED, section->name), profile->entries, &(profile->entryCount));
+		}
+
+		qsort(profile->entries, profile->entryCount, sizeof(VCFGAccessProfileEntry_t), vcfginternal_compare_profile_hashes);
+		return 1;
+	}
+#endif // VCFG_ENABLE_PROFILING
+
+	/**
+	 *	@brief Free the access profile.
+	 */
+	inline void vcfg_free_access_profile(VCFGAccessProfile_t* profile) {
+		if (!profile) return;
+		VCFG_FREE(profile->entries);
+		profile->entries = 0;
+		profile->entryCount = 0;
+	}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_LAYOUT_H
\ No newline at end of file
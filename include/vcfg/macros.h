@@ -42,4 +42,55 @@
 	#define VCFG_IS_NUMBER(ch) ((ch >= '0') && (ch <= '9'))
 #endif
 
+// Maximum depth of nested arrays and objects. Parsing fails on values nested deeper,
+// so that a malicious configuration can't overflow the stack of the recursive parser
+#ifndef VCFG_MAX_NESTING_DEPTH
+	#define VCFG_MAX_NESTING_DEPTH 128
+#endif
+
+// Size of the chunks vcfg_write passes to the sink. Bigger chunks mean fewer sink calls
+// (system calls for file descriptors) at the cost of stack space
+#ifndef VCFG_WRITE_BUFFER_SIZE
+	#define VCFG_WRITE_BUFFER_SIZE 4096
+#endif
+
+// SIMD instruction sets used by the scanning helpers. Define VCFG_NO_SIMD to use only the portable code
+#if !defined(VCFG_NO_SIMD)
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+		#define VCFG_SIMD_SSE2 1
+	#elif defined(__aarch64__) || defined(_M_ARM64)
+		#define VCFG_SIMD_NEON 1
+	#endif
+#endif
+
+// Storage class of the per-thread variables
+#ifndef VCFG_THREAD_LOCAL
+	#if defined(__cplusplus)
+		#define VCFG_THREAD_LOCAL thread_local
+	#elif defined(_MSC_VER)
+		#define VCFG_THREAD_LOCAL __declspec(thread)
+	#else
+		#define VCFG_THREAD_LOCAL _Thread_local
+	#endif
+#endif
+
+// Memory management functions used by the parser. They can be overridden
+// (before including the library) to use a custom allocator on embedded systems
+// or to instrument the allocations done by the parser
+#ifndef VCFG_MALLOC
+	#define VCFG_MALLOC(size) malloc(size)
+#endif
+
+#ifndef VCFG_CALLOC
+	#define VCFG_CALLOC(count, size) calloc(count, size)
+#endif
+
+#ifndef VCFG_REALLOC
+	#define VCFG_REALLOC(ptr, size) realloc(ptr, size)
+#endif
+
+#ifndef VCFG_FREE
+	#define VCFG_FREE(ptr) free(ptr)
+#endif
+
 #endif // VCFG_MACROS_H
\ No newline at end of file
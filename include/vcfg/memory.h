@@ -0,0 +1,266 @@
+﻿/*
+ * memory.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef VCFG_MEMORY_H
+#define VCFG_MEMORY_H 1
+
+#include "parser.h"
+#include "macros.h"
+#include "trace.h"
+#include "budget.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+	#include <stdlib.h>
+
+	// All the memory owned by the parsed data goes through the functions below.
+	// The callers always pass the size of the block, so we can keep track of the live bytes
+	// (for the byte limit and VCFG_ENABLE_STATS) without storing any additional headers
+
+	/**
+	 *	@brief Allocate memory for the parsed data.
+	 *
+	 *	@param size - number of bytes to allocate
+	 *
+	 *	@returns (void*) pointer to the allocated memory or NULL on failure
+	 */
+	inline void* vcfginternal_malloc(VCFG_Parser* parserObj, size_t size) {
+		if (!vcfginternal_check_bytes(parserObj, size)) return 0;
+
+		VCFG_TIMER_START(timer);
+		void* result = VCFG_MALLOC(size);
+		VCFG_TIMER_STOP(parserObj, VCFG_PHASE_ALLOC, timer);
+		if (result) parserObj->m_parsedBytes += size;
+		else vcfginternal_set_error(parserObj, VCFG_ERROR_OUT_OF_MEMORY);
+	#if defined(VCFG_ENABLE_STATS)
+		if (result) {
+			++(parserObj->m_stats.allocCount);
+			parserObj->m_stats.liveBytes += size;
+			if (parserObj->m_stats.liveBytes > parserObj->m_stats.peakBytes) parserObj->m_stats.peakBytes = parserObj->m_stats.liveBytes;
+		}
+	#endif
+		return result;
+	}
+
+	/**
+	 *	@brief Allocate zero initialized memory for the parsed data.
+	 *
+	 *	@param count - number of elements
+	 *	@param size - size of a single element
+	 *
+	 *	@returns (void*) pointer to the allocated memory or NULL on failure
+	 */
+	inline void* vcfginternal_calloc(VCFG_Parser* parserObj, size_t count, size_t size) {
+		if (!vcfginternal_check_bytes(parserObj, count * size)) return 0;
+
+		VCFG_TIMER_START(timer);
+		void* result = VCFG_CALLOC(count, size);
+		VCFG_TIMER_STOP(parserObj, VCFG_PHASE_ALLOC, timer);
+		if (result) parserObj->m_parsedBytes += count * size;
+		else vcfginternal_set_error(parserObj, VCFG_ERROR_OUT_OF_MEMORY);
+	#if defined(VCFG_ENABLE_STATS)
+		if (result) {
+			++(parserObj->m_stats.allocCount);
+			parserObj->m_stats.liveBytes += count * size;
+			if (parserObj->m_stats.liveBytes > parserObj->m_stats.peakBytes) parserObj->m_stats.peakBytes = parserObj->m_stats.liveBytes;
+		}
+	#endif
+		return result;
+	}
+
+	/**
+	 *	@brief Resize a block of memory owned by the parsed data.
+	 *
+	 *	@param ptr - the block to resize (can be NULL)
+	 *	@param oldSize - the current size of the block
+	 *	@param newSize - the desired size of the block
+	 *
+	 *	@returns (void*) pointer to the resized memory or NULL on failure (the old block stays valid)
+	 */
+	inline void* vcfginternal_realloc(VCFG_Parser* parserObj, void* ptr, size_t oldSize, size_t newSize) {
+		if (!ptr) oldSize = 0;
+		if ((newSize > oldSize) && !vcfginternal_check_bytes(parserObj, newSize - oldSize)) return 0;
+
+		VCFG_TIMER_START(timer);
+		void* result = VCFG_REALLOC(ptr, newSize);
+		VCFG_TIMER_STOP(parserObj, VCFG_PHASE_ALLOC, timer);
+		if (result) parserObj->m_parsedBytes += newSize - oldSize;
+		else vcfginternal_set_error(parserObj, VCFG_ERROR_OUT_OF_MEMORY);
+	#if defined(VCFG_ENABLE_STATS)
+		if (result) {
+			if (ptr) ++(parserObj->m_stats.reallocCount);
+			else ++(parserObj->m_stats.allocCount);
+			parserObj->m_stats.liveBytes += newSize;
+			parserObj->m_stats.liveBytes -= oldSize;
+			if (parserObj->m_stats.liveBytes > parserObj->m_stats.peakBytes) parserObj->m_stats.peakBytes = parserObj->m_stats.liveBytes;
+		}
+	#endif
+		return result;
+	}
+
+	/**
+	 *	@brief Free a block of memory owned by the parsed data.
+	 *
+	 *	@param ptr - the block to free (can be NULL)
+	 *	@param size - the size of the block
+	 */
+	inline void vcfginternal_free(VCFG_Parser* parserObj, void* ptr, size_t size) {
+		if (!ptr) return;
+		VCFG_TIMER_START(timer);
+		VCFG_FREE(ptr);
+		VCFG_TIMER_STOP(parserObj, VCFG_PHASE_ALLOC, timer);
+		parserObj->m_parsedBytes -= size;
+	#if defined(VCFG_ENABLE_STATS)
+		++(parserObj->m_stats.freeCount);
+		parserObj->m_stats.liveBytes -= size;
+	#endif
+	}
+
+	/**
+	 *	@brief Get the capacity of a growable array.
+	 *
+	 *	The key and section arrays of the parsed data grow geometrically, so their capacity
+	 *	is always the smallest power of two that fits all the elements and doesn't have to be stored
+	 *
+	 *	@param count - number of elements in the array
+	 *
+	 *	@returns (size_t) number of elements the array has room for
+	 */
+	inline size_t vcfginternal_array_capacity(size_t count) {
+		if (!count) return 0;
+
+		size_t capacity = 1;
+		while (capacity < count) capacity <<= 1;
+		return capacity;
+	}
+
+	/**
+	 *	@brief Make room for one more element in a growable array.
+	 *
+	 *	Doubles the array when it's full, so that appending n elements costs O(n) copies in total
+	 *
+	 *	@param array - the array (can be NULL when count is 0)
+	 *	@param count - number of elements in the array
+	 *	@param elementSize - size of a single element
+	 *
+	 *	@returns (void*) pointer to the array or NULL on failure (the old array stays valid)
+	 */
+	inline void* vcfginternal_grow_array(VCFG_Parser* parserObj, void* array, size_t count, size_t elementSize) {
+		size_t capacity = vcfginternal_array_capacity(count);
+		if (count < capacity) return array;
+
+		size_t newCapacity = capacity ? (capacity << 1) : 1;
+		return vcfginternal_realloc(parserObj, array, capacity * elementSize, newCapacity * elementSize);
+	}
+
+#if defined(VCFG_ENABLE_STATS)
+	/**
+	 *	@brief Accumulate the memory used by a key.
+	 *
+	 *	Recursively adds the memory used by the key, its value and all of its children
+	 *	to the section statistics. The size of the key structure itself is accounted by the owner
+	 */
+	inline void vcfginternal_accumulate_key_stats(const VCFGKey_t* key, VCFGSectionStats_t* stats) {
+		++(stats->nodeCount);
+		if (key->name) stats->nameBytes += vcfginternal_strlen(key->name) + 1;
+		if (key->value) stats->valueBytes += vcfginternal_strlen(key->value) + 1;
+
+		stats->nodeBytes += vcfginternal_array_capacity(key->childCount) * sizeof(VCFGKey_t);
+		for (uint32_t i = 0; i < key->childCount; i++) {
+			vcfginternal_accumulate_key_stats(&(key->children[i]), stats);
+		}
+	}
+
+	/**
+	 *	@brief Accumulate the memory used by a section.
+	 */
+	inline void vcfginternal_accumulate_section_stats(const VCFGSection_t* section, VCFGSectionStats_t* stats) {
+		if (section->name) stats->nameBytes += vcfginternal_strlen(section->name) + 1;
+
+		stats->nodeBytes += vcfginternal_array_capacity(section->keyCount) * sizeof(VCFGKey_t);
+		for (uint32_t i = 0; i < section->keyCount; i++) {
+			vcfginternal_accumulate_key_stats(&(section->keys[i]), stats);
+		}
+	}
+
+	/**
+	 *	@brief Get parser memory statistics.
+	 *
+	 *	Returns the allocation counters of the parser and the memory used by the parsed data
+	 *	(names, values and node arrays) summed over all the sections
+	 *
+	 *	@param stats - the structure to fill
+	 *
+	 *	@returns 0 - Failure, 1 - Success
+	 */
+	inline int vcfg_get_stats(VCFG_Parser* parserObj, VCFGStats_t* stats) {
+		if (!parserObj || !stats) return 0;
+
+		*stats = parserObj->m_stats;
+		stats->bufferBytes = parserObj->m_configBufferLength;
+		stats->sectionCount = parserObj->m_sectionCount;
+
+		VCFGSectionStats_t totals = { 0 };
+		totals.nodeBytes = vcfginternal_array_capacity(parserObj->m_sectionCount) * sizeof(VCFGSection_t);
+		for (uint32_t i = 0; i < parserObj->m_sectionCount; i++) {
+			vcfginternal_accumulate_section_stats(&(parserObj->m_parsedData[i]), &totals);
+		}
+		stats->totals = totals;
+
+		return 1;
+	}
+
+	/**
+	 *	@brief Get section memory statistics.
+	 *
+	 *	Returns the memory used by the names, values and node arrays of a single section
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param stats - the structure to fill
+	 *
+	 *	@returns 0 - Failure (no such section), 1 - Success
+	 */
+	inline int vcfg_get_section_stats(VCFG_Parser* parserObj, const char* sectionName, VCFGSectionStats_t* stats) {
+		if (!parserObj || !stats) return 0;
+
+		VCFGSection_t* section = vcfg_get_section(parserObj, sectionName);
+		if (!section) return 0;
+
+		VCFGSectionStats_t result = { 0 };
+		vcfginternal_accumulate_section_stats(section, &result);
+		*stats = result;
+
+		return 1;
+	}
+#endif // VCFG_ENABLE_STATS
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_MEMORY_H
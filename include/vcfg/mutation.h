@@ -0,0 +1,688 @@
+﻿/*
+ * mutation.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef VCFG_MUTATION_H
+#define VCFG_MUTATION_H 1
+
+#include "parser.h"
+#include "macros.h"
+#include "strconv.h"
+#include "memory.h"
+#include "errors.h"
+#include "implementation.h"
+#include "index.h"
+
+// The parsed data can be changed after parsing. New sections, keys and array elements go through the same
+// geometrically growing arrays as the parsed ones, so adding n of them costs O(n) copies in total.
+// The mutations keep the invariants the rest of the library relies on: the sourceIndex values of the keys
+// of a section or node are always 0..n-1 (new keys are appended to the source order) and the name
+// of every array element is its index in the source order. With VCFG_ENABLE_LOSSLESS the changed values
+// are marked and the text of the removed keys is remembered, so that VCFG_WRITE_PRESERVE_FORMATTING
+// can rewrite just those parts of the configuration buffer. The sections and keys of sections that are added
+// or removed are added to or removed from the hash index right away (see vcfg_build_index).
+// Setting a key that a section only inherits ([name : parent]) adds it to the section, the parent keeps its value,
+// and removing a key removes it from the section only, an inherited key of the same name becomes visible again.
+// WARNING: adding a section invalidates all the section and node pointers, adding or removing a key
+// invalidates the pointers to the keys of the same section or node (and to their children)
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+	#include <stdlib.h>
+
+	/**
+	 *	@brief Check if a key is an array.
+	 */
+	inline int vcfginternal_is_array(const VCFGKey_t* key) {
+		return key && key->value && (vcfginternal_strcmp(key->value, "[array]") == 0);
+	}
+
+	/**
+	 *	@brief Check if a key is an object.
+	 */
+	inline int vcfginternal_is_object(const VCFGKey_t* key) {
+		return key && key->value && (vcfginternal_strcmp(key->value, "{object}") == 0);
+	}
+
+	/**
+	 *	@brief Copy a string to memory owned by the parsed data.
+	 *
+	 *	@returns (char*) the null terminated copy or NULL on failure
+	 */
+	inline char* vcfginternal_copy_string(VCFG_Parser* parserObj, const char* text, size_t length) {
+		char* result = (char*)vcfginternal_malloc(parserObj, length + 1);
+		if (!result) return 0;
+
+		vcfginternal_memcpy((void*)result, (const void*)text, length);
+		result[length] = '\0';
+		return result;
+	}
+
+	/**
+	 *	@brief Clear the value of a key.
+	 *
+	 *	Frees the value and all the children of the key, but keeps its name
+	 */
+	inline void vcfginternal_clear_value(VCFG_Parser* parserObj, VCFGKey_t* key) {
+		if (key->value) {
+			vcfginternal_free(parserObj, (void*)(key->value), vcfginternal_strlen(key->value) + 1);
+			key->value = 0;
+		}
+
+		if (key->childCount) {
+			for (uint32_t i = 0; i < key->childCount; i++) {
+				vcfginternal_clear_key(parserObj, key->children[i]);
+			}
+			vcfginternal_free(parserObj, (void*)(key->children), vcfginternal_array_capacity(key->childCount) * sizeof(VCFGKey_t));
+		}
+		key->children = 0;
+		key->childCount = 0;
+		key->enumCache = 0;
+		key->typeTag = VCFG_TAG_UNKNOWN;
+		key->quantityTag = VCFG_QUANTITY_UNKNOWN;
+	}
+
+	/**
+	 *	@brief Replace the value of a key.
+	 *
+	 *	The new value is copied before the old one is freed, so the key stays intact on failure
+	 *
+	 *	@param value - the new value (NULL or "" for an empty value)
+	 *	@param length - length of the new value
+	 *
+	 *	@returns 0 - Failure, 1 - Success
+	 */
+	inline int vcfginternal_replace_value(VCFG_Parser* parserObj, VCFGKey_t* key, const char* value, size_t length) {
+		char* newValue = 0;
+		if (value && length) {
+			newValue = vcfginternal_copy_string(parserObj, value, length);
+			if (!newValue) return 0;
+		}
+
+		vcfginternal_clear_value(parserObj, key);
+		key->value = newValue;
+		key->typeTag = vcfginternal_classify_bool(newValue);
+		if (parserObj->m_options & VCFG_OPTION_UNITS) vcfginternal_cache_quantity(key, length);
+	#if defined(VCFG_ENABLE_LOSSLESS)
+		key->sourceFlags |= VCFG_SOURCE_EDITED;
+	#endif
+		return 1;
+	}
+
+	/**
+	 *	@brief Name a key after an array index.
+	 *
+	 *	The name is rewritten in place when the number of digits doesn't change
+	 *
+	 *	@returns 0 - Failure, 1 - Success
+	 */
+	inline int vcfginternal_set_index_name(VCFG_Parser* parserObj, VCFGKey_t* key, uint32_t index) {
+		char indexBuffer[24];
+		size_t indexLength = vcfginternal_uint64tobuf((uint64_t)index, indexBuffer);
+
+		size_t oldSize = key->name ? vcfginternal_strlen(key->name) + 1 : 0;
+		if (oldSize != indexLength + 1) {
+			char* newName = (char*)vcfginternal_realloc(parserObj, (void*)(key->name), oldSize, indexLength + 1);
+			if (!newName) return 0;
+			key->name = newName;
+		}
+
+		vcfginternal_memcpy((void*)(key->name), (const void*)indexBuffer, indexLength + 1);
+		return 1;
+	}
+
+	/**
+	 *	@brief Find a key by name without recording an access.
+	 *
+	 *	@returns (VCFGKey_t*) the key or NULL if it doesn't exist
+	 */
+	inline VCFGKey_t* vcfginternal_find_in_keys(VCFGKey_t* keys, uint32_t keyCount, const char* keyName) {
+		for (uint32_t i = 0; i < keyCount; i++) {
+			if (vcfginternal_strcmp(keys[i].name, keyName) == 0) return &(keys[i]);
+		}
+		return 0;
+	}
+
+	/**
+	 *	@brief Find a key of a section (not an inherited one) without recording an access.
+	 *
+	 *	Takes a single probe when the parser has a hash index, the section has to be the first one of its name
+	 *	(the one vcfg_get_section returns)
+	 *
+	 *	@returns (VCFGKey_t*) the key or NULL if the section doesn't have it
+	 */
+	inline VCFGKey_t* vcfginternal_find_own_key(VCFG_Parser* parserObj, VCFGSection_t* section, const char* keyName) {
+		if (parserObj->m_index && keyName) return vcfginternal_index_find_key(parserObj, section->name, keyName);
+		return vcfginternal_find_in_keys(section->keys, section->keyCount, keyName);
+	}
+
+	/**
+	 *	@brief Append a new key.
+	 *
+	 *	New keys have an empty value and come last in the source order
+	 *
+	 *	@param keys - the keys of a section or the children of a node
+	 *	@param keyCount - number of keys
+	 *	@param keyName - name of the key (can't be empty)
+	 *
+	 *	@returns (VCFGKey_t*) the key or NULL on failure
+	 */
+	inline VCFGKey_t* vcfginternal_append_key(VCFG_Parser* parserObj, VCFGKey_t** keys, uint32_t* keyCount, const char* keyName) {
+		size_t nameLength = keyName ? vcfginternal_strlen(keyName) : 0;
+		if (!nameLength) {
+			vcfginternal_set_error(parserObj, VCFG_ERROR_NOT_REPRESENTABLE);
+			return 0;
+		}
+
+		char* name = vcfginternal_copy_string(parserObj, keyName, nameLength);
+		if (!name) return 0;
+
+		VCFGKey_t* newKeys = (VCFGKey_t*)vcfginternal_grow_array(parserObj, (void*)(*keys), *keyCount, sizeof(VCFGKey_t));
+		if (!newKeys) {
+			vcfginternal_free(parserObj, (void*)name, nameLength + 1);
+			return 0;
+		}
+		*keys = newKeys;
+
+		VCFGKey_t* key = &(newKeys[*keyCount]);
+		vcfginternal_init_key(key);
+		key->sourceIndex = *keyCount;
+		key->name = name;
+		++(*keyCount);
+		return key;
+	}
+
+	/**
+	 *	@brief Find a key or append a new one.
+	 *
+	 *	@see vcfginternal_append_key
+	 *
+	 *	@returns (VCFGKey_t*) the key or NULL on failure
+	 */
+	inline VCFGKey_t* vcfginternal_find_or_add_key(VCFG_Parser* parserObj, VCFGKey_t** keys, uint32_t* keyCount, const char* keyName) {
+		VCFGKey_t* key = vcfginternal_find_in_keys(*keys, *keyCount, keyName);
+		return key ? key : vcfginternal_append_key(parserObj, keys, keyCount, keyName);
+	}
+
+	/**
+	 *	@brief Remove a key from a section or node.
+	 *
+	 *	Closes the gap in the array and in the source order. In arrays the following
+	 *	elements are renamed, so that the names stay equal to the indices
+	 *
+	 *	@param keys - the keys of a section or the children of a node
+	 *	@param keyCount - number of keys
+	 *	@param key - the key to remove (one of keys)
+	 *	@param isArray - 1 if the keys are elements of an array
+	 *
+	 *	@returns 0 - Failure, 1 - Success
+	 */
+	inline int vcfginternal_remove_from_keys(VCFG_Parser* parserObj, VCFGKey_t** keys, uint32_t* keyCount, VCFGKey_t* key, int isArray) {
+		uint32_t position = (uint32_t)(key - *keys);
+		uint32_t sourceIndex = key->sourceIndex;
+		size_t oldCapacity = vcfginternal_array_capacity(*keyCount);
+	#if defined(VCFG_ENABLE_LOSSLESS)
+		if (!vcfginternal_log_removal(parserObj, key)) return 0;
+	#endif
+
+		vcfginternal_clear_key(parserObj, *key);
+		for (uint32_t i = position + 1; i < *keyCount; i++) (*keys)[i - 1] = (*keys)[i];
+		--(*keyCount);
+
+		// Nothing has to be renumbered when the key was the last one in the source order
+		int result = 1;
+		for (uint32_t i = 0; (sourceIndex < *keyCount) && (i < *keyCount); i++) {
+			if ((*keys)[i].sourceIndex <= sourceIndex) continue;
+			--((*keys)[i].sourceIndex);
+			if (isArray && !vcfginternal_set_index_name(parserObj, &((*keys)[i]), (*keys)[i].sourceIndex)) result = 0;
+		}
+
+		// Keep the capacity equal to the smallest power of two that fits all the keys
+		size_t newCapacity = vcfginternal_array_capacity(*keyCount);
+		if (newCapacity != oldCapacity) {
+			if (!newCapacity) {
+				vcfginternal_free(parserObj, (void*)(*keys), oldCapacity * sizeof(VCFGKey_t));
+				*keys = 0;
+			}
+			else {
+				VCFGKey_t* newKeys = (VCFGKey_t*)vcfginternal_realloc(parserObj, (void*)(*keys), oldCapacity * sizeof(VCFGKey_t), newCapacity * sizeof(VCFGKey_t));
+				if (!newKeys) return 0;
+				*keys = newKeys;
+			}
+		}
+		return result;
+	}
+
+	/**
+	 *	@brief Add a section.
+	 *
+	 *	Returns the section with the provided name, creating an empty one at the end when it doesn't exist.
+	 *	The root section is created as well when nothing was parsed yet
+	 *	WARNING: all the section and node pointers obtained before the call are invalidated when a section is created!
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *
+	 *	@returns (VCFGSection_t*) the section or NULL on failure (see vcfg_get_last_error)
+	 */
+	inline VCFGSection_t* vcfg_add_section(VCFG_Parser* parserObj, const char* sectionName) {
+		if (!parserObj) return 0;
+		parserObj->m_lastError = VCFG_ERROR_NONE;
+
+		if (!(parserObj->m_sectionCount)) {
+			parserObj->m_parsedData = (VCFGSection_t*)vcfginternal_calloc(parserObj, 1, sizeof(VCFGSection_t));
+			if (!(parserObj->m_parsedData)) return 0;
+			parserObj->m_sectionCount = 1;
+			vcfginternal_index_add(parserObj, 0, VCFG_INDEX_SECTION);
+		}
+
+		VCFGSection_t* section = vcfg_get_section(parserObj, sectionName);
+		if (section) return section;
+
+		size_t nameLength = vcfginternal_strlen(sectionName);
+		if (!nameLength) {
+			vcfginternal_set_error(parserObj, VCFG_ERROR_NOT_REPRESENTABLE);
+			return 0;
+		}
+
+		char* name = vcfginternal_copy_string(parserObj, sectionName, nameLength);
+		if (!name) return 0;
+
+		VCFGSection_t* newSections = (VCFGSection_t*)vcfginternal_grow_array(parserObj, parserObj->m_parsedData, parserObj->m_sectionCount, sizeof(VCFGSection_t));
+		if (!newSections) {
+			vcfginternal_free(parserObj, (void*)name, nameLength + 1);
+			return 0;
+		}
+		parserObj->m_parsedData = newSections;
+
+		section = &(newSections[parserObj->m_sectionCount]);
+		section->name = name;
+		section->keyCount = 0;
+		section->parent = 0;
+		section->keys = 0;
+	#if defined(VCFG_ENABLE_LOSSLESS)
+		section->headerEnd = 0;
+		section->sourceFlags = 0;
+	#endif
+		++(parserObj->m_sectionCount);
+		vcfginternal_index_add(parserObj, parserObj->m_sectionCount - 1, VCFG_INDEX_SECTION);
+		vcfginternal_section_tree_add(parserObj);
+		return section;
+	}
+
+	/**
+	 *	@brief Find or add a key of a section.
+	 *
+	 *	With the hash index an existing key is found with a single probe
+	 *
+	 *	@returns (VCFGKey_t*) the key or NULL on failure
+	 */
+	inline VCFGKey_t* vcfginternal_section_key(VCFG_Parser* parserObj, const char* sectionName, const char* keyName) {
+		VCFGSection_t* section = vcfg_add_section(parserObj, sectionName);
+		if (!section) return 0;
+
+		VCFGKey_t* key = vcfginternal_find_own_key(parserObj, section, keyName);
+		if (key) return key;
+
+		uint32_t keyCount = section->keyCount;
+		key = vcfginternal_append_key(parserObj, &(section->keys), &(section->keyCount), keyName);
+		if (key) vcfginternal_index_add(parserObj, (uint32_t)(section - parserObj->m_parsedData), keyCount);
+		return key;
+	}
+
+	/**
+	 *	@brief Find or add a child key of a node.
+	 *
+	 *	New keys can only be added to objects, elements of arrays can be replaced but not added by name
+	 *	(see vcfg_insert_value)
+	 *
+	 *	@returns (VCFGKey_t*) the key or NULL on failure
+	 */
+	inline VCFGKey_t* vcfginternal_node_key(VCFG_Parser* parserObj, VCFG_Node* parentNode, const char* keyName) {
+		if (!parentNode) return vcfginternal_section_key(parserObj, 0, keyName);
+		parserObj->m_lastError = VCFG_ERROR_NONE;
+
+		if (vcfginternal_is_array(parentNode)) return vcfginternal_find_in_keys(parentNode->children, parentNode->childCount, keyName);
+		if (!vcfginternal_is_object(parentNode)) return 0;
+		return vcfginternal_find_or_add_key(parserObj, &(parentNode->children), &(parentNode->childCount), keyName);
+	}
+
+	/**
+	 *	@brief Turn a key into an empty array or object.
+	 *
+	 *	A key that already holds a container of the same type is left untouched
+	 *
+	 *	@returns (VCFG_Node*) the key or NULL on failure
+	 */
+	inline VCFG_Node* vcfginternal_make_container(VCFG_Parser* parserObj, VCFGKey_t* key, int isArray) {
+		if (!key) return 0;
+		if (isArray ? vcfginternal_is_array(key) : vcfginternal_is_object(key)) return key;
+
+		if (!vcfginternal_replace_value(parserObj, key, isArray ? "[array]" : "{object}", isArray ? 7 : 8)) return 0;
+		return key;
+	}
+
+	/**
+	 *	@brief Set integer value of a key.
+	 *
+	 *	Formats the integer without any allocations other than the value itself
+	 */
+	inline int vcfginternal_set_int(VCFG_Parser* parserObj, VCFGKey_t* key, int64_t value) {
+		if (!key) return 0;
+
+		char numberBuffer[24];
+		size_t numberLength = vcfginternal_int64tobuf(value, numberBuffer);
+		return vcfginternal_replace_value(parserObj, key, numberBuffer, numberLength);
+	}
+
+	/**
+	 *	@brief Check if a floating point value can be set.
+	 *
+	 *	Infinities and NaN can't be written in the configuration syntax. Checked before
+	 *	the key is looked up, so that no empty key is left behind
+	 *
+	 *	@returns 0 - Not representable, 1 - Success
+	 */
+	inline int vcfginternal_check_float(VCFG_Parser* parserObj, double value) {
+		if ((value == value) && (value <= DBL_MAX) && (value >= -DBL_MAX)) return 1;
+
+		parserObj->m_lastError = VCFG_ERROR_NOT_REPRESENTABLE;
+		return 0;
+	}
+
+	/**
+	 *	@brief Set floating point value of a key.
+	 */
+	inline int vcfginternal_set_float(VCFG_Parser* parserObj, VCFGKey_t* key, double value) {
+		if (!key) return 0;
+
+		char numberBuffer[VCFG_FLOAT_BUFFER_SIZE];
+		size_t numberLength = vcfginternal_floattobuf(value, numberBuffer);
+		return vcfginternal_replace_value(parserObj, key, numberBuffer, numberLength);
+	}
+
+	/**
+	 *	@brief Set string value.
+	 *
+	 *	Replaces the value of the key (and all of its children), creating the section and the key when they don't exist
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key
+	 *	@param value - the new value (NULL or "" for an empty value)
+	 *
+	 *	@returns 0 - Failure (see vcfg_get_last_error), 1 - Success
+	 */
+	inline int vcfg_set_string(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, const char* value) {
+		VCFGKey_t* key = vcfginternal_section_key(parserObj, sectionName, keyName);
+		return key ? vcfginternal_replace_value(parserObj, key, value, value ? vcfginternal_strlen(value) : 0) : 0;
+	}
+
+	/**
+	 *	@brief Set string value in node.
+	 *
+	 *	Replaces the value of the key (and all of its children) in an object or array, creating the key
+	 *	when it doesn't exist in the object. Array elements are identified by their index ("0", "1", ...)
+	 *
+	 *	@param parentNode - the object or array (NULL for the root section)
+	 *	@param keyName - name of the key
+	 *	@param value - the new value (NULL or "" for an empty value)
+	 *
+	 *	@returns 0 - Failure, 1 - Success
+	 */
+	inline int vcfg_set_string_in_node(VCFG_Parser* parserObj, VCFG_Node* parentNode, const char* keyName, const char* value) {
+		VCFGKey_t* key = vcfginternal_node_key(parserObj, parentNode, keyName);
+		return key ? vcfginternal_replace_value(parserObj, key, value, value ? vcfginternal_strlen(value) : 0) : 0;
+	}
+
+	/**
+	 *	@brief Set integer value.
+	 *
+	 *	@see vcfg_set_string
+	 */
+	inline int vcfg_set_int(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, int64_t value) {
+		return vcfginternal_set_int(parserObj, vcfginternal_section_key(parserObj, sectionName, keyName), value);
+	}
+
+	/**
+	 *	@brief Set integer value in node.
+	 *
+	 *	@see vcfg_set_string_in_node
+	 */
+	inline int vcfg_set_int_in_node(VCFG_Parser* parserObj, VCFG_Node* parentNode, const char* keyName, int64_t value) {
+		return vcfginternal_set_int(parserObj, vcfginternal_node_key(parserObj, parentNode, keyName), value);
+	}
+
+	/**
+	 *	@brief Set floating point value.
+	 *
+	 *	Writes the shortest decimal that reads back as the same number. Fails with
+	 *	VCFG_ERROR_NOT_REPRESENTABLE on infinities and NaN
+	 *
+	 *	@see vcfg_set_string
+	 */
+	inline int vcfg_set_float(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, double value) {
+		if (!parserObj || !vcfginternal_check_float(parserObj, value)) return 0;
+		return vcfginternal_set_float(parserObj, vcfginternal_section_key(parserObj, sectionName, keyName), value);
+	}
+
+	/**
+	 *	@brief Set floating point value in node.
+	 *
+	 *	@see vcfg_set_float, vcfg_set_string_in_node
+	 */
+	inline int vcfg_set_float_in_node(VCFG_Parser* parserObj, VCFG_Node* parentNode, const char* keyName, double value) {
+		if (!parserObj || !vcfginternal_check_float(parserObj, value)) return 0;
+		return vcfginternal_set_float(parserObj, vcfginternal_node_key(parserObj, parentNode, keyName), value);
+	}
+
+	/**
+	 *	@brief Set boolean value.
+	 *
+	 *	@see vcfg_set_string
+	 */
+	inline int vcfg_set_bool(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, int value) {
+		return vcfg_set_string(parserObj, sectionName, keyName, value ? "true" : "false");
+	}
+
+	/**
+	 *	@brief Set boolean value in node.
+	 *
+	 *	@see vcfg_set_string_in_node
+	 */
+	inline int vcfg_set_bool_in_node(VCFG_Parser* parserObj, VCFG_Node* parentNode, const char* keyName, int value) {
+		return vcfg_set_string_in_node(parserObj, parentNode, keyName, value ? "true" : "false");
+	}
+
+	/**
+	 *	@brief Set array.
+	 *
+	 *	Returns the array stored in the key. A key with any other value is replaced with an empty array,
+	 *	the section and the key are created when they don't exist
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key
+	 *
+	 *	@returns (VCFG_Node*) the array or NULL on failure (see vcfg_get_last_error)
+	 */
+	inline VCFG_Node* vcfg_set_array(VCFG_Parser* parserObj, const char* sectionName, const char* keyName) {
+		return vcfginternal_make_container(parserObj, vcfginternal_section_key(parserObj, sectionName, keyName), 1);
+	}
+
+	/**
+	 *	@brief Set array in node.
+	 *
+	 *	@see vcfg_set_array, vcfg_set_string_in_node
+	 */
+	inline VCFG_Node* vcfg_set_array_in_node(VCFG_Parser* parserObj, VCFG_Node* parentNode, const char* keyName) {
+		return vcfginternal_make_container(parserObj, vcfginternal_node_key(parserObj, parentNode, keyName), 1);
+	}
+
+	/**
+	 *	@brief Set object.
+	 *
+	 *	Returns the object stored in the key. A key with any other value is replaced with an empty object,
+	 *	the section and the key are created when they don't exist
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key
+	 *
+	 *	@returns (VCFG_Node*) the object or NULL on failure (see vcfg_get_last_error)
+	 */
+	inline VCFG_Node* vcfg_set_object(VCFG_Parser* parserObj, const char* sectionName, const char* keyName) {
+		return vcfginternal_make_container(parserObj, vcfginternal_section_key(parserObj, sectionName, keyName), 0);
+	}
+
+	/**
+	 *	@brief Set object in node.
+	 *
+	 *	@see vcfg_set_object, vcfg_set_string_in_node
+	 */
+	inline VCFG_Node* vcfg_set_object_in_node(VCFG_Parser* parserObj, VCFG_Node* parentNode, const char* keyName) {
+		return vcfginternal_make_container(parserObj, vcfginternal_node_key(parserObj, parentNode, keyName), 0);
+	}
+
+	/**
+	 *	@brief Insert a value into an array.
+	 *
+	 *	The elements from the index on move one position up (and are renamed accordingly).
+	 *	Appending (index equal to the number of elements) costs amortized O(1), inserting in the middle
+	 *	is linear in the number of elements. The new element can be turned into a container with
+	 *	vcfg_set_array_in_node or vcfg_set_object_in_node
+	 *	WARNING: all the pointers to the elements of the array obtained before the call are invalidated!
+	 *
+	 *	@param arrayNode - the array
+	 *	@param index - position of the new element (0 - number of elements)
+	 *	@param value - value of the new element (NULL or "" for an empty value)
+	 *
+	 *	@returns (VCFG_Node*) the new element or NULL on failure (see vcfg_get_last_error)
+	 */
+	inline VCFG_Node* vcfg_insert_value(VCFG_Parser* parserObj, VCFG_Node* arrayNode, uint32_t index, const char* value) {
+		if (!parserObj || !vcfginternal_is_array(arrayNode) || (index > arrayNode->childCount)) return 0;
+		parserObj->m_lastError = VCFG_ERROR_NONE;
+
+		VCFGKey_t element;
+		vcfginternal_init_key(&element);
+		element.sourceIndex = index;
+		if (!vcfginternal_set_index_name(parserObj, &element, index)) return 0;
+		if (!vcfginternal_replace_value(parserObj, &element, value, value ? vcfginternal_strlen(value) : 0)) {
+			vcfginternal_clear_key(parserObj, element);
+			return 0;
+		}
+
+		VCFGKey_t* newChildren = (VCFGKey_t*)vcfginternal_grow_array(parserObj, (void*)(arrayNode->children), arrayNode->childCount, sizeof(VCFGKey_t));
+		if (!newChildren) {
+			vcfginternal_clear_key(parserObj, element);
+			return 0;
+		}
+		arrayNode->children = newChildren;
+
+		// The element goes before the one that is currently at the index (the layout can differ from the source order).
+		// Nothing has to move or be renamed when appending
+		uint32_t position = arrayNode->childCount;
+		for (uint32_t i = 0; (index < arrayNode->childCount) && (i < arrayNode->childCount); i++) {
+			if (newChildren[i].sourceIndex == index) position = i;
+			if (newChildren[i].sourceIndex < index) continue;
+
+			++(newChildren[i].sourceIndex);
+			if (!vcfginternal_set_index_name(parserObj, &(newChildren[i]), newChildren[i].sourceIndex)) vcfginternal_set_error(parserObj, VCFG_ERROR_OUT_OF_MEMORY);
+		}
+
+		for (uint32_t i = arrayNode->childCount; i > position; i--) newChildren[i] = newChildren[i - 1];
+		newChildren[position] = element;
+		++(arrayNode->childCount);
+
+		return &(newChildren[position]);
+	}
+
+	/**
+	 *	@brief Append a value to an array.
+	 *
+	 *	@see vcfg_insert_value
+	 */
+	inline VCFG_Node* vcfg_append_value(VCFG_Parser* parserObj, VCFG_Node* arrayNode, const char* value) {
+		if (!arrayNode) return 0;
+		return vcfg_insert_value(parserObj, arrayNode, arrayNode->childCount, value);
+	}
+
+	/**
+	 *	@brief Remove key.
+	 *
+	 *	Removes the key with its value and all of its children. The key is found through the hash index when there
+	 *	is one, but the removal takes time linear in the number of keys of the section: the following keys move one
+	 *	position down and the source order is renumbered
+	 *	WARNING: all the pointers to the keys of the section obtained before the call are invalidated!
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key
+	 *
+	 *	@returns 0 - Failure (no such key), 1 - Success
+	 */
+	inline int vcfg_remove_key(VCFG_Parser* parserObj, const char* sectionName, const char* keyName) {
+		if (!parserObj) return 0;
+		parserObj->m_lastError = VCFG_ERROR_NONE;
+
+		VCFGSection_t* section = vcfg_get_section(parserObj, sectionName);
+		if (!section) return 0;
+
+		VCFGKey_t* key = vcfginternal_find_own_key(parserObj, section, keyName);
+		if (!key) return 0;
+
+		uint32_t sectionIndex = (uint32_t)(section - parserObj->m_parsedData);
+		uint32_t duplicate = vcfginternal_index_remove(parserObj, sectionIndex, (uint32_t)(key - section->keys));
+		int result = vcfginternal_remove_from_keys(parserObj, &(section->keys), &(section->keyCount), key, 0);
+
+		// The index can't be trusted when the key was only partly removed
+		if (!result) vcfginternal_free_index(parserObj);
+		else if (duplicate != VCFG_INDEX_SECTION) vcfginternal_index_add(parserObj, sectionIndex, duplicate);
+		return result;
+	}
+
+	/**
+	 *	@brief Remove key from node.
+	 *
+	 *	Removes a key of an object or an element of an array (identified by its index, the following
+	 *	elements move one position down)
+	 *	WARNING: all the pointers to the children of the node obtained before the call are invalidated!
+	 *
+	 *	@param parentNode - the object or array (NULL for the root section)
+	 *	@param keyName - name of the key
+	 *
+	 *	@returns 0 - Failure (no such key), 1 - Success
+	 */
+	inline int vcfg_remove_key_from_node(VCFG_Parser* parserObj, VCFG_Node* parentNode, const char* keyName) {
+		if (!parentNode) return vcfg_remove_key(parserObj, 0, keyName);
+		if (!parserObj) return 0;
+		parserObj->m_lastError = VCFG_ERROR_NONE;
+
+		VCFGKey_t* key = vcfginternal_find_in_keys(parentNode->children, parentNode->childCount, keyName);
+		if (!key) return 0;
+		return vcfginternal_remove_from_keys(parserObj, &(parentNode->children), &(parentNode->childCount), key, vcfginternal_is_array(parentNode));
+	}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_MUTATION_H
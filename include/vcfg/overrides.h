@@ -0,0 +1,228 @@
+﻿/*
+ * overrides.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef VCFG_OVERRIDES_H
+#define VCFG_OVERRIDES_H 1
+
+#include "parser.h"
+#include "macros.h"
+#include "memory.h"
+#include "errors.h"
+#include "index.h"
+#include "mutation.h"
+#include "compatibility.h"
+
+// Overrides load environment variables (APP__SERVER__PORT=8080) and command line options
+// (--set server.port=8080) into a parser of their own, once. Pushed as the highest layer (see vcfg_layers_push)
+// they hide the values of the configuration files, a key without an override costs a single probe of the
+// (usually almost empty) override index before the lookup continues in the files
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+	#include <stdint.h>
+
+	#if !defined(VCFG_BUFFER_ONLY) && !defined(OS_WINDOWS)
+		extern char** environ;
+	#endif
+
+	// Maximum number of names in the path of an override (the section, the objects and the key)
+	#ifndef VCFG_OVERRIDE_MAX_PARTS
+		#define VCFG_OVERRIDE_MAX_PARTS 16
+	#endif
+
+	/**
+	 *	@brief Skip a prefix of a string.
+	 *
+	 *	@returns (const char*) the rest of the string or NULL if it doesn't start with the prefix
+	 */
+	inline const char* vcfginternal_skip_prefix(const char* str, const char* prefix) {
+		while (*prefix) {
+			if (*(str++) != *(prefix++)) return 0;
+		}
+		return str;
+	}
+
+	/**
+	 *	@brief Set a single override.
+	 *
+	 *	One name sets a key of the root section, two set a key of a section and every name in between
+	 *	is an object nested in the section
+	 *
+	 *	@param parts - names of the path (none of them empty)
+	 *
+	 *	@returns 0 - Failure (see vcfg_get_last_error), 1 - Success
+	 */
+	inline int vcfginternal_set_override(VCFG_Parser* parserObj, char** parts, uint32_t partCount, const char* value) {
+		if (partCount == 1) return vcfg_set_string(parserObj, 0, parts[0], value);
+
+		VCFG_Node* node = 0;
+		for (uint32_t i = 1; i + 1 < partCount; i++) {
+			node = node ? vcfg_set_object_in_node(parserObj, node, parts[i]) : vcfg_set_object(parserObj, parts[0], parts[i]);
+			if (!node) return 0;
+		}
+		return node ? vcfg_set_string_in_node(parserObj, node, parts[partCount - 1], value) : vcfg_set_string(parserObj, parts[0], parts[1], value);
+	}
+
+	/**
+	 *	@brief Split the path of an override and set it.
+	 *
+	 *	@param path - the path (e.g. "SERVER__PORT" or "server.port")
+	 *	@param pathLength - length of the path
+	 *	@param separator - the separator of the names ("__" or ".")
+	 *	@param lowercase - 1 to convert the names to lowercase
+	 *	@param lastOnly - 1 to split at the last separator only, like the ${section.key} references
+	 *	(the section name keeps its dots)
+	 *
+	 *	@returns 0 - Failure (see vcfg_get_last_error), 1 - Success
+	 */
+	inline int vcfginternal_apply_override(VCFG_Parser* parserObj, const char* path, size_t pathLength, const char* separator, int lowercase, int lastOnly, const char* value) {
+		char* names = (char*)vcfginternal_malloc(parserObj, pathLength + 1);
+		if (!names) {
+			vcfginternal_set_error(parserObj, VCFG_ERROR_OUT_OF_MEMORY);
+			return 0;
+		}
+
+		size_t separatorLength = vcfginternal_strlen(separator);
+		size_t splitFrom = 0;
+		for (size_t i = pathLength; lastOnly && (i >= separatorLength) && !splitFrom; i--) {
+			size_t k = 0;
+			while ((k < separatorLength) && (path[i - separatorLength + k] == separator[k])) ++k;
+			if (k == separatorLength) splitFrom = i - separatorLength;
+		}
+
+		char* parts[VCFG_OVERRIDE_MAX_PARTS];
+		uint32_t partCount = 0;
+		int valid = 1;
+		for (size_t i = 0, start = 0; valid && (i <= pathLength); i++) {
+			int atSeparator = (i >= splitFrom) && (i + separatorLength <= pathLength);
+			for (size_t k = 0; atSeparator && (k < separatorLength); k++) atSeparator = (path[i + k] == separator[k]);
+			if (!atSeparator && (i < pathLength)) {
+				char c = path[i];
+				names[i] = (lowercase && (c >= 'A') && (c <= 'Z')) ? (char)(c + ('a' - 'A')) : c;
+				continue;
+			}
+
+			names[i] = '\0';
+			valid = (i > start) && (partCount < VCFG_OVERRIDE_MAX_PARTS);
+			if (valid) parts[partCount++] = names + start;
+			i += atSeparator ? separatorLength - 1 : 0;
+			start = i + 1;
+		}
+
+		int result = valid ? vcfginternal_set_override(parserObj, parts, partCount, value) : 0;
+		if (!valid) vcfginternal_set_error(parserObj, VCFG_ERROR_INVALID_OVERRIDE);
+		vcfginternal_free(parserObj, (void*)names, pathLength + 1);
+		return result;
+	}
+
+	/**
+	 *	@brief Load overrides from environment variables.
+	 *
+	 *	Every variable named PREFIX__SECTION__KEY sets the key of the section, PREFIX__KEY sets a key
+	 *	of the root section and PREFIX__SECTION__OBJECT__KEY a key of an object in the section. The names
+	 *	are converted to lowercase and split at double underscores only (APP__DB__MAX_CONN is max_conn in db).
+	 *	Values are set as strings and converted by the getters like the values of a file. The parser gets a hash
+	 *	index when it doesn't have one
+	 *
+	 *	@param prefix - prefix of the variables (e.g. "APP")
+	 *	@param environment - NULL terminated "NAME=value" entries (NULL for the environment of the process)
+	 *
+	 *	@returns 0 - Failure (VCFG_ERROR_INVALID_OVERRIDE for an empty or too deep path, see vcfg_get_last_error), 1 - Success
+	 */
+	inline int vcfg_load_environment(VCFG_Parser* parserObj, const char* prefix, char** environment) {
+		if (!parserObj || !prefix || !(*prefix)) return 0;
+		parserObj->m_lastError = VCFG_ERROR_NONE;
+
+		#if !defined(VCFG_BUFFER_ONLY)
+			#if defined(OS_WINDOWS)
+				if (!environment) environment = _environ;
+			#else
+				if (!environment) environment = environ;
+			#endif
+		#endif
+		if (!environment) return 0;
+
+		for (char** variable = environment; *variable; variable++) {
+			const char* path = vcfginternal_skip_prefix(*variable, prefix);
+			if (!path || !(path = vcfginternal_skip_prefix(path, "__"))) continue;
+
+			const char* value = path;
+			while (*value && (*value != '=')) ++value;
+			if (!(*value)) continue;
+
+			if (!vcfginternal_apply_override(parserObj, path, (size_t)(value - path), "__", 1, 0, value + 1)) return 0;
+		}
+		return parserObj->m_index ? 1 : vcfg_build_index(parserObj);
+	}
+
+	/**
+	 *	@brief Load overrides from command line arguments.
+	 *
+	 *	Every "--set section.key=value" (or "--set=section.key=value") sets the key of the section and
+	 *	"--set key=value" sets a key of the root section. The path is split at its last dot like a ${section.key}
+	 *	reference, so "--set db.primary.port=2" sets port in [db.primary]; keys of nested objects can only be
+	 *	overridden from the environment. The names are used as they are. Other arguments are skipped. Arguments
+	 *	are applied in order, so they should be loaded after the environment to take precedence over it
+	 *
+	 *	@param argc - number of arguments
+	 *	@param argv - the arguments (argv[0] is skipped like the program name)
+	 *
+	 *	@returns 0 - Failure (VCFG_ERROR_INVALID_OVERRIDE for a malformed --set, see vcfg_get_last_error), 1 - Success
+	 */
+	inline int vcfg_load_arguments(VCFG_Parser* parserObj, int argc, char** argv) {
+		if (!parserObj || (argc && !argv)) return 0;
+		parserObj->m_lastError = VCFG_ERROR_NONE;
+
+		for (int i = 1; i < argc; i++) {
+			const char* path = argv[i] ? vcfginternal_skip_prefix(argv[i], "--set") : 0;
+			if (!path || ((*path != '\0') && (*path != '='))) continue;
+
+			if (*(path++) == '\0') {
+				if ((++i >= argc) || !argv[i]) {
+					vcfginternal_set_error(parserObj, VCFG_ERROR_INVALID_OVERRIDE);
+					return 0;
+				}
+				path = argv[i];
+			}
+
+			const char* value = path;
+			while (*value && (*value != '=')) ++value;
+			if (!(*value)) {
+				vcfginternal_set_error(parserObj, VCFG_ERROR_INVALID_OVERRIDE);
+				return 0;
+			}
+
+			if (!vcfginternal_apply_override(parserObj, path, (size_t)(value - path), ".", 0, 1, value + 1)) return 0;
+		}
+		return parserObj->m_index ? 1 : vcfg_build_index(parserObj);
+	}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_OVERRIDES_H
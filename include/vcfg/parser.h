@@ -38,20 +38,269 @@ extern "C" {
 		#include <stdio.h>
 	#endif
 
+	#if defined(VCFG_ENABLE_LOSSLESS)
+		// Origin of a key or section (combined with |)
+		typedef enum VCFGSourceFlags {
+			VCFG_SOURCE_PARSED = 1 << 0,	// Parsed from the configuration buffer, the offsets are valid
+			VCFG_SOURCE_EDITED = 1 << 1		// The value was changed after parsing
+		} VCFGSourceFlags;
+
+		// A range of the configuration buffer
+		typedef struct VCFGSpan {
+			size_t offset;
+			size_t length;
+		} VCFGSpan_t;
+	#endif
+
+	// Class of the value of a key, found by vcfg_parse and the setters (see vcfginternal_classify_bool)
+	typedef enum VCFGTypeTag {
+		VCFG_TAG_UNKNOWN = 0,	// Not classified, the getters classify the value when it's read
+		VCFG_TAG_OTHER,			// Not a boolean literal (or an empty value)
+		VCFG_TAG_FALSE,			// false, no, off or 0 in any case
+		VCFG_TAG_TRUE			// true, yes, on or 1 in any case
+	} VCFGTypeTag;
+
+	// Quantity the value of a key was converted to (see VCFG_OPTION_UNITS), in the order of the VCFG_UNIT_ kinds
+	typedef enum VCFGQuantityTag {
+		VCFG_QUANTITY_UNKNOWN = 0,	// Not converted, the getters convert the value when it's read
+		VCFG_QUANTITY_NUMBER,		// A whole number without a unit (nanoseconds or bytes)
+		VCFG_QUANTITY_DURATION,
+		VCFG_QUANTITY_SIZE,
+		VCFG_QUANTITY_NONE			// Not a duration or size
+	} VCFGQuantityTag;
+
 	typedef struct VCFGKey {
 		char* name;
 		char* value;
 		uint32_t childCount;
+		uint32_t sourceIndex;	// Position of the key in the configuration file (within its parent)
 		struct VCFGKey* children;
+		uint32_t enumCache;		// Enum the value was mapped to and its position in the names (see VCFGParser::GetEnum), 0 until then
+		uint16_t typeTag;		// VCFGTypeTag
+		uint16_t quantityTag;	// VCFGQuantityTag
+		int64_t quantity;		// The value in nanoseconds or bytes (VCFG_QUANTITY_NUMBER, _DURATION and _SIZE only)
+
+		#if defined(VCFG_ENABLE_PROFILING)
+			uint64_t accessCount;	// Number of lookups of this key (updated atomically)
+		#endif
+
+		#if defined(VCFG_ENABLE_LOSSLESS)
+			// Position of the key in the configuration buffer (see VCFG_WRITE_PRESERVE_FORMATTING)
+			size_t entryOffset;		// Start of the name (of the value for array elements)
+			size_t valueOffset;		// Start of the value (quotes and brackets included)
+			size_t valueLength;
+			uint32_t sourceFlags;	// VCFGSourceFlags
+		#endif
 	} VCFGKey_t;
 	typedef VCFGKey_t VCFG_Node;
 
 	typedef struct VCFGSection {
 		char* name;
 		uint32_t keyCount;
+		uint32_t parent;		// Position of the section it inherits the keys from, [name : parent] (0 for none, the root section can't be a parent)
 		VCFGKey_t* keys;
+
+		#if defined(VCFG_ENABLE_LOSSLESS)
+			size_t headerEnd;		// End of the [name] header in the configuration buffer (0 for the root section)
+			uint32_t sourceFlags;	// VCFGSourceFlags
+		#endif
 	} VCFGSection_t;
 
+	// Slot of the hash index (see vcfg_build_index), a hash of 0 marks an empty slot
+	typedef struct VCFGIndexEntry {
+		uint64_t hash;			// Path hash of the section or key
+		uint32_t section;		// Position of the section
+		uint32_t key;			// Position of the key in the section (VCFG_INDEX_SECTION for the section itself)
+	} VCFGIndexEntry_t;
+
+	// Number of accesses of a single key identified by the hash of its path (section, key, child key...)
+	typedef struct VCFGAccessProfileEntry {
+		uint64_t pathHash;
+		uint64_t count;
+	} VCFGAccessProfileEntry_t;
+
+	// Access counts of the keys (sorted by the path hash) used to optimize the layout of the parsed data
+	typedef struct VCFGAccessProfile {
+		VCFGAccessProfileEntry_t* entries;
+		uint32_t entryCount;
+	} VCFGAccessProfile_t;
+
+	// Reason of the last failure of vcfg_open, vcfg_parse or vcfg_write
+	typedef enum VCFGError {
+		VCFG_ERROR_NONE = 0,
+		VCFG_ERROR_IO,					// The file couldn't be opened or read
+		VCFG_ERROR_OUT_OF_MEMORY,		// An allocation failed
+		VCFG_ERROR_TOO_LARGE,			// The input and the parsed data exceed maxTotalBytes
+		VCFG_ERROR_TOO_MANY_NODES,		// More sections and keys than maxNodes
+		VCFG_ERROR_TOO_DEEP,			// Arrays and objects nested deeper than maxDepth (or VCFG_MAX_NESTING_DEPTH)
+		VCFG_ERROR_STRING_TOO_LONG,		// A name or a value longer than maxStringLength
+		VCFG_ERROR_TIMEOUT,				// Parsing took longer than timeBudgetNs
+		VCFG_ERROR_NOT_REPRESENTABLE,	// vcfg_write found a name or value that can't be written in the configuration syntax
+		VCFG_ERROR_CHECKSUM_MISMATCH,	// The checksum trailer doesn't match the file (or is missing with VCFG_OPTION_REQUIRE_CHECKSUM)
+		VCFG_ERROR_INVALID_OVERRIDE,	// An override with an empty path, a path with too many names or a --set without =
+		VCFG_ERROR_INVALID_REFERENCE,	// A ${section.key} reference to a missing key, an array or an object (or without the closing })
+		VCFG_ERROR_REFERENCE_CYCLE,		// Values that refer to each other (see vcfg_interpolate)
+		VCFG_ERROR_INVALID_SCHEMA,		// A schema rule with an unknown type or attribute, an invalid bound or a key that has a rule already
+
+		// Syntax errors (always after the errors above, parsing can continue after them)
+		VCFG_ERROR_UNEXPECTED_CHARACTER,	// A character that can't start or separate the entries
+		VCFG_ERROR_UNTERMINATED_COMMENT,	// A block comment without */
+		VCFG_ERROR_UNTERMINATED_SECTION,	// A section name without ]
+		VCFG_ERROR_EMPTY_SECTION_NAME,		// []
+		VCFG_ERROR_UNTERMINATED_STRING,		// A quoted key or value without the closing quote
+		VCFG_ERROR_EMPTY_KEY,				// A key-value pair without the key
+		VCFG_ERROR_MISSING_EQUALS,			// A key that isn't followed by =
+		VCFG_ERROR_MISSING_VALUE,			// A key-value pair without the value
+		VCFG_ERROR_UNTERMINATED_ARRAY,		// An array without ]
+		VCFG_ERROR_UNTERMINATED_OBJECT,		// An object without }
+		VCFG_ERROR_UNKNOWN_PARENT,			// [name : parent] with a parent that isn't defined before the section
+		VCFG_ERROR_INVALID_EXPRESSION,		// An expression that overflows, divides by zero or is nested too deep (see VCFG_OPTION_EXPRESSIONS)
+		VCFG_ERROR_INVALID_QUANTITY			// A duration or size that doesn't fit in 64 bits in nanoseconds or bytes (see VCFG_OPTION_UNITS)
+	} VCFGError;
+
+	// A single error found by vcfg_parse
+	typedef struct VCFGErrorRecord {
+		VCFGError kind;
+		size_t offset;		// Byte offset in the configuration buffer
+	} VCFGErrorRecord_t;
+
+	// Position in the configuration buffer (both counted from 1, the column in bytes)
+	typedef struct VCFGLocation {
+		size_t line;
+		size_t column;
+	} VCFGLocation_t;
+
+	// Destination of vcfg_write. The callback returns the number of bytes it has written,
+	// anything less than the length fails the write
+	typedef size_t (*VCFGWriteCallback)(void* userData, const char* data, size_t length);
+
+	typedef struct VCFGSink {
+		VCFGWriteCallback write;
+		void* userData;
+	} VCFGSink_t;
+
+	// Memory destination of vcfg_write (see vcfg_buffer_sink)
+	typedef struct VCFGBufferSink {
+		char* data;			// The output (not null terminated)
+		size_t length;
+		size_t capacity;
+		int growable;		// Grow the data with VCFG_REALLOC instead of failing when it's full
+	} VCFGBufferSink_t;
+
+	// Output format of vcfg_write (combined with |)
+	typedef enum VCFGWriteFlags {
+		VCFG_WRITE_PRETTY = 0,				// Indented arrays and objects with one element per line
+		VCFG_WRITE_COMPACT = 1 << 0,		// Arrays and objects on a single line without optional spaces
+		#if defined(VCFG_ENABLE_LOSSLESS)
+			VCFG_WRITE_PRESERVE_FORMATTING = 1 << 1,	// Keep the parsed text and its comments, rewrite only what was changed
+		#endif
+		VCFG_WRITE_CHECKSUM = 1 << 2		// End the output with a CRC-32C trailer (see vcfg_verify_checksum)
+	} VCFGWriteFlags;
+
+	// Parser options (combined with |)
+	typedef enum VCFGOption {
+		VCFG_OPTION_COLLECT_ALL_ERRORS = 1 << 0,	// Don't stop at the first syntax error, record all of them
+		VCFG_OPTION_REQUIRE_CHECKSUM = 1 << 1,		// Reject files without the checksum trailer (see vcfg_verify_checksum)
+		VCFG_OPTION_BUILD_INDEX = 1 << 2,			// Build the hash index of the sections and keys after parsing (see vcfg_build_index)
+		VCFG_OPTION_NESTED_SECTIONS = 1 << 3,		// Build the section tree after parsing and look up the keys a dotted section ([a.b]) doesn't have in its parents ([a])
+		VCFG_OPTION_INTERPOLATE = 1 << 4,			// Resolve the ${section.key} references in the values after parsing (see vcfg_interpolate)
+		VCFG_OPTION_EXPRESSIONS = 1 << 5,			// Fold unquoted integer expressions (4 * 1024, 1 << 20) to their result while parsing
+		VCFG_OPTION_UNITS = 1 << 6					// Convert durations (250ms) and sizes (64KiB) to nanoseconds and bytes while parsing
+	} VCFGOption;
+
+	// Result of the vcfg_try_get functions
+	typedef enum VCFGStatus {
+		VCFG_STATUS_OK = 0,
+		VCFG_STATUS_NOT_FOUND,			// The section or the key doesn't exist
+		VCFG_STATUS_INVALID_FORMAT,		// The value can't be converted to the requested type
+		VCFG_STATUS_OUT_OF_RANGE		// The number doesn't fit in the requested type
+	} VCFGStatus;
+
+	// Resource limits of a single parse, 0 means unlimited
+	typedef struct VCFGLimits {
+		uint32_t maxNodes;			// Sections, keys and nested keys
+		uint32_t maxDepth;			// Nesting of arrays and objects
+		size_t maxStringLength;		// Length of a single name or value
+		size_t maxTotalBytes;		// Size of the input plus the memory held by the parsed data
+		uint64_t timeBudgetNs;		// Time budget of vcfg_parse in nanoseconds
+	} VCFGLimits_t;
+
+	#if defined(VCFG_ENABLE_STATS)
+		// Memory used by the parsed data of a section (or of all the sections)
+		typedef struct VCFGSectionStats {
+			uint64_t nameBytes;		// Section and key names
+			uint64_t valueBytes;	// Key values
+			uint64_t nodeBytes;		// Key and section arrays
+			uint64_t nodeCount;		// Number of keys including all the nested ones
+		} VCFGSectionStats_t;
+
+		typedef struct VCFGStats {
+			// Allocation counters for everything the parser has allocated since the last clear
+			uint64_t allocCount;
+			uint64_t reallocCount;
+			uint64_t freeCount;
+			uint64_t liveBytes;
+			uint64_t peakBytes;
+
+			// Size of the raw configuration buffer (not included in the live bytes)
+			uint64_t bufferBytes;
+			uint32_t sectionCount;
+
+			// Breakdown of the live bytes summed over all the sections
+			VCFGSectionStats_t totals;
+		} VCFGStats_t;
+	#endif
+
+	#if defined(VCFG_ENABLE_TRACING)
+		// Phases of loading a configuration measured by the tracing instrumentation
+		typedef enum VCFGPhase {
+			VCFG_PHASE_IO = 0,		// Reading the file in vcfg_open
+			VCFG_PHASE_SCAN,		// Scanning the buffer in vcfg_parse (excluding the allocations)
+			VCFG_PHASE_ALLOC,		// Allocating memory for the parsed data
+			VCFG_PHASE_NUMCONV,		// Converting values to numbers
+			VCFG_PHASE_COUNT
+		} VCFGPhase;
+
+		typedef struct VCFGTimings {
+			uint64_t cycles[VCFG_PHASE_COUNT];
+			uint64_t calls[VCFG_PHASE_COUNT];
+		} VCFGTimings_t;
+
+		typedef enum VCFGTraceEvent {
+			VCFG_TRACE_OPEN_BEGIN = 0,	// name - path of the file
+			VCFG_TRACE_OPEN_END,		// name - path of the file, value - size of the file
+			VCFG_TRACE_PARSE_BEGIN,		// value - length of the buffer
+			VCFG_TRACE_SECTION,			// name - name of the section, value - index of the section
+			VCFG_TRACE_PARSE_END		// value - number of sections
+		} VCFGTraceEvent;
+
+		typedef void (*VCFGTraceCallback)(void* userData, VCFGTraceEvent event, const char* name, size_t value);
+	#endif
+
+	#if defined(VCFG_ENABLE_PROFILING)
+		// Only every n-th lookup of every thread is recorded (the counters are scaled accordingly)
+		#ifndef VCFG_PROFILE_SAMPLE_RATE
+			#define VCFG_PROFILE_SAMPLE_RATE 1
+		#endif
+
+		// Number of different missing keys that are recorded
+		#ifndef VCFG_PROFILE_MISS_SLOTS
+			#define VCFG_PROFILE_MISS_SLOTS 64
+		#endif
+
+		#ifndef VCFG_PROFILE_PATH_LENGTH
+			#define VCFG_PROFILE_PATH_LENGTH 64
+		#endif
+
+		// Lookup of a key that doesn't exist
+		typedef struct VCFGMissEntry {
+			uint64_t hash;
+			uint64_t count;
+			uint64_t ready;		// Set once the path is written (the hash claims the slot before that)
+			char path[VCFG_PROFILE_PATH_LENGTH];
+		} VCFGMissEntry_t;
+	#endif
+
 	#ifndef __cplusplus
 		typedef struct VCFGParser {
 			#if !defined(VCFG_BUFFER_ONLY)
@@ -65,6 +314,51 @@ extern "C" {
 			// The parsed data
 			VCFGSection_t* m_parsedData;
 			uint32_t m_sectionCount;
+
+			// Current depth of the nested arrays and objects while parsing
+			uint32_t m_nestingDepth;
+
+			// Resource limits and the state used to enforce them
+			VCFGLimits_t m_limits;
+			VCFGError m_lastError;
+			uint32_t m_nodeCount;
+			uint32_t m_deadlineCountdown;
+			uint64_t m_deadline;
+			size_t m_parsedBytes;
+
+			// Options and the errors found by the last parse
+			uint32_t m_options;
+			VCFGErrorRecord_t* m_errors;
+			uint32_t m_errorCount;
+
+			// Hash index of the sections and keys (NULL when the lookups compare the names)
+			VCFGIndexEntry_t* m_index;
+			uint32_t m_indexCapacity;
+			uint32_t m_indexCount;
+
+			// Positions of the sections sorted by name (NULL when the section tree isn't built)
+			uint32_t* m_sectionTree;
+
+			#if defined(VCFG_ENABLE_LOSSLESS)
+				// Text of the parsed keys that were removed (in the order of the removals)
+				VCFGSpan_t* m_removedSpans;
+				uint32_t m_removedCount;
+			#endif
+
+			#if defined(VCFG_ENABLE_STATS)
+				VCFGStats_t m_stats;
+			#endif
+
+			#if defined(VCFG_ENABLE_TRACING)
+				VCFGTimings_t m_timings;
+				VCFGTraceCallback m_traceCallback;
+				void* m_traceUserData;
+			#endif
+
+			#if defined(VCFG_ENABLE_PROFILING)
+				VCFGMissEntry_t m_missTable[VCFG_PROFILE_MISS_SLOTS];
+				uint64_t m_missOverflow;
+			#endif
 		} VCFGParser_t;
 		typedef VCFGParser_t VCFG_Parser;
 	#endif
@@ -76,6 +370,129 @@ extern "C" {
 		typedef class VCFGParser VCFG_Parser;
 	#endif
 
+	#ifndef VCFG_MAX_LAYERS
+		#define VCFG_MAX_LAYERS 8
+	#endif
+
+	// Parsed configurations looked up as one, the layer added last first (see vcfg_layers_push).
+	// The layers aren't copied or owned, they have to outlive the structure
+	typedef struct VCFGLayers {
+		VCFG_Parser* layers[VCFG_MAX_LAYERS];	// From the lowest to the highest priority
+		uint32_t layerCount;
+	} VCFGLayers_t;
+
+	// Overrides and nesting of the scopes (see vcfg_push_scope). The maximum number of overrides has to be a power of 2
+	#ifndef VCFG_MAX_SCOPE_OVERRIDES
+		#define VCFG_MAX_SCOPE_OVERRIDES 64
+	#endif
+	#ifndef VCFG_MAX_SCOPES
+		#define VCFG_MAX_SCOPES 16
+	#endif
+
+	// Slot of the override table of the scopes, a hash of 0 marks an empty slot
+	typedef struct VCFGScopeEntry {
+		uint64_t hash;				// Path hash of the key
+		const char* section;		// Name of the section (NULL for the root section)
+		VCFGKey_t key;				// Name and value of the override (neither is owned)
+	} VCFGScopeEntry_t;
+
+	// A set override that vcfg_pop_scope undoes
+	typedef struct VCFGScopeChange {
+		uint32_t slot;
+		uint32_t added;				// 1 - the slot was empty, 0 - the override replaced previousValue
+		char* previousValue;
+	} VCFGScopeChange_t;
+
+	// Overrides set in nested scopes on top of layers that aren't changed (see vcfg_scopes_init).
+	// Everything is stored in the structure, no scope operation or lookup allocates
+	typedef struct VCFGScopes {
+		const VCFGLayers_t* base;
+		VCFGScopeEntry_t table[2 * VCFG_MAX_SCOPE_OVERRIDES];
+		VCFGScopeChange_t changes[VCFG_MAX_SCOPE_OVERRIDES];		// In the order of the sets
+		uint32_t scopeStart[VCFG_MAX_SCOPES];						// First change of every scope
+		uint32_t changeCount;
+		uint32_t scopeCount;
+	} VCFGScopes_t;
+
+	// Maximum number of names in the key of a schema rule (the key and the objects it's nested in)
+	#ifndef VCFG_SCHEMA_MAX_DEPTH
+		#define VCFG_SCHEMA_MAX_DEPTH 8
+	#endif
+
+	// Flags of a schema rule (combined with |)
+	#define VCFG_SCHEMA_REQUIRED (1u << 0)
+
+	// Type of the values a schema rule accepts
+	typedef enum VCFGSchemaType {
+		VCFG_SCHEMA_STRING = 0,		// Any value that isn't an array or an object
+		VCFG_SCHEMA_INT,
+		VCFG_SCHEMA_FLOAT,			// Integers are accepted too
+		VCFG_SCHEMA_BOOL,
+		VCFG_SCHEMA_DURATION,		// A duration with a unit or in nanoseconds (see vcfg_get_duration_ns)
+		VCFG_SCHEMA_SIZE,			// A size with a unit or in bytes (see vcfg_get_bytes)
+		VCFG_SCHEMA_ENUM,			// One of the values of the rule
+		VCFG_SCHEMA_ARRAY,
+		VCFG_SCHEMA_OBJECT
+	} VCFGSchemaType;
+
+	// A single rule of a schema. It holds only constants, so the rules can be a static (or constexpr) table.
+	// The bounds are written like the values ("1", "0.5", "30s", "4KiB"), for strings they limit the length
+	// and for arrays the number of elements
+	typedef struct VCFGSchemaRule {
+		const char* section;			// Name of the section (NULL for the root section)
+		const char* key;				// Name of the key, dotted for the keys of objects ("pool.size")
+		VCFGSchemaType type;
+		uint32_t flags;
+		const char* minimum;			// NULL for no bound
+		const char* maximum;
+		const char* pattern;			// The value has to match it, * matches any characters and ? a single one (NULL for any value)
+		const char* const* values;		// NULL terminated allowed values of VCFG_SCHEMA_ENUM
+	} VCFGSchemaRule_t;
+
+	// A rule converted by vcfg_schema_compile
+	typedef struct VCFGSchemaCheck {
+		int64_t minimum;		// Integers, durations, sizes, lengths and numbers of elements
+		int64_t maximum;
+		double minimumFloat;
+		double maximumFloat;
+		char* names;			// The names of a dotted key separated by null terminators (NULL for a single name)
+		uint32_t depth;			// Number of names in the key
+	} VCFGSchemaCheck_t;
+
+	// Slot of the rule table of a schema, a hash of 0 marks an empty slot
+	typedef struct VCFGSchemaEntry {
+		uint64_t hash;			// Path hash of the key
+		uint32_t rule;			// Position of the rule
+	} VCFGSchemaEntry_t;
+
+	// Rules compiled to a hash table of their paths, so that vcfg_validate needs a single probe per key.
+	// A zeroed structure is an empty schema, vcfg_schema_free frees it
+	typedef struct VCFGSchema {
+		const VCFGSchemaRule_t* rules;		// Not owned when compiled from a table, they have to outlive the schema
+		VCFGSchemaCheck_t* checks;
+		VCFGSchemaEntry_t* table;
+		uint32_t ruleCount;
+		uint32_t tableCapacity;
+		uint32_t maxDepth;					// Most names in the key of a rule, the validation doesn't look deeper
+		void* storage;						// Rules loaded from a schema file (see vcfg_schema_load)
+	} VCFGSchema_t;
+
+	// Kind of a value that doesn't follow its schema rule
+	typedef enum VCFGViolationKind {
+		VCFG_VIOLATION_MISSING = 0,		// A required key doesn't exist
+		VCFG_VIOLATION_WRONG_TYPE,		// The value isn't of the type of the rule
+		VCFG_VIOLATION_OUT_OF_RANGE,	// A number, length or number of elements outside of the bounds
+		VCFG_VIOLATION_NO_MATCH,		// The value doesn't match the pattern
+		VCFG_VIOLATION_NOT_ALLOWED		// The value isn't one of the values of an enum
+	} VCFGViolationKind;
+
+	// A single violation found by vcfg_validate
+	typedef struct VCFGViolation {
+		VCFGViolationKind kind;
+		const VCFGSchemaRule_t* rule;
+		const VCFGKey_t* key;			// NULL for a missing key
+	} VCFGViolation_t;
+
 	#if !defined(VCFG_BUFFER_ONLY)
 		inline int vcfg_open(VCFG_Parser* parserObj, const char* s_path);
 	#endif
@@ -101,12 +518,375 @@ extern "C" {
 	inline const VCFG_Node* vcfg_get_node(VCFG_Parser* parserObj, const char* sectionName, const char* keyName);
 	inline const VCFG_Node* vcfg_get_node_from_node(VCFG_Parser* parserObj, const VCFG_Node* parentNode, const char* keyName);
 
+	inline VCFGStatus vcfg_try_get_string(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, const char** value);
+	inline VCFGStatus vcfg_try_get_string_from_node(VCFG_Parser* parserObj, const VCFG_Node* parentNode, const char* keyName, const char** value);
+
+	inline VCFGStatus vcfg_try_get_int(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, int64_t* value);
+	inline VCFGStatus vcfg_try_get_int_from_node(VCFG_Parser* parserObj, const VCFG_Node* parentNode, const char* keyName, int64_t* value);
+
+	inline VCFGStatus vcfg_try_get_float(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, double* value);
+	inline VCFGStatus vcfg_try_get_float_from_node(VCFG_Parser* parserObj, const VCFG_Node* parentNode, const char* keyName, double* value);
+
+	inline VCFGStatus vcfg_try_get_bool(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, int* value);
+	inline VCFGStatus vcfg_try_get_bool_from_node(VCFG_Parser* parserObj, const VCFG_Node* parentNode, const char* keyName, int* value);
+
+	inline int64_t vcfg_get_duration_ns(VCFG_Parser* parserObj, const char* sectionName, const char* keyName);
+	inline int64_t vcfg_get_bytes(VCFG_Parser* parserObj, const char* sectionName, const char* keyName);
+	inline VCFGStatus vcfg_try_get_duration_ns(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, int64_t* value);
+	inline VCFGStatus vcfg_try_get_bytes(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, int64_t* value);
+	inline const char* vcfg_status_string(VCFGStatus status);
+
+	inline VCFGSection_t* vcfg_add_section(VCFG_Parser* parserObj, const char* sectionName);
+
+	inline int vcfg_set_string(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, const char* value);
+	inline int vcfg_set_string_in_node(VCFG_Parser* parserObj, VCFG_Node* parentNode, const char* keyName, const char* value);
+
+	inline int vcfg_set_int(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, int64_t value);
+	inline int vcfg_set_int_in_node(VCFG_Parser* parserObj, VCFG_Node* parentNode, const char* keyName, int64_t value);
+
+	inline int vcfg_set_float(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, double value);
+	inline int vcfg_set_float_in_node(VCFG_Parser* parserObj, VCFG_Node* parentNode, const char* keyName, double value);
+
+	inline int vcfg_set_bool(VCFG_Parser* parserObj, const char* sectionName, const char* keyName, int value);
+	inline int vcfg_set_bool_in_node(VCFG_Parser* parserObj, VCFG_Node* parentNode, const char* keyName, int value);
+
+	inline VCFG_Node* vcfg_set_array(VCFG_Parser* parserObj, const char* sectionName, const char* keyName);
+	inline VCFG_Node* vcfg_set_array_in_node(VCFG_Parser* parserObj, VCFG_Node* parentNode, const char* keyName);
+
+	inline VCFG_Node* vcfg_set_object(VCFG_Parser* parserObj, const char* sectionName, const char* keyName);
+	inline VCFG_Node* vcfg_set_object_in_node(VCFG_Parser* parserObj, VCFG_Node* parentNode, const char* keyName);
+
+	inline VCFG_Node* vcfg_insert_value(VCFG_Parser* parserObj, VCFG_Node* arrayNode, uint32_t index, const char* value);
+	inline VCFG_Node* vcfg_append_value(VCFG_Parser* parserObj, VCFG_Node* arrayNode, const char* value);
+
+	inline int vcfg_remove_key(VCFG_Parser* parserObj, const char* sectionName, const char* keyName);
+	inline int vcfg_remove_key_from_node(VCFG_Parser* parserObj, VCFG_Node* parentNode, const char* keyName);
+
+	inline int vcfg_write(VCFG_Parser* parserObj, const VCFGSink_t* sink, uint32_t flags);
+	inline VCFGSink_t vcfg_buffer_sink(VCFGBufferSink_t* buffer);
+	#if !defined(VCFG_BUFFER_ONLY)
+		inline VCFGSink_t vcfg_file_sink(FILE* file);
+		inline VCFGSink_t vcfg_fd_sink(int fd);
+		inline int vcfg_write_file(VCFG_Parser* parserObj, const char* path, uint32_t flags);
+		inline int vcfg_write_file_atomic(VCFG_Parser* parserObj, const char* path, uint32_t flags);
+	#endif
+	inline uint32_t vcfg_crc32c(const char* data, size_t length);
+	inline int vcfg_verify_checksum(VCFG_Parser* parserObj);
+
+	inline VCFGError vcfg_get_last_error(VCFG_Parser* parserObj);
+	inline const char* vcfg_error_string(VCFGError error);
+	inline void vcfg_set_limits(VCFG_Parser* parserObj, const VCFGLimits_t* limits);
+	inline void vcfg_set_options(VCFG_Parser* parserObj, uint32_t options);
+	inline uint32_t vcfg_get_error_count(VCFG_Parser* parserObj);
+	inline const VCFGErrorRecord_t* vcfg_get_error(VCFG_Parser* parserObj, uint32_t index);
+	inline int vcfg_get_location(VCFG_Parser* parserObj, size_t offset, VCFGLocation_t* location);
+
+	inline int vcfg_optimize_layout(VCFG_Parser* parserObj, const VCFGAccessProfile_t* profile);
+	inline int vcfg_restore_source_order(VCFG_Parser* parserObj);
+	inline void vcfg_get_source_order(const VCFGKey_t* keys, uint32_t keyCount, uint32_t* order);
+	inline void vcfg_free_access_profile(VCFGAccessProfile_t* profile);
+	inline int vcfg_build_index(VCFG_Parser* parserObj);
+	inline int vcfg_build_section_tree(VCFG_Parser* parserObj);
+	inline uint32_t vcfg_get_subsections(VCFG_Parser* parserObj, const char* sectionName, const uint32_t** sections);
+	inline VCFGSection_t* vcfg_get_nearest_section(VCFG_Parser* parserObj, const char* sectionName, const char* keyName);
+	inline int vcfg_interpolate(VCFG_Parser* parserObj);
+
+	inline int vcfg_layers_push(VCFGLayers_t* layers, VCFG_Parser* parserObj);
+	inline const VCFG_Node* vcfg_layers_get_node(const VCFGLayers_t* layers, const char* sectionName, const char* keyName);
+	inline const char* vcfg_layers_get_string(const VCFGLayers_t* layers, const char* sectionName, const char* keyName);
+	inline int64_t vcfg_layers_get_int(const VCFGLayers_t* layers, const char* sectionName, const char* keyName);
+	inline double vcfg_layers_get_float(const VCFGLayers_t* layers, const char* sectionName, const char* keyName);
+	inline int vcfg_layers_get_bool(const VCFGLayers_t* layers, const char* sectionName, const char* keyName);
+	inline VCFGStatus vcfg_layers_try_get_string(const VCFGLayers_t* layers, const char* sectionName, const char* keyName, const char** value);
+	inline VCFGStatus vcfg_layers_try_get_int(const VCFGLayers_t* layers, const char* sectionName, const char* keyName, int64_t* value);
+	inline VCFGStatus vcfg_layers_try_get_float(const VCFGLayers_t* layers, const char* sectionName, const char* keyName, double* value);
+	inline VCFGStatus vcfg_layers_try_get_bool(const VCFGLayers_t* layers, const char* sectionName, const char* keyName, int* value);
+	inline VCFG_Parser* vcfg_layers_get_owner(const VCFGLayers_t* layers, const char* sectionName, const char* keyName);
+	inline int vcfg_layers_flatten(const VCFGLayers_t* layers, VCFG_Parser* parserObj);
+	inline void vcfg_scopes_init(VCFGScopes_t* scopes, const VCFGLayers_t* base);
+	inline int vcfg_push_scope(VCFGScopes_t* scopes);
+	inline int vcfg_pop_scope(VCFGScopes_t* scopes);
+	inline int vcfg_scope_set(VCFGScopes_t* scopes, const char* sectionName, const char* keyName, const char* value);
+	inline const VCFG_Node* vcfg_scope_get_node(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName);
+	inline const char* vcfg_scope_get_string(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName);
+	inline int64_t vcfg_scope_get_int(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName);
+	inline double vcfg_scope_get_float(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName);
+	inline int vcfg_scope_get_bool(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName);
+	inline VCFGStatus vcfg_scope_try_get_string(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName, const char** value);
+	inline VCFGStatus vcfg_scope_try_get_int(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName, int64_t* value);
+	inline VCFGStatus vcfg_scope_try_get_float(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName, double* value);
+	inline VCFGStatus vcfg_scope_try_get_bool(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName, int* value);
+	inline int vcfg_load_environment(VCFG_Parser* parserObj, const char* prefix, char** environment);
+	inline int vcfg_load_arguments(VCFG_Parser* parserObj, int argc, char** argv);
+	inline int vcfg_schema_compile(VCFGSchema_t* schema, const VCFGSchemaRule_t* rules, uint32_t ruleCount);
+	inline int vcfg_schema_load(VCFGSchema_t* schema, VCFG_Parser* schemaParser);
+	inline void vcfg_schema_free(VCFGSchema_t* schema);
+	inline uint32_t vcfg_validate(VCFG_Parser* parserObj, const VCFGSchema_t* schema, VCFGViolation_t* violations, uint32_t maxViolations);
+	inline const char* vcfg_violation_string(VCFGViolationKind kind);
+
+	#if defined(VCFG_ENABLE_STATS)
+		inline int vcfg_get_stats(VCFG_Parser* parserObj, VCFGStats_t* stats);
+		inline int vcfg_get_section_stats(VCFG_Parser* parserObj, const char* sectionName, VCFGSectionStats_t* stats);
+	#endif
+
+	#if defined(VCFG_ENABLE_TRACING)
+		inline void vcfg_set_trace_callback(VCFG_Parser* parserObj, VCFGTraceCallback callback, void* userData);
+		inline int vcfg_get_timings(VCFG_Parser* parserObj, VCFGTimings_t* timings);
+		inline void vcfg_reset_timings(VCFG_Parser* parserObj);
+	#endif
+
+	#if defined(VCFG_ENABLE_PROFILING)
+		inline void vcfg_reset_access_profile(VCFG_Parser* parserObj);
+		inline int vcfg_capture_access_profile(VCFG_Parser* parserObj, VCFGAccessProfile_t* profile);
+		#if !defined(VCFG_BUFFER_ONLY)
+			inline int vcfg_dump_access_profile(VCFG_Parser* parserObj, FILE* out, uint64_t hotThreshold);
+		#endif
+	#endif
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
 
 // The C++ wrapper for the C functions
 #ifdef __cplusplus
+	#if __has_include(<version>)
+		#include <version>
+	#endif
+	#if defined(__cpp_lib_expected)
+		#include <expected>
+	#endif
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#endif
+
+	namespace vcfg {
+		// Reason why a value couldn't be read (the same values as VCFGStatus)
+		enum class error {
+			not_found = VCFG_STATUS_NOT_FOUND,
+			invalid_format = VCFG_STATUS_INVALID_FORMAT,
+			out_of_range = VCFG_STATUS_OUT_OF_RANGE
+		};
+
+		#if defined(__cpp_lib_expected)
+			template <typename T>
+			using expected = std::expected<T, ::vcfg::error>;
+			using unexpected = std::unexpected<::vcfg::error>;
+		#else
+			// Subset of std::unexpected<vcfg::error> for the standard libraries without <expected>
+			class unexpected {
+				public:
+					explicit unexpected(::vcfg::error error) : m_error(error) {}
+					::vcfg::error error() const { return m_error; }
+
+				private:
+					::vcfg::error m_error;
+			};
+
+			// Subset of std::expected<T, vcfg::error> for the standard libraries without <expected>.
+			// The library doesn't throw, so value() of an error returns a value initialized T
+			template <typename T>
+			class expected {
+				public:
+					expected(const T& value) : m_value(value), m_error(), m_hasValue(true) {}
+					expected(const ::vcfg::unexpected& error) : m_value(), m_error(error.error()), m_hasValue(false) {}
+
+					bool has_value() const { return m_hasValue; }
+					explicit operator bool() const { return m_hasValue; }
+
+					const T& value() const { return m_value; }
+					const T& operator*() const { return m_value; }
+					const T* operator->() const { return &m_value; }
+					::vcfg::error error() const { return m_error; }
+
+					template <typename U>
+					T value_or(U&& defaultValue) const { return m_hasValue ? m_value : static_cast<T>(defaultValue); }
+
+				private:
+					T m_value;
+					::vcfg::error m_error;
+					bool m_hasValue;
+			};
+		#endif
+
+		// Name of an enumerator in the table of vcfg::enum_names<E>
+		template <typename E>
+		struct enum_name {
+			const char* name;
+			E value;
+		};
+
+		// Names of an enum read with VCFGParser::GetEnum, specialized by the application:
+		//	template <> struct vcfg::enum_names<LogLevel> {
+		//		static constexpr vcfg::enum_name<LogLevel> names[] = { { "debug", LogLevel::Debug }, { "warn", LogLevel::Warn } };
+		//	};
+		template <typename E>
+		struct enum_names;
+
+		namespace detail {
+			// The enum cache of a node holds the id of the enum above the position of the value in its names plus one
+			constexpr uint32_t enum_position_bits = 12;
+			constexpr uint32_t enum_no_match = (1u << enum_position_bits) - 1;
+			constexpr uint32_t enum_max_id = (1u << (32 - enum_position_bits)) - 1;
+
+			/**
+			 *	@brief Give an enum the next id (once, on its first read).
+			 *
+			 *	@returns (uint32_t) the id or 0 when every id is taken (the reads of the enum aren't cached then)
+			 */
+			inline uint32_t enum_next_id() {
+				static volatile long lastId = 0;
+			#if defined(_MSC_VER)
+				uint32_t id = (uint32_t)_InterlockedIncrement(&lastId);
+			#else
+				uint32_t id = (uint32_t)__atomic_add_fetch(&lastId, 1, __ATOMIC_RELAXED);
+			#endif
+				return (id <= enum_max_id) ? id : 0;
+			}
+
+			constexpr uint64_t enum_hash(const char* name) {
+				uint64_t hash = 0xcbf29ce484222325ull;
+				while (*name) hash = (hash ^ (uint8_t)*(name++)) * 0x100000001b3ull;
+				return hash;
+			}
+
+			constexpr uint64_t enum_mix(uint64_t hash, uint64_t seed) {
+				hash ^= seed * 0x9e3779b97f4a7c15ull;
+				hash = (hash ^ (hash >> 33)) * 0xff51afd7ed558ccdull;
+				return hash ^ (hash >> 33);
+			}
+
+			constexpr bool enum_equal(const char* a, const char* b) {
+				while (*a && (*a == *b)) { ++a; ++b; }
+				return *a == *b;
+			}
+
+			constexpr size_t enum_power_of_two(size_t minimum) {
+				size_t size = 1;
+				while (size < minimum) size <<= 1;
+				return size;
+			}
+
+			// Perfect hash of N names (hash and displace): the low bits of the mixed hash pick a bucket and the
+			// displacement of the bucket moves its names to free slots, so every name has a slot of its own
+			template <size_t N>
+			struct enum_table {
+				static constexpr size_t bucket_count = enum_power_of_two(N);
+				static constexpr size_t slot_count = enum_power_of_two(2 * N);
+
+				uint64_t seed = 0;
+				bool valid = false;
+				uint16_t displacement[bucket_count] = {};
+				uint16_t slots[slot_count] = {};	// Position of the name plus one, 0 for an empty slot
+
+				static constexpr size_t slot(uint64_t mixed, uint32_t displacement) {
+					return (size_t)((uint32_t)(mixed >> 32) + displacement * ((uint32_t)(mixed >> 16) | 1u)) & (slot_count - 1);
+				}
+			};
+
+			/**
+			 *	@brief Build the perfect hash of the names of an enum at compile time.
+			 *
+			 *	The buckets are placed from the largest one, every seed that leaves a bucket without a displacement
+			 *	is replaced by the next one. The table isn't valid when a name is repeated
+			 */
+			template <typename E, size_t N>
+			constexpr enum_table<N> make_enum_table(const enum_name<E> (&names)[N]) {
+				using table_t = enum_table<N>;
+				table_t table = {};
+				uint64_t hashes[N] = {};
+				for (size_t i = 0; i < N; i++) {
+					for (size_t k = 0; k < i; k++) {
+						if (enum_equal(names[i].name, names[k].name)) return table;
+					}
+					hashes[i] = enum_hash(names[i].name);
+				}
+
+				for (uint64_t seed = 1; (seed <= 256) && !table.valid; seed++) {
+					table = table_t{};
+					table.seed = seed;
+
+					uint64_t mixed[N] = {};
+					size_t bucketSizes[table_t::bucket_count] = {};
+					for (size_t i = 0; i < N; i++) {
+						mixed[i] = enum_mix(hashes[i], seed);
+						++bucketSizes[mixed[i] & (table_t::bucket_count - 1)];
+					}
+
+					bool placed = true;
+					for (size_t size = N; placed && size; size--) {
+						for (size_t bucket = 0; placed && (bucket < table_t::bucket_count); bucket++) {
+							if (bucketSizes[bucket] != size) continue;
+
+							// With an odd step every single name finds a free slot, larger buckets may need another seed
+							placed = false;
+							for (uint32_t displacement = 0; !placed && (displacement < table_t::slot_count); displacement++) {
+								size_t taken = 0;
+								for (size_t i = 0; i < N; i++) {
+									if ((mixed[i] & (table_t::bucket_count - 1)) != bucket) continue;
+									size_t slot = table_t::slot(mixed[i], displacement);
+									if (table.slots[slot]) break;
+									table.slots[slot] = (uint16_t)(i + 1);
+									++taken;
+								}
+
+								placed = (taken == size);
+								for (size_t i = 0; !placed && (i < table_t::slot_count); i++) {
+									if (table.slots[i] && ((mixed[table.slots[i] - 1] & (table_t::bucket_count - 1)) == bucket)) table.slots[i] = 0;
+								}
+								if (placed) table.displacement[bucket] = (uint16_t)displacement;
+							}
+						}
+					}
+					table.valid = placed;
+				}
+				return table;
+			}
+
+			template <typename E>
+			struct enum_lookup {
+				static constexpr size_t count = sizeof(enum_names<E>::names) / sizeof(enum_names<E>::names[0]);
+				static_assert(count < enum_no_match, "vcfg::enum_names has too many names");
+
+				static constexpr enum_table<count> table = make_enum_table(enum_names<E>::names);
+				static_assert(table.valid, "vcfg::enum_names has to have unique names");
+
+				// Ids are unique among the enums of the program, so a cache with the id of the enum is always its own
+				static uint32_t id() {
+					static const uint32_t value = enum_next_id();
+					return value;
+				}
+
+				/**
+				 *	@brief Find a name with a single probe of the perfect hash.
+				 *
+				 *	@returns (uint32_t) the position of the name plus one or enum_no_match
+				 */
+				static uint32_t find(const char* value) {
+					uint64_t mixed = enum_mix(enum_hash(value), table.seed);
+					uint32_t position = table.slots[table.slot(mixed, table.displacement[mixed & (table.bucket_count - 1)])];
+					return (position && enum_equal(enum_names<E>::names[position - 1].name, value)) ? position : enum_no_match;
+				}
+			};
+
+			// The cache is filled by the first read of a node, readers on other threads may fill it at the same time
+			inline uint32_t enum_cache_load(const VCFG_Node* node) {
+			#if defined(_MSC_VER)
+				return *(const volatile uint32_t*)&(node->enumCache);
+			#else
+				return __atomic_load_n(&(node->enumCache), __ATOMIC_RELAXED);
+			#endif
+			}
+
+			inline void enum_cache_store(const VCFG_Node* node, uint32_t cache) {
+			#if defined(_MSC_VER)
+				*(volatile uint32_t*)&(node->enumCache) = cache;
+			#else
+				__atomic_store_n((uint32_t*)&(node->enumCache), cache, __ATOMIC_RELAXED);
+			#endif
+			}
+		}
+	}
+
 	class VCFGParser {
 		// TODO:
 		//   Change those variables to private ones
@@ -123,6 +903,50 @@ extern "C" {
 			VCFGSection_t* m_parsedData = nullptr;
 			uint32_t m_sectionCount = 0;
 
+			// Current depth of the nested arrays and objects while parsing
+			uint32_t m_nestingDepth = 0;
+
+			// Resource limits and the state used to enforce them
+			VCFGLimits_t m_limits = {};
+			VCFGError m_lastError = VCFG_ERROR_NONE;
+			uint32_t m_nodeCount = 0;
+			uint32_t m_deadlineCountdown = 0;
+			uint64_t m_deadline = 0;
+			size_t m_parsedBytes = 0;
+
+			// Options and the errors found by the last parse
+			uint32_t m_options = 0;
+			VCFGErrorRecord_t* m_errors = nullptr;
+			uint32_t m_errorCount = 0;
+
+			// Hash index of the sections and keys (NULL when the lookups compare the names)
+			VCFGIndexEntry_t* m_index = nullptr;
+			uint32_t m_indexCapacity = 0;
+			uint32_t m_indexCount = 0;
+
+			// Positions of the sections sorted by name (NULL when the section tree isn't built)
+			uint32_t* m_sectionTree = nullptr;
+
+			#if defined(VCFG_ENABLE_LOSSLESS)
+				VCFGSpan_t* m_removedSpans = nullptr;
+				uint32_t m_removedCount = 0;
+			#endif
+
+			#if defined(VCFG_ENABLE_STATS)
+				VCFGStats_t m_stats = {};
+			#endif
+
+			#if defined(VCFG_ENABLE_TRACING)
+				VCFGTimings_t m_timings = {};
+				VCFGTraceCallback m_traceCallback = nullptr;
+				void* m_traceUserData = nullptr;
+			#endif
+
+			#if defined(VCFG_ENABLE_PROFILING)
+				VCFGMissEntry_t m_missTable[VCFG_PROFILE_MISS_SLOTS] = {};
+				uint64_t m_missOverflow = 0;
+			#endif
+
 		public:
 			VCFGParser() {}
 			~VCFGParser() { vcfg_clear(this); }
@@ -167,6 +991,77 @@ extern "C" {
 			 */
 			int Parse() { return vcfg_parse(this); }
 
+			/**
+			 *	@brief Write the configuration.
+			 *
+			 *	Serializes the parsed data (the root section first) to the sink
+			 *
+			 *	@param sink / path - the destination / the file to create
+			 *	@param flags - VCFGWriteFlags combined with |
+			 *
+			 *	@returns 0 - Failure (see GetLastError), 1 - Success
+			 */
+			int Write(const VCFGSink_t& sink, uint32_t flags = VCFG_WRITE_PRETTY) { return vcfg_write(this, &sink, flags); }
+			#if !defined(VCFG_BUFFER_ONLY)
+				int WriteFile(const char* path, uint32_t flags = VCFG_WRITE_PRETTY) { return vcfg_write_file(this, path, flags); }
+				int WriteFileAtomic(const char* path, uint32_t flags = VCFG_WRITE_PRETTY) { return vcfg_write_file_atomic(this, path, flags); }
+			#endif
+
+			/**
+			 *	@brief Verify the checksum of the buffer.
+			 *
+			 *	Open does it before parsing, buffers set with SetBuffer have to be verified before Parse
+			 *
+			 *	@returns 0 - Failure (VCFG_ERROR_CHECKSUM_MISMATCH), 1 - Success
+			 */
+			int VerifyChecksum() { return vcfg_verify_checksum(this); }
+
+			/**
+			 *	@brief Set resource limits.
+			 *
+			 *	Limits the work and memory of the following parses
+			 *
+			 *	@param limits - the limits (0 members are unlimited)
+			 */
+			void SetLimits(const VCFGLimits_t& limits) { vcfg_set_limits(this, &limits); }
+
+			/**
+			 *	@brief Get the last error.
+			 *
+			 *	@returns (VCFGError) - the reason of the last failure of Open or Parse
+			 */
+			VCFGError GetLastError() { return vcfg_get_last_error(this); }
+
+			/**
+			 *	@brief Set parser options.
+			 *
+			 *	@param options - VCFGOption flags combined with |
+			 */
+			void SetOptions(uint32_t options) { vcfg_set_options(this, options); }
+
+			/**
+			 *	@brief Get the errors found by the last parse.
+			 *
+			 *	@param index - index of the error (in the order they were found)
+			 *
+			 *	@returns (const VCFGErrorRecord_t*) - the error or nullptr if the index is out of range
+			 */
+			uint32_t GetErrorCount() { return vcfg_get_error_count(this); }
+			const VCFGErrorRecord_t* GetError(uint32_t index) { return vcfg_get_error(this, index); }
+
+			/**
+			 *	@brief Get the line and column of a byte offset.
+			 *
+			 *	@param offset - offset in the configuration buffer (e.g. VCFGErrorRecord_t::offset)
+			 *
+			 *	@returns (VCFGLocation_t) - the location ({ 0, 0 } if the offset is out of range)
+			 */
+			VCFGLocation_t GetLocation(size_t offset) {
+				VCFGLocation_t location = {};
+				vcfg_get_location(this, offset, &location);
+				return location;
+			}
+
 			/**
 			 *	@brief Read string from configuration.
 			 * 
@@ -237,6 +1132,408 @@ extern "C" {
 			const VCFG_Node* GetNode(const char* sectionName, const char* keyName) { return vcfg_get_node(this, sectionName, keyName); }
 			const VCFG_Node* GetNode(const VCFG_Node* parentNode, const char* keyName) { return vcfg_get_node_from_node(this, parentNode, keyName); }
 
+			/**
+			 *	@brief Read value from configuration with a single lookup.
+			 *
+			 *	Unlike the Get functions these tell a missing key from a value that isn't valid
+			 *	(e.g. "12abc" or a number that doesn't fit in 64 bits) and from a legitimate -1 or false
+			 *
+			 *	@param sectionName / parentNode - the name of the section containing the key / the node holding the key
+			 *	@param keyName - name of the key
+			 *
+			 *	@returns (vcfg::expected<T>) - the value or the reason why it couldn't be read
+			 */
+			vcfg::expected<const char*> TryGetString(const char* keyName) { const char* value = nullptr; return MakeExpected(vcfg_try_get_string(this, nullptr, keyName, &value), value); }
+			vcfg::expected<const char*> TryGetString(const char* sectionName, const char* keyName) { const char* value = nullptr; return MakeExpected(vcfg_try_get_string(this, sectionName, keyName, &value), value); }
+			vcfg::expected<const char*> TryGetString(const VCFG_Node* parentNode, const char* keyName) { const char* value = nullptr; return MakeExpected(vcfg_try_get_string_from_node(this, parentNode, keyName, &value), value); }
+
+			vcfg::expected<int64_t> TryGetInt(const char* keyName) { int64_t value = 0; return MakeExpected(vcfg_try_get_int(this, nullptr, keyName, &value), value); }
+			vcfg::expected<int64_t> TryGetInt(const char* sectionName, const char* keyName) { int64_t value = 0; return MakeExpected(vcfg_try_get_int(this, sectionName, keyName, &value), value); }
+			vcfg::expected<int64_t> TryGetInt(const VCFG_Node* parentNode, const char* keyName) { int64_t value = 0; return MakeExpected(vcfg_try_get_int_from_node(this, parentNode, keyName, &value), value); }
+
+			vcfg::expected<double> TryGetFloat(const char* keyName) { double value = 0; return MakeExpected(vcfg_try_get_float(this, nullptr, keyName, &value), value); }
+			vcfg::expected<double> TryGetFloat(const char* sectionName, const char* keyName) { double value = 0; return MakeExpected(vcfg_try_get_float(this, sectionName, keyName, &value), value); }
+			vcfg::expected<double> TryGetFloat(const VCFG_Node* parentNode, const char* keyName) { double value = 0; return MakeExpected(vcfg_try_get_float_from_node(this, parentNode, keyName, &value), value); }
+
+			vcfg::expected<bool> TryGetBool(const char* keyName) { int value = 0; return MakeExpected(vcfg_try_get_bool(this, nullptr, keyName, &value), value != 0); }
+			vcfg::expected<bool> TryGetBool(const char* sectionName, const char* keyName) { int value = 0; return MakeExpected(vcfg_try_get_bool(this, sectionName, keyName, &value), value != 0); }
+			vcfg::expected<bool> TryGetBool(const VCFG_Node* parentNode, const char* keyName) { int value = 0; return MakeExpected(vcfg_try_get_bool_from_node(this, parentNode, keyName, &value), value != 0); }
+
+			/**
+			 *	@brief Read value from configuration or use a default.
+			 *
+			 *	Returns the default value when the key doesn't exist or its value isn't valid
+			 *
+			 *	@param sectionName / parentNode - the name of the section containing the key / the node holding the key
+			 *	@param keyName - name of the key
+			 *	@param defaultValue - the value to return when the key can't be read
+			 *
+			 *	@returns (T) - the value associated with the key or the default value
+			 */
+			const char* GetStringOr(const char* keyName, const char* defaultValue) { return TryGetString(keyName).value_or(defaultValue); }
+			const char* GetStringOr(const char* sectionName, const char* keyName, const char* defaultValue) { return TryGetString(sectionName, keyName).value_or(defaultValue); }
+			const char* GetStringOr(const VCFG_Node* parentNode, const char* keyName, const char* defaultValue) { return TryGetString(parentNode, keyName).value_or(defaultValue); }
+
+			int64_t GetIntOr(const char* keyName, int64_t defaultValue) { return TryGetInt(keyName).value_or(defaultValue); }
+			int64_t GetIntOr(const char* sectionName, const char* keyName, int64_t defaultValue) { return TryGetInt(sectionName, keyName).value_or(defaultValue); }
+			int64_t GetIntOr(const VCFG_Node* parentNode, const char* keyName, int64_t defaultValue) { return TryGetInt(parentNode, keyName).value_or(defaultValue); }
+
+			double GetFloatOr(const char* keyName, double defaultValue) { return TryGetFloat(keyName).value_or(defaultValue); }
+			double GetFloatOr(const char* sectionName, const char* keyName, double defaultValue) { return TryGetFloat(sectionName, keyName).value_or(defaultValue); }
+			double GetFloatOr(const VCFG_Node* parentNode, const char* keyName, double defaultValue) { return TryGetFloat(parentNode, keyName).value_or(defaultValue); }
+
+			bool GetBoolOr(const char* keyName, bool defaultValue) { return TryGetBool(keyName).value_or(defaultValue); }
+			bool GetBoolOr(const char* sectionName, const char* keyName, bool defaultValue) { return TryGetBool(sectionName, keyName).value_or(defaultValue); }
+			bool GetBoolOr(const VCFG_Node* parentNode, const char* keyName, bool defaultValue) { return TryGetBool(parentNode, keyName).value_or(defaultValue); }
+
+			/**
+			 *	@brief Read duration or size from configuration.
+			 *
+			 *	Returns the duration in nanoseconds or the size in bytes of a value with a unit (250ms, 64KiB)
+			 *
+			 *	@param sectionName - the name of the section containing the key
+			 *	@param keyName - name of the key
+			 *
+			 *	@returns (int64_t) - the duration or size (-1 when the key doesn't exist or its value isn't valid)
+			 */
+			int64_t GetDurationNs(const char* keyName) { return vcfg_get_duration_ns(this, nullptr, keyName); }
+			int64_t GetDurationNs(const char* sectionName, const char* keyName) { return vcfg_get_duration_ns(this, sectionName, keyName); }
+			int64_t GetBytes(const char* keyName) { return vcfg_get_bytes(this, nullptr, keyName); }
+			int64_t GetBytes(const char* sectionName, const char* keyName) { return vcfg_get_bytes(this, sectionName, keyName); }
+
+			vcfg::expected<int64_t> TryGetDurationNs(const char* keyName) { int64_t value = 0; return MakeExpected(vcfg_try_get_duration_ns(this, nullptr, keyName, &value), value); }
+			vcfg::expected<int64_t> TryGetDurationNs(const char* sectionName, const char* keyName) { int64_t value = 0; return MakeExpected(vcfg_try_get_duration_ns(this, sectionName, keyName, &value), value); }
+			vcfg::expected<int64_t> TryGetBytes(const char* keyName) { int64_t value = 0; return MakeExpected(vcfg_try_get_bytes(this, nullptr, keyName, &value), value); }
+			vcfg::expected<int64_t> TryGetBytes(const char* sectionName, const char* keyName) { int64_t value = 0; return MakeExpected(vcfg_try_get_bytes(this, sectionName, keyName, &value), value); }
+
+			/**
+			 *	@brief Read enum from configuration.
+			 *
+			 *	Maps the value to an enumerator of vcfg::enum_names<E> through a perfect hash built at compile time.
+			 *	The result (also a value that isn't one of the names) is cached in the node, so the following reads
+			 *	of the key only load it (until the value changes).
+			 *	The names are case sensitive
+			 *
+			 *	@param sectionName / parentNode - the name of the section containing the key / the node holding the key
+			 *	@param keyName - name of the key
+			 *	@param defaultValue - the value to return when the key can't be read
+			 *
+			 *	@returns (E) - the enumerator (value initialized or the default value when the key doesn't exist or isn't one of the names)
+			 */
+			template <typename E> E GetEnum(const char* keyName) { return TryGetEnum<E>(keyName).value_or(E()); }
+			template <typename E> E GetEnum(const char* sectionName, const char* keyName) { return TryGetEnum<E>(sectionName, keyName).value_or(E()); }
+			template <typename E> E GetEnum(const VCFG_Node* parentNode, const char* keyName) { return TryGetEnum<E>(parentNode, keyName).value_or(E()); }
+
+			template <typename E> vcfg::expected<E> TryGetEnum(const char* keyName) { E value = E(); return MakeExpected(NodeToEnum(vcfg_get_node(this, nullptr, keyName), &value), value); }
+			template <typename E> vcfg::expected<E> TryGetEnum(const char* sectionName, const char* keyName) { E value = E(); return MakeExpected(NodeToEnum(vcfg_get_node(this, sectionName, keyName), &value), value); }
+			template <typename E> vcfg::expected<E> TryGetEnum(const VCFG_Node* parentNode, const char* keyName) { E value = E(); return MakeExpected(NodeToEnum(vcfg_get_node_from_node(this, parentNode, keyName), &value), value); }
+
+			template <typename E> E GetEnumOr(const char* keyName, E defaultValue) { return TryGetEnum<E>(keyName).value_or(defaultValue); }
+			template <typename E> E GetEnumOr(const char* sectionName, const char* keyName, E defaultValue) { return TryGetEnum<E>(sectionName, keyName).value_or(defaultValue); }
+			template <typename E> E GetEnumOr(const VCFG_Node* parentNode, const char* keyName, E defaultValue) { return TryGetEnum<E>(parentNode, keyName).value_or(defaultValue); }
+
+			/**
+			 *	@brief Add a section.
+			 *
+			 *	Returns the section, creating it when it doesn't exist.
+			 *	WARNING: all the section and node pointers obtained before the call are invalidated when a section is created!
+			 *
+			 *	@param sectionName - name of the section (nullptr for the root section)
+			 *
+			 *	@returns (VCFGSection_t*) - the section or nullptr on failure (see GetLastError)
+			 */
+			VCFGSection_t* AddSection(const char* sectionName) { return vcfg_add_section(this, sectionName); }
+
+			/**
+			 *	@brief Set a value.
+			 *
+			 *	Replaces the value of the key, creating the section and the key when they don't exist
+			 *	(new keys can only be added to sections and objects, array elements are named after their index)
+			 *
+			 *	@param sectionName / parentNode - the name of the section containing the key / the object or array holding the key
+			 *	@param keyName - name of the key
+			 *	@param value - the new value
+			 *
+			 *	@returns 0 - Failure (see GetLastError), 1 - Success
+			 */
+			int SetString(const char* keyName, const char* value) { return vcfg_set_string(this, nullptr, keyName, value); }
+			int SetString(const char* sectionName, const char* keyName, const char* value) { return vcfg_set_string(this, sectionName, keyName, value); }
+			int SetString(VCFG_Node* parentNode, const char* keyName, const char* value) { return vcfg_set_string_in_node(this, parentNode, keyName, value); }
+
+			int SetInt(const char* keyName, int64_t value) { return vcfg_set_int(this, nullptr, keyName, value); }
+			int SetInt(const char* sectionName, const char* keyName, int64_t value) { return vcfg_set_int(this, sectionName, keyName, value); }
+			int SetInt(VCFG_Node* parentNode, const char* keyName, int64_t value) { return vcfg_set_int_in_node(this, parentNode, keyName, value); }
+
+			int SetFloat(const char* keyName, double value) { return vcfg_set_float(this, nullptr, keyName, value); }
+			int SetFloat(const char* sectionName, const char* keyName, double value) { return vcfg_set_float(this, sectionName, keyName, value); }
+			int SetFloat(VCFG_Node* parentNode, const char* keyName, double value) { return vcfg_set_float_in_node(this, parentNode, keyName, value); }
+
+			int SetBool(const char* keyName, bool value) { return vcfg_set_bool(this, nullptr, keyName, value); }
+			int SetBool(const char* sectionName, const char* keyName, bool value) { return vcfg_set_bool(this, sectionName, keyName, value); }
+			int SetBool(VCFG_Node* parentNode, const char* keyName, bool value) { return vcfg_set_bool_in_node(this, parentNode, keyName, value); }
+
+			/**
+			 *	@brief Set an array or object.
+			 *
+			 *	Returns the container stored in the key, replacing any other value with an empty container
+			 *
+			 *	@param sectionName / parentNode - the name of the section containing the key / the object or array holding the key
+			 *	@param keyName - name of the key
+			 *
+			 *	@returns (VCFG_Node*) - the container or nullptr on failure
+			 */
+			VCFG_Node* SetArray(const char* keyName) { return vcfg_set_array(this, nullptr, keyName); }
+			VCFG_Node* SetArray(const char* sectionName, const char* keyName) { return vcfg_set_array(this, sectionName, keyName); }
+			VCFG_Node* SetArray(VCFG_Node* parentNode, const char* keyName) { return vcfg_set_array_in_node(this, parentNode, keyName); }
+
+			VCFG_Node* SetObject(const char* keyName) { return vcfg_set_object(this, nullptr, keyName); }
+			VCFG_Node* SetObject(const char* sectionName, const char* keyName) { return vcfg_set_object(this, sectionName, keyName); }
+			VCFG_Node* SetObject(VCFG_Node* parentNode, const char* keyName) { return vcfg_set_object_in_node(this, parentNode, keyName); }
+
+			/**
+			 *	@brief Insert a value into an array.
+			 *
+			 *	WARNING: all the pointers to the elements of the array obtained before the call are invalidated!
+			 *
+			 *	@param arrayNode - the array
+			 *	@param index - position of the new element (0 - number of elements)
+			 *	@param value - value of the new element
+			 *
+			 *	@returns (VCFG_Node*) - the new element or nullptr on failure
+			 */
+			VCFG_Node* InsertValue(VCFG_Node* arrayNode, uint32_t index, const char* value) { return vcfg_insert_value(this, arrayNode, index, value); }
+			VCFG_Node* AppendValue(VCFG_Node* arrayNode, const char* value) { return vcfg_append_value(this, arrayNode, value); }
+
+			/**
+			 *	@brief Remove a key.
+			 *
+			 *	WARNING: all the pointers to the keys of the same section or node obtained before the call are invalidated!
+			 *
+			 *	@param sectionName / parentNode - the name of the section containing the key / the object or array holding the key
+			 *	@param keyName - name of the key
+			 *
+			 *	@returns 0 - Failure (no such key), 1 - Success
+			 */
+			int RemoveKey(const char* keyName) { return vcfg_remove_key(this, nullptr, keyName); }
+			int RemoveKey(const char* sectionName, const char* keyName) { return vcfg_remove_key(this, sectionName, keyName); }
+			int RemoveKey(VCFG_Node* parentNode, const char* keyName) { return vcfg_remove_key_from_node(this, parentNode, keyName); }
+
+			/**
+			 *	@brief Optimize the memory layout of the parsed data.
+			 *
+			 *	Reorders the keys from the most to the least frequently accessed one.
+			 *	WARNING: all the node pointers obtained before the call are invalidated!
+			 *
+			 *	@param profile - the access counts to use (nullptr - use the counters recorded with VCFG_ENABLE_PROFILING)
+			 *
+			 *	@returns 0 - Failure, 1 - Success
+			 */
+			int OptimizeLayout(const VCFGAccessProfile_t* profile = nullptr) { return vcfg_optimize_layout(this, profile); }
+
+			/**
+			 *	@brief Restore the source order of the parsed data.
+			 *
+			 *	WARNING: all the node pointers obtained before the call are invalidated!
+			 *
+			 *	@returns 0 - Failure, 1 - Success
+			 */
+			int RestoreSourceOrder() { return vcfg_restore_source_order(this); }
+
+			/**
+			 *	@brief Build the hash index of the sections and keys.
+			 *
+			 *	@returns 0 - Failure (see GetLastError), 1 - Success
+			 */
+			int BuildIndex() { return vcfg_build_index(this); }
+
+			/**
+			 *	@brief Build the tree of the dotted section names.
+			 *
+			 *	@returns 0 - Failure (see GetLastError), 1 - Success
+			 */
+			int BuildSectionTree() { return vcfg_build_section_tree(this); }
+
+			/**
+			 *	@brief Get all the subsections ([name.*]) of a section.
+			 *
+			 *	@param sections - set to the positions of the subsections in the parsed data
+			 *
+			 *	@returns (uint32_t) number of subsections
+			 */
+			uint32_t GetSubsections(const char* sectionName, const uint32_t** sections) { return vcfg_get_subsections(this, sectionName, sections); }
+
+			/**
+			 *	@brief Get the section or its nearest dotted parent that has a key.
+			 *
+			 *	@returns (VCFGSection_t*) the section or NULL if none of them has the key
+			 */
+			VCFGSection_t* GetNearestSection(const char* sectionName, const char* keyName) { return vcfg_get_nearest_section(this, sectionName, keyName); }
+
+			/**
+			 *	@brief Resolve the ${section.key} references in the values.
+			 *
+			 *	@returns 0 - Failure (see GetLastError), 1 - Success
+			 */
+			int Interpolate() { return vcfg_interpolate(this); }
+
+			/**
+			 *	@brief Compile the parsed schema file.
+			 *
+			 *	The parser has to outlive the schema, see vcfg_schema_load
+			 *
+			 *	@returns 0 - Failure (see GetLastError), 1 - Success
+			 */
+			int LoadSchema(VCFGSchema_t& schema) { return vcfg_schema_load(&schema, this); }
+
+			/**
+			 *	@brief Validate the configuration against a compiled schema.
+			 *
+			 *	@param violations - receives the first violations (nullptr to only count them)
+			 *	@param maxViolations - capacity of the violations
+			 *
+			 *	@returns (uint32_t) number of violations
+			 */
+			uint32_t Validate(const VCFGSchema_t& schema, VCFGViolation_t* violations = nullptr, uint32_t maxViolations = 0) { return vcfg_validate(this, &schema, violations, maxViolations); }
+
+			/**
+			 *	@brief Copy the merged view of the layers to the parser.
+			 *
+			 *	The parser has to be empty, see vcfg_layers_flatten
+			 *
+			 *	@returns 0 - Failure (see GetLastError), 1 - Success
+			 */
+			int Flatten(const VCFGLayers_t& layers) { return vcfg_layers_flatten(&layers, this); }
+
+			/**
+			 *	@brief Load overrides from PREFIX__SECTION__KEY environment variables.
+			 *
+			 *	@param environment - NULL terminated "NAME=value" entries (NULL for the environment of the process)
+			 *
+			 *	@returns 0 - Failure (see GetLastError), 1 - Success
+			 */
+			int LoadEnvironment(const char* prefix, char** environment = nullptr) { return vcfg_load_environment(this, prefix, environment); }
+
+			/**
+			 *	@brief Load overrides from --set section.key=value command line arguments.
+			 *
+			 *	@returns 0 - Failure (see GetLastError), 1 - Success
+			 */
+			int LoadArguments(int argc, char** argv) { return vcfg_load_arguments(this, argc, argv); }
+
+			#if defined(VCFG_ENABLE_STATS)
+				/**
+				 *	@brief Get memory statistics.
+				 *
+				 *	Returns the allocation counters and the memory used by the parsed data
+				 *
+				 *	@param stats - the structure to fill
+				 *
+				 *	@returns 0 - Failure, 1 - Success
+				 */
+				int GetStats(VCFGStats_t* stats) { return vcfg_get_stats(this, stats); }
+
+				/**
+				 *	@brief Get section memory statistics.
+				 *
+				 *	Returns the memory used by the names, values and node arrays of a single section
+				 *
+				 *	@param sectionName - name of the section (NULL for the root section)
+				 *	@param stats - the structure to fill
+				 *
+				 *	@returns 0 - Failure, 1 - Success
+				 */
+				int GetSectionStats(const char* sectionName, VCFGSectionStats_t* stats) { return vcfg_get_section_stats(this, sectionName, stats); }
+			#endif
+
+			#if defined(VCFG_ENABLE_TRACING)
+				/**
+				 *	@brief Set the trace callback.
+				 *
+				 *	The callback is called at the beginning and the end of Open and Parse
+				 *	and after every section header that was parsed
+				 *
+				 *	@param callback - the function to call (nullptr to disable tracing)
+				 *	@param userData - pointer passed to the callback as the first argument
+				 */
+				void SetTraceCallback(VCFGTraceCallback callback, void* userData) { vcfg_set_trace_callback(this, callback, userData); }
+
+				/**
+				 *	@brief Get parser timings.
+				 *
+				 *	Returns the number of cycles spent in every phase since the last reset
+				 *
+				 *	@param timings - the structure to fill
+				 *
+				 *	@returns 0 - Failure, 1 - Success
+				 */
+				int GetTimings(VCFGTimings_t* timings) { return vcfg_get_timings(this, timings); }
+
+				/**
+				 *	@brief Reset parser timings.
+				 */
+				void ResetTimings() { vcfg_reset_timings(this); }
+			#endif
+
+			#if defined(VCFG_ENABLE_PROFILING)
+				/**
+				 *	@brief Reset the access profile.
+				 *
+				 *	Clears the access counters of all the keys and the recorded misses
+				 */
+				void ResetAccessProfile() { vcfg_reset_access_profile(this); }
+
+				/**
+				 *	@brief Capture the access profile.
+				 *
+				 *	Stores the access counters of all the keys that were read (free with vcfg_free_access_profile)
+				 *
+				 *	@param profile - the profile to fill
+				 *
+				 *	@returns 0 - Failure, 1 - Success
+				 */
+				int CaptureAccessProfile(VCFGAccessProfile_t* profile) { return vcfg_capture_access_profile(this, profile); }
+
+				#if !defined(VCFG_BUFFER_ONLY)
+					/**
+					 *	@brief Dump the access profile.
+					 *
+					 *	Writes the list of hot, cold and never read keys followed by the lookups of keys that don't exist
+					 *
+					 *	@param out - the file to write the report to (e.g. stdout)
+					 *	@param hotThreshold - minimum number of reads of a hot key (0 - the average number of reads)
+					 *
+					 *	@returns 0 - Failure, 1 - Success
+					 */
+					int DumpAccessProfile(FILE* out, uint64_t hotThreshold = 0) { return vcfg_dump_access_profile(this, out, hotThreshold); }
+				#endif
+			#endif
+
+		private:
+			template <typename T>
+			static vcfg::expected<T> MakeExpected(VCFGStatus status, const T& value) {
+				if (status == VCFG_STATUS_OK) return value;
+				return vcfg::unexpected(static_cast<vcfg::error>(status));
+			}
+
+			// Maps the value of a node to an enumerator, the first read of the node fills its enum cache
+			// (another enum read from the node takes it over)
+			template <typename E>
+			static VCFGStatus NodeToEnum(const VCFG_Node* node, E* value) {
+				if (!node) return VCFG_STATUS_NOT_FOUND;
+				if (!(node->value)) return VCFG_STATUS_INVALID_FORMAT;
+
+				using lookup = vcfg::detail::enum_lookup<E>;
+				uint32_t id = lookup::id();
+				uint32_t cache = vcfg::detail::enum_cache_load(node);
+				uint32_t position = cache & vcfg::detail::enum_no_match;
+				if (!id || ((cache >> vcfg::detail::enum_position_bits) != id)) {
+					position = lookup::find(node->value);
+					if (id) vcfg::detail::enum_cache_store(node, (id << vcfg::detail::enum_position_bits) | position);
+				}
+				if (position == vcfg::detail::enum_no_match) return VCFG_STATUS_INVALID_FORMAT;
+				*value = vcfg::enum_names<E>::names[position - 1].value;
+				return VCFG_STATUS_OK;
+			}
 	};
 	typedef VCFGParser VCFG_Parser;
 #endif // __cplusplus
@@ -0,0 +1,386 @@
+﻿/*
+ * profile.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef VCFG_PROFILE_H
+#define VCFG_PROFILE_H 1
+
+#include "parser.h"
+#include "macros.h"
+#include "hash.h"
+
+#if defined(VCFG_ENABLE_PROFILING)
+	#define VCFG_PROFILE_HIT(parserObj, key) vcfginternal_profile_hit(parserObj, key)
+	#define VCFG_PROFILE_MISS(parserObj, scopeName, keyName) vcfginternal_profile_miss(parserObj, scopeName, keyName)
+#else
+	#define VCFG_PROFILE_HIT(parserObj, key)
+	#define VCFG_PROFILE_MISS(parserObj, scopeName, keyName)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#if defined(VCFG_ENABLE_PROFILING)
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#endif
+
+	/**
+	 *	@brief Atomically add a value to a counter (relaxed ordering).
+	 */
+	inline void vcfginternal_atomic_add(uint64_t* counter, uint64_t value) {
+	#if defined(_MSC_VER)
+		_InterlockedExchangeAdd64((volatile __int64*)counter, (__int64)value);
+	#else
+		__atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+	#endif
+	}
+
+	/**
+	 *	@brief Atomically read a counter (relaxed ordering).
+	 */
+	inline uint64_t vcfginternal_atomic_load(const uint64_t* counter) {
+	#if defined(_MSC_VER)
+		return *(const volatile uint64_t*)counter;
+	#else
+		return __atomic_load_n(counter, __ATOMIC_RELAXED);
+	#endif
+	}
+
+	/**
+	 *	@brief Atomically claim a zero counter (relaxed ordering).
+	 *
+	 *	@returns 1 if the counter was set to the desired value, 0 if it already had a value
+	 */
+	inline int vcfginternal_atomic_claim(uint64_t* counter, uint64_t desired) {
+	#if defined(_MSC_VER)
+		return _InterlockedCompareExchange64((volatile __int64*)counter, (__int64)desired, 0) == 0;
+	#else
+		uint64_t expected = 0;
+		return __atomic_compare_exchange_n(counter, &expected, desired, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+	#endif
+	}
+
+	/**
+	 *	@brief Set a flag after everything written before it (release ordering).
+	 */
+	inline void vcfginternal_atomic_publish(uint64_t* flag) {
+	#if defined(_MSC_VER)
+		_InterlockedExchange64((volatile __int64*)flag, 1);
+	#else
+		__atomic_store_n(flag, 1, __ATOMIC_RELEASE);
+	#endif
+	}
+
+	/**
+	 *	@brief Read a flag set by vcfginternal_atomic_publish (acquire ordering).
+	 *
+	 *	@returns (uint64_t) the flag, what was written before it is visible when it's set
+	 */
+	inline uint64_t vcfginternal_atomic_published(const uint64_t* flag) {
+	#if defined(_MSC_VER)
+		return *(const volatile uint64_t*)flag;
+	#else
+		return __atomic_load_n(flag, __ATOMIC_ACQUIRE);
+	#endif
+	}
+
+	/**
+	 *	@brief Decide if the current lookup should be recorded.
+	 *
+	 *	Every thread keeps its own countdown, so the sampling doesn't need any synchronization.
+	 *	With the default sample rate of 1 every lookup is recorded
+	 */
+	inline int vcfginternal_profile_sample(void) {
+	#if VCFG_PROFILE_SAMPLE_RATE > 1
+		static VCFG_THREAD_LOCAL uint32_t countdown = 0;
+		if (countdown) {
+			--countdown;
+			return 0;
+		}
+		countdown = VCFG_PROFILE_SAMPLE_RATE - 1;
+	#endif
+		return 1;
+	}
+
+	/**
+	 *	@brief Record a successful lookup.
+	 */
+	inline void vcfginternal_profile_hit(VCFG_Parser* parserObj, const VCFGKey_t* key) {
+		(void)parserObj;
+		if (!vcfginternal_profile_sample()) return;
+		vcfginternal_atomic_add((uint64_t*)&(key->accessCount), VCFG_PROFILE_SAMPLE_RATE);
+	}
+
+	/**
+	 *	@brief Record a lookup of a key that doesn't exist.
+	 *
+	 *	Misses are stored in a small fixed size table inside the parser.
+	 *	When the table is full the additional missing keys are only counted in the overflow counter.
+	 *	The thread that claims a slot writes the path and then marks it ready, the slot is only reported after that
+	 */
+	inline void vcfginternal_profile_miss(VCFG_Parser* parserObj, const char* scopeName, const char* keyName) {
+		if (!vcfginternal_profile_sample()) return;
+
+		uint64_t hash = vcfginternal_hash_append(vcfginternal_hash_append(VCFG_HASH_SEED, scopeName), keyName);
+		for (uint32_t probe = 0; probe < VCFG_PROFILE_MISS_SLOTS; probe++) {
+			VCFGMissEntry_t* entry = &(parserObj->m_missTable[(hash + probe) % VCFG_PROFILE_MISS_SLOTS]);
+
+			if (vcfginternal_atomic_load(&(entry->hash)) != hash) {
+				if (!vcfginternal_atomic_claim(&(entry->hash), hash)) {
+					if (vcfginternal_atomic_load(&(entry->hash)) != hash) continue;
+				}
+				else {
+					// We own the slot now, so we can store the path of the key
+					size_t length = 0;
+					for (const char* ch = scopeName; ch && *ch && length < VCFG_PROFILE_PATH_LENGTH - 2; ch++) entry->path[length++] = *ch;
+					if (scopeName) entry->path[length++] = '.';
+					for (const char* ch = keyName; ch && *ch && length < VCFG_PROFILE_PATH_LENGTH - 1; ch++) entry->path[length++] = *ch;
+					entry->path[length] = '\0';
+					vcfginternal_atomic_publish(&(entry->ready));
+				}
+			}
+
+			vcfginternal_atomic_add(&(entry->count), VCFG_PROFILE_SAMPLE_RATE);
+			return;
+		}
+
+		vcfginternal_atomic_add(&(parserObj->m_missOverflow), VCFG_PROFILE_SAMPLE_RATE);
+	}
+
+	/**
+	 *	@brief Reset the access counters of a key and all its children.
+	 */
+	inline void vcfginternal_reset_key_profile(VCFGKey_t* key) {
+		key->accessCount = 0;
+		for (uint32_t i = 0; i < key->childCount; i++) {
+			vcfginternal_reset_key_profile(&(key->children[i]));
+		}
+	}
+
+	/**
+	 *	@brief Reset the access profile.
+	 *
+	 *	Clears the access counters of all the keys and the recorded misses
+	 */
+	inline void vcfg_reset_access_profile(VCFG_Parser* parserObj) {
+		for (uint32_t i = 0; i < parserObj->m_sectionCount; i++) {
+			for (uint32_t k = 0; k < parserObj->m_parsedData[i].keyCount; k++) {
+				vcfginternal_reset_key_profile(&(parserObj->m_parsedData[i].keys[k]));
+			}
+		}
+
+		for (uint32_t i = 0; i < VCFG_PROFILE_MISS_SLOTS; i++) {
+			parserObj->m_missTable[i].hash = 0;
+			parserObj->m_missTable[i].count = 0;
+			parserObj->m_missTable[i].ready = 0;
+			parserObj->m_missTable[i].path[0] = '\0';
+		}
+		parserObj->m_missOverflow = 0;
+	}
+
+#if !defined(VCFG_BUFFER_ONLY)
+	#include <stdio.h>
+
+	// A single key of the access profile report
+	typedef struct VCFGProfileReportEntry {
+		uint64_t count;
+		size_t pathOffset;
+	} VCFGProfileReportEntry_t;
+
+	typedef struct VCFGProfileReport {
+		VCFGProfileReportEntry_t* entries;
+		size_t entryCount;
+		size_t entryCapacity;
+
+		char* paths;
+		size_t pathsLength;
+		size_t pathsCapacity;
+	} VCFGProfileReport_t;
+
+	/**
+	 *	@brief Append a path to the report.
+	 *
+	 *	The path is built from an already stored prefix (referenced by its offset, as the buffer can move) and a name
+	 *
+	 *	@returns (size_t) offset of the new path or (size_t)-1 when out of memory
+	 */
+	inline size_t vcfginternal_append_profile_path(VCFGProfileReport_t* report, size_t prefixOffset, size_t prefixLength, const char* name) {
+		size_t nameLength = name ? vcfginternal_strlen(name) : 0;
+		size_t pathLength = prefixLength + (prefixLength ? 1 : 0) + nameLength;
+
+		if (report->pathsLength + pathLength + 1 > report->pathsCapacity) {
+			size_t newCapacity = (report->pathsCapacity ? report->pathsCapacity * 2 : 1024) + pathLength + 1;
+			char* newPaths = (char*)VCFG_REALLOC(report->paths, newCapacity);
+			if (!newPaths) return (size_t)-1;
+			report->paths = newPaths;
+			report->pathsCapacity = newCapacity;
+		}
+
+		size_t pathOffset = report->pathsLength;
+		char* path = report->paths + pathOffset;
+		if (prefixLength) {
+			vcfginternal_memcpy((void*)path, (void*)(report->paths + prefixOffset), prefixLength);
+			path[prefixLength] = '.';
+		}
+		if (nameLength) vcfginternal_memcpy((void*)(path + pathLength - nameLength), (void*)name, nameLength);
+		path[pathLength] = '\0';
+		report->pathsLength += pathLength + 1;
+
+		return pathOffset;
+	}
+
+	/**
+	 *	@brief Add a key with all of its children to the report.
+	 *
+	 *	@returns 0 - Failure (out of memory), 1 - Success
+	 */
+	inline int vcfginternal_collect_key_profile(VCFGProfileReport_t* report, const VCFGKey_t* key, size_t prefixOffset, size_t prefixLength) {
+		if (report->entryCount == report->entryCapacity) {
+			size_t newCapacity = report->entryCapacity ? report->entryCapacity * 2 : 64;
+			VCFGProfileReportEntry_t* newEntries = (VCFGProfileReportEntry_t*)VCFG_REALLOC(report->entries, newCapacity * sizeof(VCFGProfileReportEntry_t));
+			if (!newEntries) return 0;
+			report->entries = newEntries;
+			report->entryCapacity = newCapacity;
+		}
+
+		size_t pathOffset = vcfginternal_append_profile_path(report, prefixOffset, prefixLength, key->name);
+		if (pathOffset == (size_t)-1) return 0;
+		size_t pathLength = report->pathsLength - pathOffset - 1;
+
+		report->entries[report->entryCount].count = vcfginternal_atomic_load(&(key->accessCount));
+		report->entries[report->entryCount].pathOffset = pathOffset;
+		++(report->entryCount);
+
+		for (uint32_t i = 0; i < key->childCount; i++) {
+			if (!vcfginternal_collect_key_profile(report, &(key->children[i]), pathOffset, pathLength)) return 0;
+		}
+		return 1;
+	}
+
+	/**
+	 *	@brief Sort the report entries from the most to the least accessed.
+	 */
+	inline int vcfginternal_compare_profile_entries(const void* first, const void* second) {
+		uint64_t firstCount = ((const VCFGProfileReportEntry_t*)first)->count;
+		uint64_t secondCount = ((const VCFGProfileReportEntry_t*)second)->count;
+		if (firstCount != secondCount) return (firstCount < secondCount) ? 1 : -1;
+
+		// Keep the source order for keys with the same count
+		size_t firstOffset = ((const VCFGProfileReportEntry_t*)first)->pathOffset;
+		size_t secondOffset = ((const VCFGProfileReportEntry_t*)second)->pathOffset;
+		return (firstOffset < secondOffset) ? -1 : (firstOffset > secondOffset);
+	}
+
+	/**
+	 *	@brief Dump the access profile.
+	 *
+	 *	Writes the list of hot, cold and never read keys followed by the lookups
+	 *	of keys that don't exist. Keys are written as section.key.child (the root section has no prefix)
+	 *
+	 *	@param out - the file to write the report to (e.g. stdout)
+	 *	@param hotThreshold - minimum number of reads of a hot key (0 - the average number of reads of the keys that were read)
+	 *
+	 *	@returns 0 - Failure, 1 - Success
+	 */
+	inline int vcfg_dump_access_profile(VCFG_Parser* parserObj, FILE* out, uint64_t hotThreshold) {
+		if (!parserObj || !out) return 0;
+
+		VCFGProfileReport_t report = { 0 };
+		int result = 1;
+		for (uint32_t i = 0; i < parserObj->m_sectionCount && result; i++) {
+			const VCFGSection_t* section = &(parserObj->m_parsedData[i]);
+
+			// The section name is the prefix of all its keys (the root section has no prefix)
+			size_t prefixOffset = 0;
+			size_t prefixLength = 0;
+			if (section->name) {
+				prefixOffset = vcfginternal_append_profile_path(&report, 0, 0, section->name);
+				if (prefixOffset == (size_t)-1) {
+					result = 0;
+					break;
+				}
+				prefixLength = report.pathsLength - prefixOffset - 1;
+			}
+
+			for (uint32_t k = 0; k < section->keyCount && result; k++) {
+				result = vcfginternal_collect_key_profile(&report, &(section->keys[k]), prefixOffset, prefixLength);
+			}
+		}
+
+		if (result) {
+			qsort(report.entries, report.entryCount, sizeof(VCFGProfileReportEntry_t), vcfginternal_compare_profile_entries);
+
+			uint64_t totalReads = 0;
+			size_t readKeys = 0;
+			for (size_t i = 0; i < report.entryCount; i++) {
+				totalReads += report.entries[i].count;
+				if (report.entries[i].count) ++readKeys;
+			}
+			if (!hotThreshold) hotThreshold = readKeys ? ((totalReads + readKeys - 1) / readKeys) : 1;
+
+			fprintf(out, "# VortexConfig access profile: %llu reads of %llu out of %llu keys (sample rate %d)\n",
+				(unsigned long long)totalReads, (unsigned long long)readKeys, (unsigned long long)report.entryCount, VCFG_PROFILE_SAMPLE_RATE);
+
+			fprintf(out, "\n# Hot keys (%llu or more reads)\n", (unsigned long long)hotThreshold);
+			for (size_t i = 0; i < report.entryCount && report.entries[i].count >= hotThreshold; i++) {
+				fprintf(out, "%12llu  %s\n", (unsigned long long)report.entries[i].count, report.paths + report.entries[i].pathOffset);
+			}
+
+			fprintf(out, "\n# Cold keys\n");
+			for (size_t i = 0; i < report.entryCount; i++) {
+				if (report.entries[i].count >= hotThreshold || !report.entries[i].count) continue;
+				fprintf(out, "%12llu  %s\n", (unsigned long long)report.entries[i].count, report.paths + report.entries[i].pathOffset);
+			}
+
+			fprintf(out, "\n# Never read keys\n");
+			for (size_t i = 0; i < report.entryCount; i++) {
+				if (report.entries[i].count) continue;
+				fprintf(out, "%12s  %s\n", "-", report.paths + report.entries[i].pathOffset);
+			}
+
+			fprintf(out, "\n# Lookups of missing keys\n");
+			for (uint32_t i = 0; i < VCFG_PROFILE_MISS_SLOTS; i++) {
+				if (!vcfginternal_atomic_published(&(parserObj->m_missTable[i].ready))) continue;
+				fprintf(out, "%12llu  %s\n", (unsigned long long)vcfginternal_atomic_load(&(parserObj->m_missTable[i].count)), parserObj->m_missTable[i].path);
+			}
+			uint64_t overflow = vcfginternal_atomic_load(&(parserObj->m_missOverflow));
+			if (overflow) fprintf(out, "%12llu  (other missing keys)\n", (unsigned long long)overflow);
+		}
+
+		VCFG_FREE(report.entries);
+		VCFG_FREE(report.paths);
+		return result;
+	}
+#endif // VCFG_BUFFER_ONLY
+#endif // VCFG_ENABLE_PROFILING
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_PROFILE_H
@@ -0,0 +1,564 @@
+﻿/*
+ * schema.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#ifndef VCFG_SCHEMA_H
+#define VCFG_SCHEMA_H 1
+
+#include "parser.h"
+#include "macros.h"
+#include "hash.h"
+#include "memory.h"
+#include "errors.h"
+#include "strconv.h"
+#include "units.h"
+#include "index.h"
+#include "implementation.h"
+#include "mutation.h"
+#include "compatibility.h"
+
+// A schema describes the keys a configuration should have: their types, bounds, allowed values and patterns
+// and which of them are required. The rules come from a static table (vcfg_schema_compile) or from a schema file
+// (vcfg_schema_load) and are compiled once to an open addressing table of their path hashes, like the hash index.
+// vcfg_validate walks the sections, their keys and the objects nested in them once, hashing every name a single
+// time and probing the table for its rule. Only the required keys it didn't see are looked up afterwards, they may be
+// inherited from another section
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+	#include <stdint.h>
+	#include <float.h>
+
+	#define VCFG_SCHEMA_MIN_CAPACITY 16
+
+	// Number of rules whose seen flags vcfg_validate keeps on the stack (larger schemas allocate them)
+	#ifndef VCFG_SCHEMA_STACK_RULES
+		#define VCFG_SCHEMA_STACK_RULES 1024
+	#endif
+
+	// State of a single vcfg_validate
+	typedef struct VCFGValidation {
+		const VCFGSchema_t* schema;
+		const char* sectionName;
+		const char* names[VCFG_SCHEMA_MAX_DEPTH];	// Names of the visited key and of the objects it's nested in
+		uint8_t* seen;								// Bit per rule that matched a key
+		VCFGViolation_t* violations;
+		uint32_t maxViolations;
+		uint32_t violationCount;
+	} VCFGValidation_t;
+
+	/**
+	 *	@brief Get a name of the key of a rule.
+	 *
+	 *	@param index - position of the name in the dotted key
+	 */
+	inline const char* vcfginternal_schema_name(const VCFGSchema_t* schema, uint32_t rule, uint32_t index) {
+		const char* name = schema->checks[rule].names;
+		if (!name) return schema->rules[rule].key;
+
+		while (index--) name += vcfginternal_strlen(name) + 1;
+		return name;
+	}
+
+	/**
+	 *	@brief Find the rule of a key.
+	 *
+	 *	@param hash - path hash of the key
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param names - names of the key and of the objects it's nested in, from the outermost one
+	 *	@param depth - number of the names
+	 *
+	 *	@returns (const VCFGSchemaEntry_t*) entry of the rule or NULL if the key doesn't have one
+	 */
+	inline const VCFGSchemaEntry_t* vcfginternal_schema_find(const VCFGSchema_t* schema, uint64_t hash, const char* sectionName, const char* const* names, uint32_t depth) {
+		uint32_t mask = schema->tableCapacity - 1;
+		for (uint32_t i = vcfginternal_index_home(hash, schema->tableCapacity); ; i = (i + 1) & mask) {
+			const VCFGSchemaEntry_t* entry = &(schema->table[i]);
+			if (!(entry->hash)) return 0;
+			if ((entry->hash != hash) || (schema->checks[entry->rule].depth != depth)) continue;
+			if (vcfginternal_strcmp(schema->rules[entry->rule].section, sectionName) != 0) continue;
+
+			uint32_t matching = 0;
+			while ((matching < depth) && (vcfginternal_strcmp(vcfginternal_schema_name(schema, entry->rule, matching), names[matching]) == 0)) ++matching;
+			if (matching == depth) return entry;
+		}
+	}
+
+	/**
+	 *	@brief Match a string against a pattern.
+	 *
+	 *	* matches any number of characters and ? a single character, everything else only itself.
+	 *	After a mismatch only the last * is retried, which is enough for patterns without character classes
+	 *
+	 *	@returns (int) 1 - the whole string matches, 0 - it doesn't
+	 */
+	inline int vcfginternal_pattern_match(const char* pattern, const char* str) {
+		const char* star = 0;
+		const char* resume = 0;
+		while (*str) {
+			if (*pattern == '*') {
+				star = pattern++;
+				resume = str;
+			}
+			else if ((*pattern == '?') || (*pattern == *str)) {
+				++pattern;
+				++str;
+			}
+			else if (star) {
+				pattern = star + 1;
+				str = ++resume;
+			}
+			else return 0;
+		}
+
+		while (*pattern == '*') ++pattern;
+		return (*pattern == '\0');
+	}
+
+	/**
+	 *	@brief Convert a bound of a rule.
+	 *
+	 *	@param text - the bound written like a value of the type
+	 *	@param bound - receives integers, durations, sizes, lengths and numbers of elements
+	 *	@param floatBound - receives floating point numbers
+	 *
+	 *	@returns 0 - Failure (the type has no bounds or the bound isn't valid), 1 - Success
+	 */
+	inline int vcfginternal_schema_bound(VCFGSchemaType type, const char* text, int64_t* bound, double* floatBound) {
+		switch (type) {
+			case VCFG_SCHEMA_INT: return (vcfginternal_parseint(text, bound) == VCFG_STATUS_OK);
+			case VCFG_SCHEMA_FLOAT: return (vcfginternal_parsefloat(text, floatBound) == VCFG_STATUS_OK);
+			case VCFG_SCHEMA_DURATION: return (vcfginternal_parse_unit_value(text, VCFG_UNIT_DURATION, bound) == VCFG_STATUS_OK);
+			case VCFG_SCHEMA_SIZE: return (vcfginternal_parse_unit_value(text, VCFG_UNIT_SIZE, bound) == VCFG_STATUS_OK);
+			case VCFG_SCHEMA_STRING:
+			case VCFG_SCHEMA_ENUM:
+			case VCFG_SCHEMA_ARRAY: return (vcfginternal_parseint(text, bound) == VCFG_STATUS_OK) && (*bound >= 0);
+			default: return 0;
+		}
+	}
+
+	/**
+	 *	@brief Free a schema.
+	 *
+	 *	The schema is empty afterwards. The rules of a table aren't freed, the ones of a schema file are
+	 */
+	inline void vcfg_schema_free(VCFGSchema_t* schema) {
+		if (!schema) return;
+
+		for (uint32_t i = 0; schema->checks && (i < schema->ruleCount); i++) {
+			if (schema->checks[i].names) VCFG_FREE((void*)(schema->checks[i].names));
+		}
+		if (schema->checks) VCFG_FREE((void*)(schema->checks));
+		if (schema->table) VCFG_FREE((void*)(schema->table));
+		if (schema->storage) VCFG_FREE(schema->storage);
+
+		schema->rules = 0;
+		schema->checks = 0;
+		schema->table = 0;
+		schema->ruleCount = 0;
+		schema->tableCapacity = 0;
+		schema->maxDepth = 0;
+		schema->storage = 0;
+	}
+
+	/**
+	 *	@brief Compile a rule and add it to the table.
+	 *
+	 *	@param rule - position of the rule
+	 *
+	 *	@returns 0 - Failure (invalid rule, a key that has a rule already or out of memory), 1 - Success
+	 */
+	inline int vcfginternal_schema_add(VCFGSchema_t* schema, uint32_t rule) {
+		const VCFGSchemaRule_t* source = &(schema->rules[rule]);
+		VCFGSchemaCheck_t* check = &(schema->checks[rule]);
+		if (!(source->key) || ((uint32_t)(source->type) > (uint32_t)VCFG_SCHEMA_OBJECT)) return 0;
+		if ((source->type == VCFG_SCHEMA_ENUM) != (source->values != 0)) return 0;
+
+		check->minimum = INT64_MIN;
+		check->maximum = INT64_MAX;
+		check->minimumFloat = -DBL_MAX;
+		check->maximumFloat = DBL_MAX;
+		if (source->minimum && !vcfginternal_schema_bound(source->type, source->minimum, &(check->minimum), &(check->minimumFloat))) return 0;
+		if (source->maximum && !vcfginternal_schema_bound(source->type, source->maximum, &(check->maximum), &(check->maximumFloat))) return 0;
+		if ((check->minimum > check->maximum) || (check->minimumFloat > check->maximumFloat)) return 0;
+
+		// A dotted key is split into the names of the objects and of the key
+		size_t keyLength = vcfginternal_strlen(source->key);
+		check->depth = 1;
+		for (size_t i = 0; i < keyLength; i++) check->depth += (source->key[i] == '.');
+		if (check->depth > VCFG_SCHEMA_MAX_DEPTH) return 0;
+		if (check->depth > 1) {
+			check->names = (char*)VCFG_MALLOC(keyLength + 1);
+			if (!(check->names)) return 0;
+			for (size_t i = 0; i <= keyLength; i++) check->names[i] = (source->key[i] == '.') ? '\0' : source->key[i];
+		}
+
+		const char* names[VCFG_SCHEMA_MAX_DEPTH];
+		uint64_t hash = vcfginternal_hash_append(VCFG_HASH_SEED, source->section);
+		for (uint32_t i = 0; i < check->depth; i++) {
+			names[i] = vcfginternal_schema_name(schema, rule, i);
+			if (!(*(names[i]))) return 0;
+			hash = vcfginternal_hash_append(hash, names[i]);
+		}
+		if (vcfginternal_schema_find(schema, hash, source->section, names, check->depth)) return 0;
+
+		uint32_t mask = schema->tableCapacity - 1;
+		uint32_t slot = vcfginternal_index_home(hash, schema->tableCapacity);
+		while (schema->table[slot].hash) slot = (slot + 1) & mask;
+		schema->table[slot].hash = hash;
+		schema->table[slot].rule = rule;
+		if (check->depth > schema->maxDepth) schema->maxDepth = check->depth;
+		return 1;
+	}
+
+	/**
+	 *	@brief Compile a table of rules.
+	 *
+	 *	The rules aren't copied, they have to outlive the schema (e.g. a static or constexpr table).
+	 *	The bounds are converted and the paths of the keys hashed once, so vcfg_validate only probes the table
+	 *
+	 *	@param schema - receives the compiled schema (free the previous one first)
+	 *	@param rules - the rules, every key can have only one
+	 *	@param ruleCount - number of the rules
+	 *
+	 *	@returns 0 - Failure (an invalid rule, a key with two rules or out of memory), 1 - Success
+	 */
+	inline int vcfg_schema_compile(VCFGSchema_t* schema, const VCFGSchemaRule_t* rules, uint32_t ruleCount) {
+		if (!schema || (ruleCount && !rules)) return 0;
+
+		VCFGSchema_t compiled = { 0 };
+		compiled.rules = rules;
+		compiled.ruleCount = ruleCount;
+		compiled.tableCapacity = VCFG_SCHEMA_MIN_CAPACITY;
+		while (compiled.tableCapacity < 2 * (size_t)ruleCount) compiled.tableCapacity <<= 1;
+
+		compiled.table = (VCFGSchemaEntry_t*)VCFG_CALLOC(compiled.tableCapacity, sizeof(VCFGSchemaEntry_t));
+		compiled.checks = (VCFGSchemaCheck_t*)VCFG_CALLOC(ruleCount ? ruleCount : 1, sizeof(VCFGSchemaCheck_t));
+		int valid = compiled.table && compiled.checks;
+		for (uint32_t i = 0; valid && (i < ruleCount); i++) valid = vcfginternal_schema_add(&compiled, i);
+		if (!valid) {
+			vcfg_schema_free(&compiled);
+			return 0;
+		}
+
+		*schema = compiled;
+		return 1;
+	}
+
+	/**
+	 *	@brief Check a value against its rule.
+	 *
+	 *	@param kind - receives the violation
+	 *
+	 *	@returns 0 - the value violates the rule, 1 - the value is valid
+	 */
+	inline int vcfginternal_schema_check(const VCFGSchema_t* schema, uint32_t rule, const VCFGKey_t* key, VCFGViolationKind* kind) {
+		const VCFGSchemaRule_t* source = &(schema->rules[rule]);
+		const VCFGSchemaCheck_t* check = &(schema->checks[rule]);
+		const char* value = key->value ? key->value : "";
+		int isArray = vcfginternal_is_array(key);
+		int isObject = vcfginternal_is_object(key);
+
+		VCFGStatus status = (isArray || isObject) ? VCFG_STATUS_INVALID_FORMAT : VCFG_STATUS_OK;
+		int64_t number = 0;
+		double floatNumber = 0.0;
+		int boolean = 0;
+		switch (source->type) {
+			case VCFG_SCHEMA_INT: if (status == VCFG_STATUS_OK) status = vcfginternal_parseint(value, &number); break;
+			case VCFG_SCHEMA_FLOAT: if (status == VCFG_STATUS_OK) status = vcfginternal_parsefloat(value, &floatNumber); break;
+			case VCFG_SCHEMA_BOOL: if (status == VCFG_STATUS_OK) status = vcfginternal_parsebool(value, &boolean); break;
+			case VCFG_SCHEMA_DURATION: if (status == VCFG_STATUS_OK) status = vcfginternal_key_quantity(key, VCFG_UNIT_DURATION, &number); break;
+			case VCFG_SCHEMA_SIZE: if (status == VCFG_STATUS_OK) status = vcfginternal_key_quantity(key, VCFG_UNIT_SIZE, &number); break;
+			case VCFG_SCHEMA_ARRAY:
+				status = isArray ? VCFG_STATUS_OK : VCFG_STATUS_INVALID_FORMAT;
+				number = key->childCount;
+				break;
+			case VCFG_SCHEMA_OBJECT: status = isObject ? VCFG_STATUS_OK : VCFG_STATUS_INVALID_FORMAT; break;
+			default: number = (int64_t)vcfginternal_strlen(value); break;
+		}
+
+		*kind = VCFG_VIOLATION_WRONG_TYPE;
+		if (status == VCFG_STATUS_INVALID_FORMAT) return 0;
+
+		*kind = VCFG_VIOLATION_OUT_OF_RANGE;
+		if ((status == VCFG_STATUS_OUT_OF_RANGE) || (number < check->minimum) || (number > check->maximum)) return 0;
+		if ((floatNumber < check->minimumFloat) || (floatNumber > check->maximumFloat)) return 0;
+
+		if (source->values) {
+			const char* const* allowed = source->values;
+			while (*allowed && (vcfginternal_strcmp(*allowed, value) != 0)) ++allowed;
+			*kind = VCFG_VIOLATION_NOT_ALLOWED;
+			if (!(*allowed)) return 0;
+		}
+
+		*kind = VCFG_VIOLATION_NO_MATCH;
+		return !(source->pattern) || isArray || isObject || vcfginternal_pattern_match(source->pattern, value);
+	}
+
+	/**
+	 *	@brief Record a violation.
+	 */
+	inline void vcfginternal_schema_report(VCFGValidation_t* validation, VCFGViolationKind kind, uint32_t rule, const VCFGKey_t* key) {
+		if (validation->violationCount < validation->maxViolations) {
+			VCFGViolation_t* violation = &(validation->violations[validation->violationCount]);
+			violation->kind = kind;
+			violation->rule = &(validation->schema->rules[rule]);
+			violation->key = key;
+		}
+		++(validation->violationCount);
+	}
+
+	/**
+	 *	@brief Check the keys of a section or an object and the objects nested in them.
+	 *
+	 *	@param parentHash - path hash of the section or the object
+	 *	@param depth - number of objects the keys are nested in
+	 */
+	inline void vcfginternal_schema_visit(VCFGValidation_t* validation, const VCFGKey_t* keys, uint32_t keyCount, uint64_t parentHash, uint32_t depth) {
+		const VCFGSchema_t* schema = validation->schema;
+		for (uint32_t i = 0; i < keyCount; i++) {
+			const VCFGKey_t* key = &(keys[i]);
+			uint64_t hash = vcfginternal_hash_append(parentHash, key->name);
+			validation->names[depth] = key->name;
+
+			const VCFGSchemaEntry_t* entry = vcfginternal_schema_find(schema, hash, validation->sectionName, validation->names, depth + 1);
+			if (entry) {
+				validation->seen[entry->rule >> 3] |= (uint8_t)(1u << (entry->rule & 7));
+
+				VCFGViolationKind kind;
+				if (!vcfginternal_schema_check(schema, entry->rule, key, &kind)) vcfginternal_schema_report(validation, kind, entry->rule, key);
+			}
+
+			if ((depth + 1 < schema->maxDepth) && key->childCount && vcfginternal_is_object(key)) {
+				vcfginternal_schema_visit(validation, key->children, key->childCount, hash, depth + 1);
+			}
+		}
+	}
+
+	/**
+	 *	@brief Look up the key of a rule the way the getters do (inherited keys included).
+	 *
+	 *	@returns (const VCFGKey_t*) the key or NULL if it doesn't exist
+	 */
+	inline const VCFGKey_t* vcfginternal_schema_lookup(VCFG_Parser* parserObj, const VCFGSchema_t* schema, uint32_t rule) {
+		const VCFGKey_t* key = vcfginternal_find_key(parserObj, schema->rules[rule].section, vcfginternal_schema_name(schema, rule, 0));
+		for (uint32_t i = 1; key && (i < schema->checks[rule].depth); i++) {
+			key = vcfginternal_is_object(key) ? vcfginternal_find_child(parserObj, key, vcfginternal_schema_name(schema, rule, i)) : 0;
+		}
+		return key;
+	}
+
+	/**
+	 *	@brief Validate the parsed data against a schema.
+	 *
+	 *	Checks every key that has a rule in a single walk over the sections and the objects nested in them
+	 *	and then looks up the required keys that weren't found, so that inherited keys are checked too.
+	 *	Keys without a rule are allowed. Nothing is changed and nothing is allocated unless the schema has more than
+	 *	VCFG_SCHEMA_STACK_RULES rules
+	 *
+	 *	@param schema - the compiled schema (see vcfg_schema_compile and vcfg_schema_load)
+	 *	@param violations - receives the first violations (NULL to only count them)
+	 *	@param maxViolations - capacity of the violations
+	 *
+	 *	@returns (uint32_t) number of violations, also those that didn't fit (0 with VCFG_ERROR_OUT_OF_MEMORY when the validation failed)
+	 */
+	inline uint32_t vcfg_validate(VCFG_Parser* parserObj, const VCFGSchema_t* schema, VCFGViolation_t* violations, uint32_t maxViolations) {
+		if (!parserObj || !schema || !(schema->table)) return 0;
+		parserObj->m_lastError = VCFG_ERROR_NONE;
+
+		uint8_t stackSeen[VCFG_SCHEMA_STACK_RULES / 8];
+		size_t seenSize = ((size_t)(schema->ruleCount) + 7) / 8;
+		uint8_t* seen = (seenSize <= sizeof(stackSeen)) ? stackSeen : (uint8_t*)VCFG_MALLOC(seenSize);
+		if (!seen) {
+			vcfginternal_set_error(parserObj, VCFG_ERROR_OUT_OF_MEMORY);
+			return 0;
+		}
+		for (size_t i = 0; i < seenSize; i++) seen[i] = 0;
+
+		VCFGValidation_t validation;
+		validation.schema = schema;
+		validation.seen = seen;
+		validation.violations = violations;
+		validation.maxViolations = violations ? maxViolations : 0;
+		validation.violationCount = 0;
+
+		for (uint32_t i = 0; i < parserObj->m_sectionCount; i++) {
+			const VCFGSection_t* section = &(parserObj->m_parsedData[i]);
+			validation.sectionName = section->name;
+			vcfginternal_schema_visit(&validation, section->keys, section->keyCount, vcfginternal_hash_append(VCFG_HASH_SEED, section->name), 0);
+		}
+
+		// A required key the walk didn't find may still be inherited from another section
+		for (uint32_t i = 0; i < schema->ruleCount; i++) {
+			if (!(schema->rules[i].flags & VCFG_SCHEMA_REQUIRED) || (seen[i >> 3] & (1u << (i & 7)))) continue;
+
+			const VCFGKey_t* key = vcfginternal_schema_lookup(parserObj, schema, i);
+			VCFGViolationKind kind = VCFG_VIOLATION_MISSING;
+			if (!key || !vcfginternal_schema_check(schema, i, key, &kind)) vcfginternal_schema_report(&validation, kind, i, key);
+		}
+
+		if (seen != stackSeen) VCFG_FREE((void*)seen);
+		return validation.violationCount;
+	}
+
+	/**
+	 *	@brief Get the type of a rule of a schema file.
+	 *
+	 *	@returns 0 - Failure (unknown type), 1 - Success
+	 */
+	inline int vcfginternal_schema_type(const char* name, VCFGSchemaType* type) {
+		static const char* const types[] = { "string", "int", "float", "bool", "duration", "size", "enum", "array", "object" };
+		for (uint32_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+			if (vcfginternal_strcmp(types[i], name) != 0) continue;
+			*type = (VCFGSchemaType)i;
+			return 1;
+		}
+		return 0;
+	}
+
+	/**
+	 *	@brief Count the allowed values of a rule of a schema file (with their terminators).
+	 */
+	inline size_t vcfginternal_schema_value_slots(const VCFGKey_t* key) {
+		size_t slots = 0;
+		for (uint32_t i = 0; i < key->childCount; i++) {
+			if (vcfginternal_is_array(&(key->children[i]))) slots += (size_t)(key->children[i].childCount) + 1;
+		}
+		return slots;
+	}
+
+	/**
+	 *	@brief Read a rule of a schema file.
+	 *
+	 *	@param key - the rule, an object with the attributes of the key it's named after
+	 *	@param values - storage for the allowed values (see vcfginternal_schema_value_slots)
+	 *
+	 *	@returns 0 - Failure (not an object, without a type or with an unknown or invalid attribute), 1 - Success
+	 */
+	inline int vcfginternal_schema_read_rule(const VCFGKey_t* key, const char* sectionName, VCFGSchemaRule_t* rule, const char** values) {
+		if (!vcfginternal_is_object(key)) return 0;
+		rule->section = sectionName;
+		rule->key = key->name;
+
+		int typed = 0;
+		for (uint32_t i = 0; i < key->childCount; i++) {
+			const VCFGKey_t* attribute = &(key->children[i]);
+			const char* value = attribute->value ? attribute->value : "";
+			int isArray = vcfginternal_is_array(attribute);
+			if (!isArray && vcfginternal_is_object(attribute)) return 0;
+
+			if (isArray) {
+				if (vcfginternal_strcmp(attribute->name, "values") != 0) return 0;
+
+				rule->values = values;
+				for (uint32_t v = 0; v < attribute->childCount; v++) {
+					const VCFGKey_t* element = &(attribute->children[v]);
+					if (vcfginternal_is_array(element) || vcfginternal_is_object(element)) return 0;
+					*(values++) = element->value ? element->value : "";
+				}
+				*(values++) = 0;
+			}
+			else if (vcfginternal_strcmp(attribute->name, "type") == 0) {
+				if (!vcfginternal_schema_type(value, &(rule->type))) return 0;
+				typed = 1;
+			}
+			else if (vcfginternal_strcmp(attribute->name, "required") == 0) {
+				int required = 0;
+				if (vcfginternal_parsebool(value, &required) != VCFG_STATUS_OK) return 0;
+				rule->flags = required ? (rule->flags | VCFG_SCHEMA_REQUIRED) : (rule->flags & ~VCFG_SCHEMA_REQUIRED);
+			}
+			else if (vcfginternal_strcmp(attribute->name, "min") == 0) rule->minimum = value;
+			else if (vcfginternal_strcmp(attribute->name, "max") == 0) rule->maximum = value;
+			else if (vcfginternal_strcmp(attribute->name, "pattern") == 0) rule->pattern = value;
+			else return 0;
+		}
+		return typed;
+	}
+
+	/**
+	 *	@brief Compile a schema file.
+	 *
+	 *	Every key of the parsed schema file is a rule for the key of the same name in the same section, written as an
+	 *	object of attributes: type (string, int, float, bool, duration, size, enum, array or object), required (true or false),
+	 *	min and max, pattern and values (an array, for enums):
+	 *
+	 *		port = { type = int, min = 1, max = 65535, required = true }
+	 *		"pool.size" = { type = int, max = 64 }
+	 *
+	 *	The rules refer to the names and values of the schema parser, it has to outlive the schema
+	 *
+	 *	@param schema - receives the compiled schema (free the previous one first)
+	 *	@param schemaParser - the parsed schema file
+	 *
+	 *	@returns 0 - Failure (VCFG_ERROR_INVALID_SCHEMA, see vcfg_get_last_error of the schema parser), 1 - Success
+	 */
+	inline int vcfg_schema_load(VCFGSchema_t* schema, VCFG_Parser* schemaParser) {
+		if (!schema || !schemaParser) return 0;
+		schemaParser->m_lastError = VCFG_ERROR_NONE;
+
+		uint32_t ruleCount = 0;
+		size_t valueSlots = 0;
+		for (uint32_t s = 0; s < schemaParser->m_sectionCount; s++) {
+			const VCFGSection_t* section = &(schemaParser->m_parsedData[s]);
+			ruleCount += section->keyCount;
+			for (uint32_t k = 0; k < section->keyCount; k++) valueSlots += vcfginternal_schema_value_slots(&(section->keys[k]));
+		}
+
+		// The rules and their allowed values share one allocation owned by the schema
+		size_t storageSize = (size_t)ruleCount * sizeof(VCFGSchemaRule_t) + valueSlots * sizeof(const char*);
+		char* storage = (char*)VCFG_CALLOC(storageSize ? storageSize : 1, 1);
+		if (!storage) {
+			vcfginternal_set_error(schemaParser, VCFG_ERROR_OUT_OF_MEMORY);
+			return 0;
+		}
+
+		VCFGSchemaRule_t* rules = (VCFGSchemaRule_t*)storage;
+		const char** values = (const char**)(storage + (size_t)ruleCount * sizeof(VCFGSchemaRule_t));
+		int valid = 1;
+		uint32_t rule = 0;
+		for (uint32_t s = 0; valid && (s < schemaParser->m_sectionCount); s++) {
+			const VCFGSection_t* section = &(schemaParser->m_parsedData[s]);
+			for (uint32_t k = 0; valid && (k < section->keyCount); k++) {
+				valid = vcfginternal_schema_read_rule(&(section->keys[k]), section->name, &(rules[rule++]), values);
+				values += vcfginternal_schema_value_slots(&(section->keys[k]));
+			}
+		}
+
+		if (!valid || !vcfg_schema_compile(schema, rules, ruleCount)) {
+			VCFG_FREE((void*)storage);
+			vcfginternal_set_error(schemaParser, VCFG_ERROR_INVALID_SCHEMA);
+			return 0;
+		}
+		schema->storage = (void*)storage;
+		return 1;
+	}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_SCHEMA_H
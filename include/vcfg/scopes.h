@@ -0,0 +1,264 @@
+﻿/*
+ * scopes.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef VCFG_SCOPES_H
+#define VCFG_SCOPES_H 1
+
+#include "parser.h"
+#include "macros.h"
+#include "hash.h"
+#include "strconv.h"
+#include "index.h"
+#include "implementation.h"
+#include "layers.h"
+#include "compatibility.h"
+
+// Scopes override values for a limited time (e.g. the handling of a single request) without copying or changing
+// the configuration. The overrides live in a small open addressing table inside VCFGScopes_t and every set is
+// recorded, so vcfg_pop_scope undoes the sets of the scope in reverse order. Undoing the last insertion first keeps
+// the probe sequences intact, no entry has to be moved. A lookup probes the table (only when it's not empty)
+// and falls through to the layers. Nothing is allocated, the names and values have to outlive the scope
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+	#include <stdint.h>
+
+	#if (VCFG_MAX_SCOPE_OVERRIDES & (VCFG_MAX_SCOPE_OVERRIDES - 1)) != 0
+		#error "VCFG_MAX_SCOPE_OVERRIDES has to be a power of 2"
+	#endif
+
+	/**
+	 *	@brief Find an override or the empty slot where it would be.
+	 */
+	inline VCFGScopeEntry_t* vcfginternal_scope_probe(VCFGScopes_t* scopes, uint64_t hash, const char* sectionName, const char* keyName) {
+		uint32_t mask = 2 * VCFG_MAX_SCOPE_OVERRIDES - 1;
+		for (uint32_t i = vcfginternal_index_home(hash, 2 * VCFG_MAX_SCOPE_OVERRIDES); ; i = (i + 1) & mask) {
+			VCFGScopeEntry_t* entry = &(scopes->table[i]);
+			if (!(entry->hash)) return entry;
+			if ((entry->hash == hash) && (vcfginternal_strcmp(entry->section, sectionName) == 0) && (vcfginternal_strcmp(entry->key.name, keyName) == 0)) return entry;
+		}
+	}
+
+	/**
+	 *	@brief Find a key in the scopes or in the layers below them.
+	 *
+	 *	@param owner - set to the layer of the key, NULL for an override
+	 *
+	 *	@returns (VCFGKey_t*) the key or NULL if neither the scopes nor the layers have it
+	 */
+	inline const VCFGKey_t* vcfginternal_scopes_find(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName, VCFG_Parser** owner) {
+		*owner = 0;
+		if (scopes->changeCount) {
+			uint64_t hash = vcfginternal_hash_append(vcfginternal_hash_append(VCFG_HASH_SEED, sectionName), keyName);
+			VCFGScopeEntry_t* entry = vcfginternal_scope_probe((VCFGScopes_t*)scopes, hash, sectionName, keyName);
+			if (entry->hash) return &(entry->key);
+		}
+		return scopes->base ? vcfginternal_layers_find(scopes->base, sectionName, keyName, owner) : 0;
+	}
+
+	/**
+	 *	@brief Initialize the scopes.
+	 *
+	 *	@param base - the layers the overrides are set on (has to outlive the scopes, can be NULL)
+	 */
+	inline void vcfg_scopes_init(VCFGScopes_t* scopes, const VCFGLayers_t* base) {
+		scopes->base = base;
+		for (uint32_t i = 0; i < 2 * VCFG_MAX_SCOPE_OVERRIDES; i++) scopes->table[i].hash = 0;
+		scopes->changeCount = 0;
+		scopes->scopeCount = 0;
+	}
+
+	/**
+	 *	@brief Open a scope.
+	 *
+	 *	The overrides set until the matching vcfg_pop_scope are undone by it
+	 *
+	 *	@returns 0 - Failure (VCFG_MAX_SCOPES scopes open already), 1 - Success
+	 */
+	inline int vcfg_push_scope(VCFGScopes_t* scopes) {
+		if (scopes->scopeCount >= VCFG_MAX_SCOPES) return 0;
+
+		scopes->scopeStart[scopes->scopeCount++] = scopes->changeCount;
+		return 1;
+	}
+
+	/**
+	 *	@brief Close the innermost scope.
+	 *
+	 *	Undoes the overrides set in the scope, the values they replaced are visible again.
+	 *	Takes time proportional to the number of sets in the scope
+	 *
+	 *	@returns 0 - Failure (no open scope), 1 - Success
+	 */
+	inline int vcfg_pop_scope(VCFGScopes_t* scopes) {
+		if (!(scopes->scopeCount)) return 0;
+
+		uint32_t start = scopes->scopeStart[--(scopes->scopeCount)];
+		while (scopes->changeCount > start) {
+			const VCFGScopeChange_t* change = &(scopes->changes[--(scopes->changeCount)]);
+			if (change->added) scopes->table[change->slot].hash = 0;
+			else {
+				scopes->table[change->slot].key.value = change->previousValue;
+				scopes->table[change->slot].key.enumCache = 0;
+				scopes->table[change->slot].key.typeTag = vcfginternal_classify_bool(change->previousValue);
+				scopes->table[change->slot].key.quantityTag = VCFG_QUANTITY_UNKNOWN;
+			}
+		}
+		return 1;
+	}
+
+	/**
+	 *	@brief Override a value in the innermost scope.
+	 *
+	 *	The override hides the value of the key in the layers and in the outer scopes until the scope is closed.
+	 *	Only the values of the sections can be overridden, not the keys of arrays and objects
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key
+	 *	@param value - the value (NULL for an empty value)
+	 *
+	 *	@returns 0 - Failure (no open scope or VCFG_MAX_SCOPE_OVERRIDES sets in the open scopes), 1 - Success
+	 */
+	inline int vcfg_scope_set(VCFGScopes_t* scopes, const char* sectionName, const char* keyName, const char* value) {
+		if (!(scopes->scopeCount) || !keyName || (scopes->changeCount >= VCFG_MAX_SCOPE_OVERRIDES)) return 0;
+
+		uint64_t hash = vcfginternal_hash_append(vcfginternal_hash_append(VCFG_HASH_SEED, sectionName), keyName);
+		VCFGScopeEntry_t* entry = vcfginternal_scope_probe(scopes, hash, sectionName, keyName);
+		VCFGScopeChange_t* change = &(scopes->changes[scopes->changeCount++]);
+		change->slot = (uint32_t)(entry - scopes->table);
+		change->added = entry->hash ? 0 : 1;
+		change->previousValue = entry->hash ? entry->key.value : 0;
+
+		if (change->added) {
+			entry->hash = hash;
+			entry->section = sectionName;
+			vcfginternal_init_key(&(entry->key));
+			entry->key.name = (char*)keyName;
+		}
+		entry->key.value = (char*)value;
+		entry->key.enumCache = 0;
+		entry->key.typeTag = vcfginternal_classify_bool(value);
+		entry->key.quantityTag = VCFG_QUANTITY_UNKNOWN;
+		return 1;
+	}
+
+	/**
+	 *	@brief Get key node from the scopes.
+	 *
+	 *	@returns (const VCFG_Node*) the override or the node of the key in the highest layer that has it
+	 */
+	inline const VCFG_Node* vcfg_scope_get_node(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName) {
+		VCFG_Parser* owner;
+		return vcfginternal_scopes_find(scopes, sectionName, keyName, &owner);
+	}
+
+	/**
+	 *	@brief Get string value from the scopes.
+	 *
+	 *	@param sectionName - name of the section (NULL for the root section)
+	 *	@param keyName - name of the key holding the desired value
+	 *
+	 *	@returns (const char*) the override or the value of the key in the highest layer that has it
+	 */
+	inline const char* vcfg_scope_get_string(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName) {
+		VCFG_Parser* owner;
+		const VCFGKey_t* key = vcfginternal_scopes_find(scopes, sectionName, keyName, &owner);
+		return (key ? key->value : 0);
+	}
+
+	/**
+	 *	@brief Get integer value from the scopes.
+	 */
+	inline int64_t vcfg_scope_get_int(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName) {
+		return vcfginternal_strtoint(vcfg_scope_get_string(scopes, sectionName, keyName));
+	}
+
+	/**
+	 *	@brief Get floating point value from the scopes.
+	 */
+	inline double vcfg_scope_get_float(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName) {
+		return vcfginternal_strtofloat(vcfg_scope_get_string(scopes, sectionName, keyName));
+	}
+
+	/**
+	 *	@brief Get boolean value (true|yes|on|1, false|no|off|0 in any case) from the scopes.
+	 */
+	inline int vcfg_scope_get_bool(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName) {
+		VCFG_Parser* owner;
+		int value = 0;
+		vcfginternal_key_to_bool(vcfginternal_scopes_find(scopes, sectionName, keyName, &owner), &value);
+		return value;
+	}
+
+	/**
+	 *	@brief Try to get string value from the scopes.
+	 *
+	 *	@param value - set to the value on success
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK or the reason of the failure
+	 */
+	inline VCFGStatus vcfg_scope_try_get_string(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName, const char** value) {
+		VCFG_Parser* owner;
+		return vcfginternal_key_to_string(vcfginternal_scopes_find(scopes, sectionName, keyName, &owner), value);
+	}
+
+	/**
+	 *	@brief Try to get integer value from the scopes.
+	 */
+	inline VCFGStatus vcfg_scope_try_get_int(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName, int64_t* value) {
+		VCFG_Parser* owner;
+		const VCFGKey_t* key = vcfginternal_scopes_find(scopes, sectionName, keyName, &owner);
+		if (owner || !key) return vcfginternal_key_to_int(owner, key, value);
+
+		// Overrides don't belong to a parser that could record the conversion time
+		return key->value ? vcfginternal_parseint(key->value, value) : VCFG_STATUS_INVALID_FORMAT;
+	}
+
+	/**
+	 *	@brief Try to get floating point value from the scopes.
+	 */
+	inline VCFGStatus vcfg_scope_try_get_float(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName, double* value) {
+		VCFG_Parser* owner;
+		const VCFGKey_t* key = vcfginternal_scopes_find(scopes, sectionName, keyName, &owner);
+		if (owner || !key) return vcfginternal_key_to_float(owner, key, value);
+
+		return key->value ? vcfginternal_parsefloat(key->value, value) : VCFG_STATUS_INVALID_FORMAT;
+	}
+
+	/**
+	 *	@brief Try to get boolean value from the scopes.
+	 */
+	inline VCFGStatus vcfg_scope_try_get_bool(const VCFGScopes_t* scopes, const char* sectionName, const char* keyName, int* value) {
+		VCFG_Parser* owner;
+		return vcfginternal_key_to_bool(vcfginternal_scopes_find(scopes, sectionName, keyName, &owner), value);
+	}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_SCOPES_H
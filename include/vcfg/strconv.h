@@ -33,6 +33,13 @@ extern "C" {
 #endif // __cplusplus
 	#include <stdint.h>
 	#include <stdlib.h>
+	#include <float.h>
+	#include <stdio.h>
+	#include "parser.h"
+	#include "macros.h"
+
+	// Longest number written by vcfginternal_floattobuf (-4.9e-324 without an exponent) with the null terminator
+	#define VCFG_FLOAT_BUFFER_SIZE 346
 
 	/**
 	 *	@brief String to integer conversion.
@@ -44,8 +51,9 @@ extern "C" {
 	inline int64_t vcfginternal_strtoint(const char* str) {
 		if (!str) return -1;
 
+		// Accumulated in unsigned arithmetic, so that too long numbers wrap instead of overflowing (INT64_MIN reads back exactly)
 		int negative = 0;
-		int64_t result = 0;
+		uint64_t result = 0;
 
 		if (*str == '-') {
 			negative = 1;
@@ -59,11 +67,11 @@ extern "C" {
 			if (!VCFG_IS_NUMBER(*str)) break;
 
 			result *= 10;
-			result += (*str) - '0';
+			result += (uint64_t)((*str) - '0');
 			++str;
 		}
 
-		return (negative ? -result : result);
+		return (int64_t)(negative ? (0 - result) : result);
 	}
 
 	/**
@@ -113,39 +121,250 @@ extern "C" {
 	}
 
 	/**
-	 *	@brief Unsigned number to string conversion.
+	 *	@brief Strict string to integer conversion.
 	 *
-	 *	WARNING: this function works only on positive numbers that fit in size_t
-	 *	32bit numbers for 32bit machines and 64bit numbers for 64bit machines!
+	 *	Unlike vcfginternal_strtoint the whole string has to be a number (an optional sign followed by digits)
+	 *
+	 *	@param str - the stringified number
+	 *	@param result - receives the number (only on success)
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK, VCFG_STATUS_INVALID_FORMAT or VCFG_STATUS_OUT_OF_RANGE
+	 */
+	inline VCFGStatus vcfginternal_parseint(const char* str, int64_t* result) {
+		int negative = (*str == '-');
+		if ((*str == '-') || (*str == '+')) ++str;
+		if (!VCFG_IS_NUMBER(*str)) return VCFG_STATUS_INVALID_FORMAT;
+
+		// The magnitude of INT64_MIN is one more than INT64_MAX
+		uint64_t maxMagnitude = negative ? ((uint64_t)INT64_MAX + 1) : (uint64_t)INT64_MAX;
+		uint64_t magnitude = 0;
+		int overflow = 0;
+		for (; *str != '\0'; ++str) {
+			if (!VCFG_IS_NUMBER(*str)) return VCFG_STATUS_INVALID_FORMAT;
+
+			uint64_t digit = (uint64_t)(*str - '0');
+			if (magnitude > (maxMagnitude - digit) / 10) overflow = 1;
+			else magnitude = magnitude * 10 + digit;
+		}
+		if (overflow) return VCFG_STATUS_OUT_OF_RANGE;
+
+		*result = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+		return VCFG_STATUS_OK;
+	}
+
+	/**
+	 *	@brief Strict string to floating point number conversion.
+	 *
+	 *	Unlike vcfginternal_strtofloat the whole string has to be a number
+	 *	(an optional sign followed by digits with at most one dot)
+	 *
+	 *	@param str - the stringified number
+	 *	@param result - receives the number (only on success)
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK, VCFG_STATUS_INVALID_FORMAT or VCFG_STATUS_OUT_OF_RANGE
+	 */
+	inline VCFGStatus vcfginternal_parsefloat(const char* str, double* result) {
+		const char* digits = ((*str == '-') || (*str == '+')) ? (str + 1) : str;
+		int digitCount = 0;
+		int dotCount = 0;
+		for (const char* current = digits; *current != '\0'; ++current) {
+			if (VCFG_IS_NUMBER(*current)) ++digitCount;
+			else if ((*current == '.') && (dotCount++ == 0)) continue;
+			else return VCFG_STATUS_INVALID_FORMAT;
+		}
+		if (!digitCount) return VCFG_STATUS_INVALID_FORMAT;
+
+		double value = vcfginternal_strtofloat(digits);
+		if (*str == '-') value = -value;
+		if ((value > DBL_MAX) || (value < -DBL_MAX)) return VCFG_STATUS_OUT_OF_RANGE;
+
+		*result = value;
+		return VCFG_STATUS_OK;
+	}
+
+	/**
+	 *	@brief Classify a boolean literal.
+	 *
+	 *	Up to 6 characters are packed into a single word with the letters in lowercase, which is compared
+	 *	with every literal at once (the sixth character only makes longer values differ from all of them)
+	 *
+	 *	@param str - the value (true, yes, on, 1, false, no, off or 0 in any case, NULL for an empty value)
+	 *
+	 *	@returns (uint16_t) VCFG_TAG_TRUE, VCFG_TAG_FALSE or VCFG_TAG_OTHER
+	 */
+	inline uint16_t vcfginternal_classify_bool(const char* str) {
+		uint64_t word = 0;
+		for (size_t i = 0; str && str[i] && (i < 6); i++) {
+			uint8_t c = (uint8_t)str[i];
+			c |= (uint8_t)(((uint8_t)(c - 'A') < 26) << 5);
+			word |= (uint64_t)c << (8 * i);
+		}
+
+		// The literals with the first character in the lowest byte ("true" is 0x65757274)
+		uint32_t isTrue = (word == 0x65757274ull) | (word == 0x736579ull) | (word == 0x6e6full) | (word == 0x31ull);
+		uint32_t isFalse = (word == 0x65736c6166ull) | (word == 0x6f6eull) | (word == 0x66666full) | (word == 0x30ull);
+		return (uint16_t)(VCFG_TAG_OTHER + isFalse + 2 * isTrue);
+	}
+
+	/**
+	 *	@brief String to boolean conversion.
+	 *
+	 *	@param str - true, yes, on, 1, false, no, off or 0 in any case
+	 *	@param result - receives 1 for true and 0 for false (only on success)
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK or VCFG_STATUS_INVALID_FORMAT
+	 */
+	inline VCFGStatus vcfginternal_parsebool(const char* str, int* result) {
+		uint32_t tag = vcfginternal_classify_bool(str);
+		if (tag == VCFG_TAG_OTHER) return VCFG_STATUS_INVALID_FORMAT;
+		*result = (tag == VCFG_TAG_TRUE);
+		return VCFG_STATUS_OK;
+	}
+
+	/**
+	 *	@brief 64bit unsigned integer to string conversion.
+	 *
+	 *	Writes the number to the provided buffer without allocating any memory.
+	 *	The digits are produced two at a time from a table, back to front
 	 *
 	 *	@param number - the number to convert
+	 *	@param buffer - the output buffer (at least 21 bytes long)
 	 *
-	 *	@returns (char*) the number as a string (null terminated)
+	 *	@returns (size_t) length of the string (without the null terminator)
 	 */
-	inline char* vcfginternal_unsignednumtostr(size_t number) {
-		char* result = (char*)malloc(22 * sizeof(char));
-		if (!result) return 0;
+	inline size_t vcfginternal_uint64tobuf(uint64_t number, char* buffer) {
+		static const char digitPairs[201] =
+			"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+			"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+			"8081828384858687888990919293949596979899";
 
-		if (number == 0) {
-			result[0] = '0';
-			result[1] = '\0';
-			return result;
+		char digits[20];
+		char* digitPtr = digits + sizeof(digits);
+		while (number >= 100) {
+			const char* pair = digitPairs + (number % 100) * 2;
+			number /= 100;
+			*(--digitPtr) = pair[1];
+			*(--digitPtr) = pair[0];
 		}
+		if (number >= 10) {
+			const char* pair = digitPairs + number * 2;
+			*(--digitPtr) = pair[1];
+			*(--digitPtr) = pair[0];
+		}
+		else {
+			*(--digitPtr) = (char)('0' + number);
+		}
+
+		size_t length = (size_t)(digits + sizeof(digits) - digitPtr);
+		vcfginternal_memcpy((void*)buffer, (const void*)digitPtr, length);
+		buffer[length] = '\0';
+		return length;
+	}
+
+	/**
+	 *	@brief 64bit integer to string conversion.
+	 *
+	 *	@param number - the number to convert
+	 *	@param buffer - the output buffer (at least 21 bytes long)
+	 *
+	 *	@returns (size_t) length of the string (without the null terminator)
+	 */
+	inline size_t vcfginternal_int64tobuf(int64_t number, char* buffer) {
+		if (number >= 0) return vcfginternal_uint64tobuf((uint64_t)number, buffer);
+
+		// Negating INT64_MIN overflows, so the magnitude is computed in unsigned arithmetic
+		buffer[0] = '-';
+		return vcfginternal_uint64tobuf(0 - (uint64_t)number, buffer + 1) + 1;
+	}
 
-		int pos = 0;
-		while (number > 0) {
-			result[pos++] = (number % 10) + '0';
-			number /= 10;
+	/**
+	 *	@brief Floating point number to string conversion.
+	 *
+	 *	Writes the shortest decimal that reads back as exactly the same double. Every decimal
+	 *	with up to 15 significant digits survives the round trip, so the 15 digit rounding (without
+	 *	the trailing zeros) is the shortest one whenever it reads back, otherwise 16 or 17 digits are needed.
+	 *	The number is written without an exponent and always has a decimal point, so it can be read by
+	 *	vcfginternal_strtofloat and isn't mistaken for an integer
+	 *
+	 *	@param number - the number to convert
+	 *	@param buffer - the output buffer (at least VCFG_FLOAT_BUFFER_SIZE bytes long)
+	 *
+	 *	@returns (size_t) length of the string (without the null terminator), 0 for infinities and NaN
+	 */
+	inline size_t vcfginternal_floattobuf(double number, char* buffer) {
+		if ((number != number) || (number > DBL_MAX) || (number < -DBL_MAX)) return 0;
+
+		// Scientific notation with the shortest precision that reads back: d.dddde[+-]xx
+		char scientific[32];
+		for (int precision = 15; precision <= 17; precision++) {
+			snprintf(scientific, sizeof(scientific), "%.*e", precision - 1, number);
+			if ((precision == 17) || (strtod(scientific, 0) == number)) break;
+		}
+
+		// Split it into the significant digits and the exponent
+		const char* scientificPtr = scientific;
+		size_t length = 0;
+		if (*scientificPtr == '-') {
+			buffer[length++] = '-';
+			++scientificPtr;
 		}
 
-		result[pos--] = '\0';
+		char digits[17];
+		int digitCount = 0;
+		for (; (*scientificPtr != 'e') && (*scientificPtr != '\0'); ++scientificPtr) {
+			if (VCFG_IS_NUMBER(*scientificPtr)) digits[digitCount++] = *scientificPtr;
+		}
+		while ((digitCount > 1) && (digits[digitCount - 1] == '0')) --digitCount;
+		int exponent = (*scientificPtr == 'e') ? atoi(scientificPtr + 1) : 0;
 
-		for (int i = 0; i < pos; i++, pos--) {
-			char tmp = result[pos];
-			result[pos] = result[i];
-			result[i] = tmp;
+		// Position of the decimal point relative to the first digit
+		int pointPosition = exponent + 1;
+		if (pointPosition <= 0) {
+			buffer[length++] = '0';
+			buffer[length++] = '.';
+			for (int i = 0; i < -pointPosition; i++) buffer[length++] = '0';
+			for (int i = 0; i < digitCount; i++) buffer[length++] = digits[i];
+		}
+		else {
+			for (int i = 0; i < pointPosition; i++) buffer[length++] = (i < digitCount) ? digits[i] : '0';
+			buffer[length++] = '.';
+			if (pointPosition >= digitCount) buffer[length++] = '0';
+			for (int i = pointPosition; i < digitCount; i++) buffer[length++] = digits[i];
 		}
 
+		buffer[length] = '\0';
+		return length;
+	}
+
+	/**
+	 *	@brief Unsigned number to string conversion.
+	 *
+	 *	Writes the number to the provided buffer without allocating any memory
+	 *
+	 *	@param number - the number to convert
+	 *	@param buffer - the output buffer (at least 21 bytes long)
+	 *
+	 *	@returns (size_t) length of the string (without the null terminator)
+	 */
+	inline size_t vcfginternal_unsignednumtobuf(size_t number, char* buffer) {
+		return vcfginternal_uint64tobuf((uint64_t)number, buffer);
+	}
+
+	/**
+	 *	@brief Unsigned number to string conversion.
+	 *
+	 *	WARNING: this function works only on positive numbers that fit in size_t
+	 *	32bit numbers for 32bit machines and 64bit numbers for 64bit machines!
+	 *
+	 *	@param number - the number to convert
+	 *
+	 *	@returns (char*) the number as a string (null terminated)
+	 */
+	inline char* vcfginternal_unsignednumtostr(size_t number) {
+		char* result = (char*)VCFG_MALLOC(22 * sizeof(char));
+		if (!result) return 0;
+
+		vcfginternal_unsignednumtobuf(number, result);
 		return result;
 	}
 
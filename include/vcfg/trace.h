@@ -0,0 +1,150 @@
+﻿/*
+ * trace.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef VCFG_TRACE_H
+#define VCFG_TRACE_H 1
+
+#include "parser.h"
+#include "macros.h"
+
+// Linux USDT probes (vcfg:open_begin, vcfg:open_end, vcfg:parse_begin, vcfg:section, vcfg:parse_end).
+// A probe that nobody is attached to is a single nop, so they can be left enabled in production builds
+#if defined(VCFG_ENABLE_USDT) && defined(OS_LINUX)
+	#include <sys/sdt.h>
+	#define VCFG_USDT_PROBE(probe, name, value) DTRACE_PROBE2(vcfg, probe, name, value)
+#else
+	#define VCFG_USDT_PROBE(probe, name, value)
+#endif
+
+#if defined(VCFG_ENABLE_TRACING)
+	#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		#include <intrin.h>
+	#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+		#include <x86intrin.h>
+	#elif !defined(__aarch64__)
+		#include <time.h>
+	#endif
+
+	#define VCFG_TIMER_START(timer) uint64_t timer = vcfginternal_cycles()
+	#define VCFG_TIMER_STOP(parserObj, phase, timer) vcfginternal_add_timing(parserObj, phase, vcfginternal_cycles() - (timer))
+	#define VCFG_TRACE_EVENT(parserObj, event, probe, name, value) do { \
+		VCFG_USDT_PROBE(probe, name, value); \
+		vcfginternal_trace(parserObj, event, name, (size_t)(value)); \
+	} while (0)
+#else
+	#define VCFG_TIMER_START(timer)
+	#define VCFG_TIMER_STOP(parserObj, phase, timer)
+	#define VCFG_TRACE_EVENT(parserObj, event, probe, name, value) do { VCFG_USDT_PROBE(probe, name, value); } while (0)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#if defined(VCFG_ENABLE_TRACING)
+	/**
+	 *	@brief Read the cycle counter.
+	 *
+	 *	Uses the time stamp counter on x86, the virtual counter on ARM64
+	 *	and falls back to a nanosecond clock on other platforms
+	 *
+	 *	@returns (uint64_t) current value of the counter
+	 */
+	inline uint64_t vcfginternal_cycles(void) {
+	#if (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))) || ((defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)))
+		return (uint64_t)__rdtsc();
+	#elif defined(__aarch64__)
+		uint64_t counter;
+		__asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(counter));
+		return counter;
+	#else
+		struct timespec now;
+		timespec_get(&now, TIME_UTC);
+		return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+	#endif
+	}
+
+	/**
+	 *	@brief Add the time spent in a phase to the parser timings.
+	 */
+	inline void vcfginternal_add_timing(VCFG_Parser* parserObj, VCFGPhase phase, uint64_t cycles) {
+		parserObj->m_timings.cycles[phase] += cycles;
+		++(parserObj->m_timings.calls[phase]);
+	}
+
+	/**
+	 *	@brief Notify the registered trace callback.
+	 */
+	inline void vcfginternal_trace(VCFG_Parser* parserObj, VCFGTraceEvent event, const char* name, size_t value) {
+		if (parserObj->m_traceCallback) parserObj->m_traceCallback(parserObj->m_traceUserData, event, name, value);
+	}
+
+	/**
+	 *	@brief Set the trace callback.
+	 *
+	 *	The callback is called at the beginning and the end of vcfg_open and vcfg_parse
+	 *	and after every section header that was parsed
+	 *
+	 *	@param callback - the function to call (NULL to disable tracing)
+	 *	@param userData - pointer passed to the callback as the first argument
+	 */
+	inline void vcfg_set_trace_callback(VCFG_Parser* parserObj, VCFGTraceCallback callback, void* userData) {
+		parserObj->m_traceCallback = callback;
+		parserObj->m_traceUserData = userData;
+	}
+
+	/**
+	 *	@brief Get parser timings.
+	 *
+	 *	Returns the number of cycles spent in every phase since the last reset
+	 *
+	 *	@param timings - the structure to fill
+	 *
+	 *	@returns 0 - Failure, 1 - Success
+	 */
+	inline int vcfg_get_timings(VCFG_Parser* parserObj, VCFGTimings_t* timings) {
+		if (!parserObj || !timings) return 0;
+		*timings = parserObj->m_timings;
+		return 1;
+	}
+
+	/**
+	 *	@brief Reset parser timings.
+	 */
+	inline void vcfg_reset_timings(VCFG_Parser* parserObj) {
+		for (int i = 0; i < VCFG_PHASE_COUNT; i++) {
+			parserObj->m_timings.cycles[i] = 0;
+			parserObj->m_timings.calls[i] = 0;
+		}
+	}
+#endif // VCFG_ENABLE_TRACING
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_TRACE_H
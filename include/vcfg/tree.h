@@ -0,0 +1,249 @@
+﻿/*
+ * tree.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef VCFG_TREE_H
+#define VCFG_TREE_H 1
+
+#include "parser.h"
+#include "macros.h"
+#include "memory.h"
+#include "errors.h"
+#include "compatibility.h"
+
+// Dotted section names ([db.primary.pool]) form a tree, [db.primary] and [db] are the parents of the section
+// (they don't have to exist). The section tree holds the positions of the sections sorted by name, in which all
+// the subsections of a section follow each other, so they're found with two binary searches, just like a parent
+// section is found by the name prefix without copying it. The root section is always first and sections with
+// the same name keep the order of the file. The mutation functions keep the tree sorted, vcfg_clear frees it
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+	#include <stdint.h>
+	#include <stdlib.h>
+
+	// A section name and its position, sorted while the tree is built
+	typedef struct VCFGTreeEntry {
+		const char* name;
+		uint32_t section;
+	} VCFGTreeEntry_t;
+
+	/**
+	 *	@brief Compare section names (the root section sorts first).
+	 *
+	 *	The characters are compared as unsigned, like in vcfginternal_compare_path
+	 */
+	inline int vcfginternal_compare_section_names(const char* firstName, const char* secondName) {
+		if (!firstName || !secondName) return (firstName ? 1 : 0) - (secondName ? 1 : 0);
+
+		while ((*firstName == *secondName) && *firstName) {
+			++firstName;
+			++secondName;
+		}
+		return (int)(unsigned char)(*firstName) - (int)(unsigned char)(*secondName);
+	}
+
+	/**
+	 *	@brief Sort the tree entries by name and then by position.
+	 */
+	inline int vcfginternal_compare_tree_entries(const void* first, const void* second) {
+		const VCFGTreeEntry_t* firstEntry = (const VCFGTreeEntry_t*)first;
+		const VCFGTreeEntry_t* secondEntry = (const VCFGTreeEntry_t*)second;
+
+		int result = vcfginternal_compare_section_names(firstEntry->name, secondEntry->name);
+		if (result) return result;
+		return (firstEntry->section < secondEntry->section) ? -1 : (firstEntry->section > secondEntry->section);
+	}
+
+	/**
+	 *	@brief Compare the beginning of a section name with a path.
+	 *
+	 *	@param path - the path (doesn't have to end with '\0')
+	 *	@param pathLength - length of the path
+	 *	@param dotted - 1 to compare with the path followed by a dot (the beginning of the subsection names)
+	 *
+	 *	@returns (int) <0 - the name sorts before the path, 0 - the name starts with the path, >0 - the name sorts after it
+	 */
+	inline int vcfginternal_compare_path(const char* name, const char* path, size_t pathLength, int dotted) {
+		if (!name) return -1;
+
+		for (size_t i = 0; i < pathLength + (dotted ? 1 : 0); i++) {
+			unsigned char expected = (unsigned char)((i < pathLength) ? path[i] : '.');
+			unsigned char actual = (unsigned char)(name[i]);
+			if (actual != expected) return (actual < expected) ? -1 : 1;
+		}
+		return 0;
+	}
+
+	/**
+	 *	@brief Find the first entry of the tree that doesn't sort before a path.
+	 *
+	 *	@param afterPath - 1 to skip the names that start with the path as well
+	 *
+	 *	@returns (uint32_t) position in the tree (the number of sections if there's none)
+	 */
+	inline uint32_t vcfginternal_tree_search(const VCFG_Parser* parserObj, const char* path, size_t pathLength, int dotted, int afterPath) {
+		uint32_t low = 0;
+		uint32_t high = parserObj->m_sectionCount;
+		while (low < high) {
+			uint32_t middle = low + (high - low) / 2;
+			int result = vcfginternal_compare_path(parserObj->m_parsedData[parserObj->m_sectionTree[middle]].name, path, pathLength, dotted);
+			if ((result < 0) || (afterPath && (result == 0))) low = middle + 1;
+			else high = middle;
+		}
+		return low;
+	}
+
+	/**
+	 *	@brief Free the section tree.
+	 */
+	inline void vcfginternal_free_section_tree(VCFG_Parser* parserObj) {
+		vcfginternal_free(parserObj, (void*)(parserObj->m_sectionTree), vcfginternal_array_capacity(parserObj->m_sectionCount) * sizeof(uint32_t));
+		parserObj->m_sectionTree = 0;
+	}
+
+	/**
+	 *	@brief Build the section tree.
+	 *
+	 *	Sorts the sections by name, so that the subsections of a section (see vcfg_get_subsections) and the parents
+	 *	of a dotted section (see vcfg_get_nearest_section) are found with binary searches. The tree is kept up to date
+	 *	by the mutation functions and freed by vcfg_clear. With VCFG_OPTION_NESTED_SECTIONS vcfg_parse builds it after parsing
+	 *
+	 *	@returns 0 - Failure (see vcfg_get_last_error), 1 - Success
+	 */
+	inline int vcfg_build_section_tree(VCFG_Parser* parserObj) {
+		if (!parserObj) return 0;
+		if (parserObj->m_sectionTree) vcfginternal_free_section_tree(parserObj);
+		if (!(parserObj->m_sectionCount)) return 1;
+
+		uint32_t* tree = (uint32_t*)vcfginternal_malloc(parserObj, vcfginternal_array_capacity(parserObj->m_sectionCount) * sizeof(uint32_t));
+		VCFGTreeEntry_t* entries = (VCFGTreeEntry_t*)VCFG_MALLOC(parserObj->m_sectionCount * sizeof(VCFGTreeEntry_t));
+		if (!tree || !entries) {
+			vcfginternal_free(parserObj, (void*)tree, vcfginternal_array_capacity(parserObj->m_sectionCount) * sizeof(uint32_t));
+			VCFG_FREE(entries);
+			vcfginternal_set_error(parserObj, VCFG_ERROR_OUT_OF_MEMORY);
+			return 0;
+		}
+
+		for (uint32_t i = 0; i < parserObj->m_sectionCount; i++) {
+			entries[i].name = parserObj->m_parsedData[i].name;
+			entries[i].section = i;
+		}
+		qsort(entries, parserObj->m_sectionCount, sizeof(VCFGTreeEntry_t), vcfginternal_compare_tree_entries);
+
+		for (uint32_t i = 0; i < parserObj->m_sectionCount; i++) tree[i] = entries[i].section;
+		VCFG_FREE(entries);
+		parserObj->m_sectionTree = tree;
+		return 1;
+	}
+
+	/**
+	 *	@brief Add the section added last to the section tree.
+	 *
+	 *	Called after the section is added to the parsed data. Moves the entries that sort after it one up,
+	 *	which is linear in the number of sections but sections are rarely added after parsing
+	 *
+	 *	@returns 0 - Failure (the tree is freed), 1 - Success
+	 */
+	inline int vcfginternal_section_tree_add(VCFG_Parser* parserObj) {
+		if (!(parserObj->m_sectionTree)) return 1;
+
+		uint32_t section = parserObj->m_sectionCount - 1;
+		uint32_t* tree = (uint32_t*)vcfginternal_grow_array(parserObj, (void*)(parserObj->m_sectionTree), section, sizeof(uint32_t));
+		if (!tree) {
+			// The tree still has the capacity of one section less
+			vcfginternal_free(parserObj, (void*)(parserObj->m_sectionTree), vcfginternal_array_capacity(section) * sizeof(uint32_t));
+			parserObj->m_sectionTree = 0;
+			return 0;
+		}
+		parserObj->m_sectionTree = tree;
+
+		// The new section is the last one, so it goes after the sections with the same name
+		const char* name = parserObj->m_parsedData[section].name;
+		uint32_t position = section;
+		while (position && (vcfginternal_compare_section_names(parserObj->m_parsedData[tree[position - 1]].name, name) > 0)) {
+			tree[position] = tree[position - 1];
+			--position;
+		}
+		tree[position] = section;
+		return 1;
+	}
+
+	/**
+	 *	@brief Find a section by the beginning of a name.
+	 *
+	 *	Uses the section tree when it's built, otherwise compares the names one by one
+	 *
+	 *	@param path - the name (doesn't have to end with '\0', e.g. the parent part of a dotted name)
+	 *	@param pathLength - length of the name
+	 *
+	 *	@returns (VCFGSection_t*) the first section with the name or NULL if there's none
+	 */
+	inline VCFGSection_t* vcfginternal_find_section_path(VCFG_Parser* parserObj, const char* path, size_t pathLength) {
+		if (parserObj->m_sectionTree) {
+			uint32_t position = vcfginternal_tree_search(parserObj, path, pathLength, 0, 0);
+			if (position >= parserObj->m_sectionCount) return 0;
+
+			VCFGSection_t* section = &(parserObj->m_parsedData[parserObj->m_sectionTree[position]]);
+			return ((vcfginternal_compare_path(section->name, path, pathLength, 0) == 0) && (section->name[pathLength] == '\0')) ? section : 0;
+		}
+
+		for (uint32_t i = 1; i < parserObj->m_sectionCount; i++) {
+			VCFGSection_t* section = &(parserObj->m_parsedData[i]);
+			if ((vcfginternal_compare_path(section->name, path, pathLength, 0) == 0) && (section->name[pathLength] == '\0')) return section;
+		}
+		return 0;
+	}
+
+	/**
+	 *	@brief Get all the subsections of a section.
+	 *
+	 *	The subsections of [db] are all the sections whose name starts with "db." ([db.primary], [db.primary.pool], ...),
+	 *	sorted by name. Builds the section tree when there's none, after that it takes two binary searches
+	 *
+	 *	@param sectionName - name of the parent section (it doesn't have to exist)
+	 *	@param sections - set to the positions of the subsections in the parsed data (valid until a section is added)
+	 *
+	 *	@returns (uint32_t) number of subsections (0 on failure, see vcfg_get_last_error)
+	 */
+	inline uint32_t vcfg_get_subsections(VCFG_Parser* parserObj, const char* sectionName, const uint32_t** sections) {
+		if (!parserObj || !sectionName || !sections) return 0;
+		*sections = 0;
+		if (!(parserObj->m_sectionTree) && !vcfg_build_section_tree(parserObj)) return 0;
+		if (!(parserObj->m_sectionTree)) return 0;
+
+		size_t nameLength = vcfginternal_strlen(sectionName);
+		uint32_t first = vcfginternal_tree_search(parserObj, sectionName, nameLength, 1, 0);
+		uint32_t end = vcfginternal_tree_search(parserObj, sectionName, nameLength, 1, 1);
+		*sections = parserObj->m_sectionTree + first;
+		return end - first;
+	}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_TREE_H
@@ -0,0 +1,223 @@
+﻿/*
+ * units.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#ifndef VCFG_UNITS_H
+#define VCFG_UNITS_H 1
+
+#include "parser.h"
+#include "macros.h"
+#include "strconv.h"
+#include "compatibility.h"
+
+// Durations (250ms, 1.5s) and sizes (64KiB) are numbers followed by a unit. With VCFG_OPTION_UNITS they're
+// converted while parsing and the nanoseconds or bytes are stored in the key next to the original text, so
+// vcfg_get_duration_ns and vcfg_get_bytes only load them (see VCFGQuantityTag). The units are
+// case sensitive: ns, us, ms, s, m, h and d for durations, B, KB, MB, GB and TB (powers of 1000) and KiB, MiB, GiB
+// and TiB (powers of 1024) for sizes. A number without a unit is taken as nanoseconds or bytes
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+	#include <stdint.h>
+
+	// Kind of a quantity
+	#define VCFG_UNIT_NONE 0		// A whole number without a unit (nanoseconds or bytes)
+	#define VCFG_UNIT_DURATION 1
+	#define VCFG_UNIT_SIZE 2
+
+	// A unit and its value in nanoseconds or bytes
+	typedef struct VCFGUnit {
+		const char* suffix;
+		uint32_t suffixLength;
+		uint32_t kind;
+		uint64_t multiplier;
+	} VCFGUnit_t;
+
+	// A number converted to nanoseconds or bytes
+	typedef struct VCFGQuantity {
+		uint32_t kind;
+		int64_t value;
+	} VCFGQuantity_t;
+
+	/**
+	 *	@brief Find the unit a number ends with.
+	 *
+	 *	@param suffix - the characters after the number
+	 *	@param length - number of the characters
+	 *
+	 *	@returns (const VCFGUnit_t*) the unit or NULL if the suffix isn't one
+	 */
+	inline const VCFGUnit_t* vcfginternal_find_unit(const char* suffix, size_t length) {
+		static const VCFGUnit_t units[] = {
+			{ "ns", 2, VCFG_UNIT_DURATION, 1ull },
+			{ "us", 2, VCFG_UNIT_DURATION, 1000ull },
+			{ "ms", 2, VCFG_UNIT_DURATION, 1000000ull },
+			{ "s", 1, VCFG_UNIT_DURATION, 1000000000ull },
+			{ "m", 1, VCFG_UNIT_DURATION, 60ull * 1000000000ull },
+			{ "h", 1, VCFG_UNIT_DURATION, 3600ull * 1000000000ull },
+			{ "d", 1, VCFG_UNIT_DURATION, 86400ull * 1000000000ull },
+			{ "B", 1, VCFG_UNIT_SIZE, 1ull },
+			{ "KB", 2, VCFG_UNIT_SIZE, 1000ull },
+			{ "MB", 2, VCFG_UNIT_SIZE, 1000000ull },
+			{ "GB", 2, VCFG_UNIT_SIZE, 1000000000ull },
+			{ "TB", 2, VCFG_UNIT_SIZE, 1000000000000ull },
+			{ "KiB", 3, VCFG_UNIT_SIZE, 1ull << 10 },
+			{ "MiB", 3, VCFG_UNIT_SIZE, 1ull << 20 },
+			{ "GiB", 3, VCFG_UNIT_SIZE, 1ull << 30 },
+			{ "TiB", 3, VCFG_UNIT_SIZE, 1ull << 40 }
+		};
+
+		for (size_t i = 0; i < sizeof(units) / sizeof(units[0]); i++) {
+			if (units[i].suffixLength != length) continue;
+
+			size_t matching = 0;
+			while ((matching < length) && (units[i].suffix[matching] == suffix[matching])) ++matching;
+			if (matching == length) return &(units[i]);
+		}
+		return 0;
+	}
+
+	/**
+	 *	@brief Convert a duration or a size to nanoseconds or bytes.
+	 *
+	 *	The number is made of digits with an optional fraction (1.5s), the fraction is rounded to the nearest
+	 *	nanosecond or byte
+	 *
+	 *	@param str - the value (doesn't have to be null terminated)
+	 *	@param length - length of the value
+	 *	@param quantity - receives the kind and the converted value (the kind also when it's out of range)
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK, VCFG_STATUS_INVALID_FORMAT or VCFG_STATUS_OUT_OF_RANGE
+	 */
+	inline VCFGStatus vcfginternal_parse_quantity(const char* str, size_t length, VCFGQuantity_t* quantity) {
+		quantity->kind = VCFG_UNIT_NONE;
+
+		size_t integerEnd = 0;
+		while ((integerEnd < length) && VCFG_IS_NUMBER(str[integerEnd])) ++integerEnd;
+		if (!integerEnd) return VCFG_STATUS_INVALID_FORMAT;
+
+		size_t numberEnd = integerEnd;
+		if ((numberEnd < length) && (str[numberEnd] == '.')) {
+			while ((++numberEnd < length) && VCFG_IS_NUMBER(str[numberEnd]));
+			if (numberEnd == integerEnd + 1) return VCFG_STATUS_INVALID_FORMAT;
+		}
+
+		// A whole number without a unit is already in nanoseconds or bytes
+		const VCFGUnit_t* unit = 0;
+		if (numberEnd < length) {
+			unit = vcfginternal_find_unit(str + numberEnd, length - numberEnd);
+			if (!unit) return VCFG_STATUS_INVALID_FORMAT;
+		}
+		else if (numberEnd != integerEnd) return VCFG_STATUS_INVALID_FORMAT;
+		quantity->kind = unit ? unit->kind : VCFG_UNIT_NONE;
+		uint64_t multiplier = unit ? unit->multiplier : 1;
+
+		uint64_t value = 0;
+		for (size_t i = 0; i < integerEnd; i++) {
+			uint64_t digit = (uint64_t)(str[i] - '0');
+			if (value > ((uint64_t)INT64_MAX - digit) / 10) return VCFG_STATUS_OUT_OF_RANGE;
+			value = value * 10 + digit;
+		}
+		if (value > (uint64_t)INT64_MAX / multiplier) return VCFG_STATUS_OUT_OF_RANGE;
+		value *= multiplier;
+
+		// The fraction is less than one unit, so a double holds it in nanoseconds or bytes with room to spare
+		if (numberEnd != integerEnd) {
+			double fraction = 0.0;
+			double scale = 1.0;
+			for (size_t i = integerEnd + 1; i < numberEnd; i++) {
+				scale *= 0.1;
+				fraction += (double)(str[i] - '0') * scale;
+			}
+
+			uint64_t fractionValue = (uint64_t)(fraction * (double)multiplier + 0.5);
+			if (fractionValue > (uint64_t)INT64_MAX - value) return VCFG_STATUS_OUT_OF_RANGE;
+			value += fractionValue;
+		}
+
+		quantity->value = (int64_t)value;
+		return VCFG_STATUS_OK;
+	}
+
+	/**
+	 *	@brief Convert a value to nanoseconds or bytes.
+	 *
+	 *	@param str - the null terminated value
+	 *	@param kind - VCFG_UNIT_DURATION or VCFG_UNIT_SIZE (a value of the other kind is invalid)
+	 *	@param result - receives the value (only on success)
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK, VCFG_STATUS_INVALID_FORMAT or VCFG_STATUS_OUT_OF_RANGE
+	 */
+	inline VCFGStatus vcfginternal_parse_unit_value(const char* str, uint32_t kind, int64_t* result) {
+		VCFGQuantity_t quantity;
+		VCFGStatus status = vcfginternal_parse_quantity(str, vcfginternal_strlen(str), &quantity);
+		if ((quantity.kind != VCFG_UNIT_NONE) && (quantity.kind != kind) && (status != VCFG_STATUS_INVALID_FORMAT)) return VCFG_STATUS_INVALID_FORMAT;
+		if (status == VCFG_STATUS_OK) *result = quantity.value;
+		return status;
+	}
+
+	/**
+	 *	@brief Convert the value of a key and store the result in the key (see VCFG_OPTION_UNITS).
+	 *
+	 *	Values out of range are left unconverted, so that the getters report them
+	 *
+	 *	@param length - length of the value
+	 */
+	inline void vcfginternal_cache_quantity(VCFGKey_t* key, size_t length) {
+		VCFGQuantity_t quantity;
+		VCFGStatus status = key->value ? vcfginternal_parse_quantity(key->value, length, &quantity) : VCFG_STATUS_INVALID_FORMAT;
+		key->quantityTag = VCFG_QUANTITY_UNKNOWN;
+		if (status == VCFG_STATUS_INVALID_FORMAT) key->quantityTag = VCFG_QUANTITY_NONE;
+		else if (status == VCFG_STATUS_OK) {
+			key->quantityTag = (uint16_t)(VCFG_QUANTITY_NUMBER + quantity.kind);
+			key->quantity = quantity.value;
+		}
+	}
+
+	/**
+	 *	@brief Convert the value of a key to nanoseconds or bytes.
+	 *
+	 *	Loads the value converted while parsing when there is one
+	 *
+	 *	@param kind - VCFG_UNIT_DURATION or VCFG_UNIT_SIZE (a value of the other kind is invalid)
+	 *	@param result - receives the value (only on success)
+	 *
+	 *	@returns (VCFGStatus) VCFG_STATUS_OK, VCFG_STATUS_INVALID_FORMAT or VCFG_STATUS_OUT_OF_RANGE
+	 */
+	inline VCFGStatus vcfginternal_key_quantity(const VCFGKey_t* key, uint32_t kind, int64_t* result) {
+		uint32_t tag = key->quantityTag;
+		if (tag == VCFG_QUANTITY_UNKNOWN) return vcfginternal_parse_unit_value(key->value ? key->value : "", kind, result);
+		if ((tag != VCFG_QUANTITY_NUMBER) && (tag != VCFG_QUANTITY_NUMBER + kind)) return VCFG_STATUS_INVALID_FORMAT;
+		*result = key->quantity;
+		return VCFG_STATUS_OK;
+	}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_UNITS_H
@@ -0,0 +1,827 @@
+﻿/*
+ * writer.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Michał Pazurek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef VCFG_WRITER_H
+#define VCFG_WRITER_H 1
+
+#include "parser.h"
+#include "macros.h"
+#include "errors.h"
+#include "layout.h"
+#include "strconv.h"
+#include "checksum.h"
+
+#if !defined(VCFG_BUFFER_ONLY)
+	#include <stdio.h>
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <sys/stat.h>
+	#if defined(OS_WINDOWS)
+		#include <io.h>
+		#include <process.h>
+		#include <windows.h>
+	#else
+		#include <unistd.h>
+	#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+	#include <stdlib.h>
+
+	// The output is collected in a fixed chunk on the stack and handed to the sink when it's full,
+	// so writing never allocates and the sink is called once per VCFG_WRITE_BUFFER_SIZE bytes
+	typedef struct VCFGWriter {
+		VCFG_Parser* parserObj;
+		const VCFGSink_t* sink;
+		uint32_t flags;
+		uint32_t crc;		// Inverted CRC-32C of everything passed to the sink (VCFG_WRITE_CHECKSUM)
+		char lastChar;		// Last character passed to the sink
+		size_t used;
+		char buffer[VCFG_WRITE_BUFFER_SIZE];
+	} VCFGWriter_t;
+
+	/**
+	 *	@brief Pass data to the sink.
+	 */
+	inline void vcfginternal_writer_emit(VCFGWriter_t* writer, const char* data, size_t length) {
+		if (!length || writer->parserObj->m_lastError) return;
+
+		if (writer->flags & VCFG_WRITE_CHECKSUM) writer->crc = vcfginternal_crc32c_update(writer->crc, data, length);
+		writer->lastChar = data[length - 1];
+		if (writer->sink->write(writer->sink->userData, data, length) != length) vcfginternal_set_error(writer->parserObj, VCFG_ERROR_IO);
+	}
+
+	/**
+	 *	@brief Pass the buffered output to the sink.
+	 */
+	inline void vcfginternal_writer_flush(VCFGWriter_t* writer) {
+		vcfginternal_writer_emit(writer, writer->buffer, writer->used);
+		writer->used = 0;
+	}
+
+	/**
+	 *	@brief Append data to the output.
+	 *
+	 *	Data that doesn't fit in an empty chunk (long strings) is passed to the sink directly
+	 */
+	inline void vcfginternal_writer_put(VCFGWriter_t* writer, const char* data, size_t length) {
+		if (writer->parserObj->m_lastError) return;
+
+		if (length > VCFG_WRITE_BUFFER_SIZE - writer->used) {
+			vcfginternal_writer_flush(writer);
+			if (length > VCFG_WRITE_BUFFER_SIZE) {
+				vcfginternal_writer_emit(writer, data, length);
+				return;
+			}
+		}
+
+		vcfginternal_memcpy((void*)(writer->buffer + writer->used), (const void*)data, length);
+		writer->used += length;
+	}
+
+	/**
+	 *	@brief Append a single character to the output.
+	 */
+	inline void vcfginternal_writer_putc(VCFGWriter_t* writer, char ch) {
+		if (writer->used == VCFG_WRITE_BUFFER_SIZE) vcfginternal_writer_flush(writer);
+		writer->buffer[writer->used++] = ch;
+	}
+
+	/**
+	 *	@brief Append the indentation of a nesting level (pretty output only).
+	 */
+	inline void vcfginternal_writer_indent(VCFGWriter_t* writer, uint32_t depth) {
+		if (writer->flags & VCFG_WRITE_COMPACT) return;
+		for (uint32_t i = 0; i < depth; i++) vcfginternal_writer_putc(writer, '\t');
+	}
+
+	/**
+	 *	@brief Check how a name or value has to be written.
+	 *
+	 *	Text that would end early when unquoted (whitespace, separators, closing brackets) or that starts
+	 *	like a quoted string, container, section or comment has to be quoted. Quoted text ends at the
+	 *	first quote and there are no escape sequences, so such text can't contain quotes at all
+	 *
+	 *	@param text - the name or value (NULL for an empty value)
+	 *	@param isName - 1 for key names that can't be empty, 0 for values
+	 *	@param length - set to the length of the text (it's scanned anyway)
+	 *
+	 *	@returns (int) 0 - as is, 1 - in quotes, -1 - not representable
+	 */
+	inline int vcfginternal_write_quoting(const char* text, int isName, size_t* length) {
+		*length = 0;
+		if (!text || !(*text)) return isName ? -1 : 1;
+
+		int needsQuotes = (*text == '"') || (*text == '[') || (*text == '{') || (*text == '/');
+		int hasQuotes = 0;
+		const char* ch = text;
+		for (; *ch; ch++) {
+			if (*ch == '"') hasQuotes = 1;
+			else if (VCFG_IS_WHITESPACE(*ch) || (*ch == '=') || (*ch == ',') || (*ch == ';') || (*ch == ']') || (*ch == '}')) needsQuotes = 1;
+		}
+		*length = (size_t)(ch - text);
+
+		if (!needsQuotes) return 0;
+		return hasQuotes ? -1 : 1;
+	}
+
+	/**
+	 *	@brief Append a name or a value, in quotes when needed.
+	 *
+	 *	The values of a parser with VCFG_OPTION_INTERPOLATE were resolved, every ${ left in them is literal
+	 *	and is written escaped as $${ so that parsing the output with the same options gives the same value
+	 */
+	inline void vcfginternal_write_text(VCFGWriter_t* writer, const char* text, int isName) {
+		size_t length;
+		int quoting = vcfginternal_write_quoting(text, isName, &length);
+		if (quoting < 0) {
+			vcfginternal_set_error(writer->parserObj, VCFG_ERROR_NOT_REPRESENTABLE);
+			return;
+		}
+
+		if (quoting) vcfginternal_writer_putc(writer, '"');
+		size_t start = 0;
+		if (!isName && (writer->parserObj->m_options & VCFG_OPTION_INTERPOLATE)) {
+			for (size_t i = 0; i + 1 < length; i++) {
+				if ((text[i] != '$') || (text[i + 1] != '{')) continue;
+				vcfginternal_writer_put(writer, text + start, i + 1 - start);
+				vcfginternal_writer_putc(writer, '$');
+				start = i + 1;
+			}
+		}
+		if (length > start) vcfginternal_writer_put(writer, text + start, length - start);
+		if (quoting) vcfginternal_writer_putc(writer, '"');
+	}
+
+	/**
+	 *	@brief Check if a section name can be written.
+	 *
+	 *	Section names end at the first ] or : (the name of the parent follows) and can't be empty
+	 */
+	inline int vcfginternal_write_section_name_valid(const char* name) {
+		if (!name || !(*name)) return 0;
+		for (const char* ch = name; *ch; ch++) {
+			if ((*ch == ']') || (*ch == ':')) return 0;
+		}
+		return 1;
+	}
+
+	/**
+	 *	@brief Get the order to write keys in.
+	 *
+	 *	Keys are written in the order they appear in the configuration file (array elements have to be)
+	 *	even after vcfg_optimize_layout. The order is only allocated when the layout differs from it
+	 *
+	 *	@returns (uint32_t*) positions of the keys in the source order (freed with VCFG_FREE)
+	 *	or NULL when the keys are in the source order or on failure
+	 */
+	inline uint32_t* vcfginternal_write_order(VCFGWriter_t* writer, const VCFGKey_t* keys, uint32_t keyCount) {
+		uint32_t inOrder = 0;
+		while ((inOrder < keyCount) && (keys[inOrder].sourceIndex == inOrder)) ++inOrder;
+		if (inOrder == keyCount) return 0;
+
+		uint32_t* order = (uint32_t*)VCFG_MALLOC(keyCount * sizeof(uint32_t));
+		if (!order) {
+			vcfginternal_set_error(writer->parserObj, VCFG_ERROR_OUT_OF_MEMORY);
+			return 0;
+		}
+		vcfg_get_source_order(keys, keyCount, order);
+		return order;
+	}
+
+	/**
+	 *	@brief Append a key.
+	 *
+	 *	Writes the key and its value, recursing into arrays and objects. The names of the
+	 *	array elements are their indices, so they are omitted
+	 *
+	 *	@param writeName - 0 for array elements, 1 otherwise
+	 *	@param depth - nesting level of the key (0 for the keys of a section)
+	 */
+	inline void vcfginternal_write_key(VCFGWriter_t* writer, const VCFGKey_t* key, int writeName, uint32_t depth) {
+		int compact = (writer->flags & VCFG_WRITE_COMPACT) ? 1 : 0;
+		if (writeName) {
+			vcfginternal_write_text(writer, key->name, 1);
+			if (compact) vcfginternal_writer_putc(writer, '=');
+			else vcfginternal_writer_put(writer, " = ", 3);
+		}
+
+		int isArray = key->value && (vcfginternal_strcmp(key->value, "[array]") == 0);
+		int isObject = !isArray && key->value && (vcfginternal_strcmp(key->value, "{object}") == 0);
+		if (!isArray && !isObject) {
+			vcfginternal_write_text(writer, key->value, 0);
+			return;
+		}
+
+		uint32_t* order = vcfginternal_write_order(writer, key->children, key->childCount);
+		vcfginternal_writer_putc(writer, isArray ? '[' : '{');
+		for (uint32_t i = 0; (i < key->childCount) && !(writer->parserObj->m_lastError); i++) {
+			if (i) vcfginternal_writer_putc(writer, ',');
+			if (!compact) vcfginternal_writer_putc(writer, '\n');
+			vcfginternal_writer_indent(writer, depth + 1);
+			vcfginternal_write_key(writer, &(key->children[order ? order[i] : i]), isObject, depth + 1);
+		}
+		VCFG_FREE(order);
+		if (!compact && key->childCount) {
+			vcfginternal_writer_putc(writer, '\n');
+			vcfginternal_writer_indent(writer, depth);
+		}
+		vcfginternal_writer_putc(writer, isArray ? ']' : '}');
+	}
+
+#if defined(VCFG_ENABLE_LOSSLESS)
+	// State of a write that keeps the parsed text (see VCFG_WRITE_PRESERVE_FORMATTING). The configuration buffer
+	// is copied in as few pieces as possible, only the changed values and the added keys are formatted
+	typedef struct VCFGSplice {
+		VCFGWriter_t* writer;
+		const char* data;
+		size_t length;
+		size_t cursor;			// Everything before it was already copied or left out
+		uint32_t removed;		// First removed span that doesn't end before the cursor
+		const char* newline;	// "\n" or "\r\n", whichever the file uses
+		size_t newlineLength;
+		int atLineStart;		// The output ends with a new line (or is empty)
+		int empty;
+	} VCFGSplice_t;
+
+	inline int vcfginternal_compare_spans(const void* first, const void* second) {
+		size_t firstOffset = ((const VCFGSpan_t*)first)->offset;
+		size_t secondOffset = ((const VCFGSpan_t*)second)->offset;
+		return (firstOffset > secondOffset) - (firstOffset < secondOffset);
+	}
+
+	/**
+	 *	@brief Copy the configuration buffer up to an offset, leaving out the removed keys.
+	 */
+	inline void vcfginternal_splice_copy(VCFGSplice_t* splice, size_t offset) {
+		const VCFGSpan_t* removedSpans = splice->writer->parserObj->m_removedSpans;
+		uint32_t removedCount = splice->writer->parserObj->m_removedCount;
+		if (offset > splice->length) offset = splice->length;
+
+		while (splice->cursor < offset) {
+			while ((splice->removed < removedCount) && (removedSpans[splice->removed].offset + removedSpans[splice->removed].length <= splice->cursor)) ++(splice->removed);
+			if ((splice->removed < removedCount) && (removedSpans[splice->removed].offset <= splice->cursor)) {
+				splice->cursor = removedSpans[splice->removed].offset + removedSpans[splice->removed].length;
+				continue;
+			}
+
+			size_t end = offset;
+			if ((splice->removed < removedCount) && (removedSpans[splice->removed].offset < end)) end = removedSpans[splice->removed].offset;
+			vcfginternal_writer_put(splice->writer, splice->data + splice->cursor, end - splice->cursor);
+			splice->atLineStart = (splice->data[end - 1] == '\n');
+			splice->empty = 0;
+			splice->cursor = end;
+		}
+	}
+
+	/**
+	 *	@brief Leave out the configuration buffer up to an offset.
+	 */
+	inline void vcfginternal_splice_skip(VCFGSplice_t* splice, size_t offset) {
+		if (offset > splice->cursor) splice->cursor = offset;
+	}
+
+	/**
+	 *	@brief Append a key that wasn't parsed.
+	 */
+	inline void vcfginternal_splice_add_key(VCFGSplice_t* splice, const VCFGKey_t* key, int writeName, uint32_t depth) {
+		vcfginternal_write_key(splice->writer, key, writeName, depth);
+		splice->atLineStart = 0;
+		splice->empty = 0;
+	}
+
+	/**
+	 *	@brief Append a new line followed by the indentation of the line an offset is on.
+	 */
+	inline void vcfginternal_splice_new_line(VCFGSplice_t* splice, size_t offset) {
+		size_t lineStart = offset;
+		while ((lineStart > 0) && (splice->data[lineStart - 1] != '\n')) --lineStart;
+		size_t indentEnd = lineStart;
+		while ((indentEnd < offset) && ((splice->data[indentEnd] == ' ') || (splice->data[indentEnd] == '\t'))) ++indentEnd;
+
+		vcfginternal_writer_put(splice->writer, splice->newline, splice->newlineLength);
+		vcfginternal_writer_put(splice->writer, splice->data + lineStart, indentEnd - lineStart);
+	}
+
+	/**
+	 *	@brief Find the end of the line after an offset.
+	 *
+	 *	Keys of a section are added at the end of the line of the previous key, after its comment.
+	 *	When something else follows on the same line (another key, a block comment) they are added right after the offset
+	 *
+	 *	@returns (size_t) offset to add the keys at
+	 */
+	inline size_t vcfginternal_splice_line_end(const VCFGSplice_t* splice, size_t offset) {
+		const char* data = splice->data;
+		size_t end = offset;
+		while ((end < splice->length) && ((data[end] == ' ') || (data[end] == '\t'))) ++end;
+
+		if ((end + 1 < splice->length) && (data[end] == '/') && (data[end + 1] == '/')) {
+			while ((end < splice->length) && (data[end] != '\n')) ++end;
+			if ((end < splice->length) && (data[end - 1] == '\r')) --end;
+			return end;
+		}
+		if ((end == splice->length) || (data[end] == '\n') || (data[end] == '\r')) return end;
+		return offset;
+	}
+
+	/**
+	 *	@brief Check if the elements of an array or object are on separate lines.
+	 *
+	 *	@param offset - end of an element
+	 */
+	inline int vcfginternal_splice_multiline(const VCFGSplice_t* splice, size_t offset) {
+		const char* data = splice->data;
+		size_t end = offset;
+		while ((end < splice->length) && ((data[end] == ' ') || (data[end] == '\t') || (data[end] == ','))) ++end;
+		return (end == splice->length) || (data[end] == '\n') || (data[end] == '\r') || ((end + 1 < splice->length) && (data[end] == '/') && (data[end + 1] == '/'));
+	}
+
+	/**
+	 *	@brief Check if nothing but indentation precedes an offset on its line.
+	 */
+	inline int vcfginternal_splice_starts_line(const VCFGSplice_t* splice, size_t offset) {
+		while ((offset > 0) && ((splice->data[offset - 1] == ' ') || (splice->data[offset - 1] == '\t'))) --offset;
+		return (offset == 0) || (splice->data[offset - 1] == '\n');
+	}
+
+	/**
+	 *	@brief Write the keys of a section or node keeping the parsed text.
+	 *
+	 *	Unchanged keys are copied, changed values are replaced in place and keys added after parsing
+	 *	are written after the parsed key preceding them in the source order, separated the same way
+	 *	as the parsed keys (on a new line with the same indentation or after a comma)
+	 *
+	 *	@param parent - the array or object (NULL for the keys of a section)
+	 *	@param openOffset - where keys are added when none of them was parsed (after the [ or { of the parent
+	 *	or at the end of the section header line, 0 for the root section)
+	 *	@param depth - nesting level of the keys
+	 */
+	inline void vcfginternal_splice_keys(VCFGSplice_t* splice, const VCFGKey_t* keys, uint32_t keyCount, const VCFGKey_t* parent, size_t openOffset, uint32_t depth) {
+		VCFGWriter_t* writer = splice->writer;
+		int isArray = parent && parent->value && (vcfginternal_strcmp(parent->value, "[array]") == 0);
+		uint32_t* order = vcfginternal_write_order(writer, keys, keyCount);
+
+		const VCFGKey_t* firstParsed = 0;
+		for (uint32_t i = 0; (i < keyCount) && !firstParsed; i++) {
+			if (keys[order ? order[i] : i].sourceFlags & VCFG_SOURCE_PARSED) firstParsed = &(keys[order ? order[i] : i]);
+		}
+
+		const VCFGKey_t* previous = 0;
+		int addedAtOpen = 0;
+		for (uint32_t i = 0; (i < keyCount) && !(writer->parserObj->m_lastError); i++) {
+			const VCFGKey_t* key = &(keys[order ? order[i] : i]);
+			if (key->sourceFlags & VCFG_SOURCE_PARSED) {
+				if (key->sourceFlags & VCFG_SOURCE_EDITED) {
+					vcfginternal_splice_copy(splice, key->valueOffset);
+					vcfginternal_write_key(writer, key, 0, depth);
+					splice->atLineStart = 0;
+					vcfginternal_splice_skip(splice, key->valueOffset + key->valueLength);
+				}
+				else if (key->childCount) {
+					vcfginternal_splice_keys(splice, key->children, key->childCount, key, key->valueOffset + 1, depth + 1);
+				}
+				previous = key;
+				continue;
+			}
+
+			// After the previous parsed key
+			if (previous) {
+				size_t previousEnd = previous->valueOffset + previous->valueLength;
+				if (!parent) {
+					vcfginternal_splice_copy(splice, vcfginternal_splice_line_end(splice, previousEnd));
+					vcfginternal_splice_new_line(splice, previous->entryOffset);
+				}
+				else {
+					vcfginternal_splice_copy(splice, previousEnd);
+					vcfginternal_writer_putc(writer, ',');
+					if (vcfginternal_splice_multiline(splice, previousEnd)) vcfginternal_splice_new_line(splice, previous->entryOffset);
+					else vcfginternal_writer_putc(writer, ' ');
+				}
+				vcfginternal_splice_add_key(splice, key, !isArray, depth);
+			}
+			// In front of the first parsed key
+			else if (firstParsed) {
+				vcfginternal_splice_copy(splice, firstParsed->entryOffset);
+				vcfginternal_splice_add_key(splice, key, !isArray, depth);
+				if (parent) vcfginternal_writer_putc(writer, ',');
+				if (!parent || vcfginternal_splice_starts_line(splice, firstParsed->entryOffset)) vcfginternal_splice_new_line(splice, firstParsed->entryOffset);
+				else vcfginternal_writer_putc(writer, ' ');
+			}
+			// Nothing was parsed, right after the opening bracket or the section header
+			else {
+				vcfginternal_splice_copy(splice, openOffset);
+				if (parent && addedAtOpen) vcfginternal_writer_put(writer, ", ", 2);
+				else if (!parent && openOffset) vcfginternal_writer_put(writer, splice->newline, splice->newlineLength);
+				vcfginternal_splice_add_key(splice, key, !isArray, depth);
+				if (!parent && !openOffset) {
+					vcfginternal_writer_put(writer, splice->newline, splice->newlineLength);
+					splice->atLineStart = 1;
+				}
+				addedAtOpen = 1;
+			}
+		}
+		VCFG_FREE(order);
+	}
+
+	/**
+	 *	@brief Write the configuration keeping the parsed text.
+	 *
+	 *	The parsed sections are written by splicing the changes into the configuration buffer,
+	 *	the sections added after parsing are appended at the end
+	 */
+	inline void vcfginternal_splice_write(VCFGWriter_t* writer) {
+		VCFG_Parser* parserObj = writer->parserObj;
+
+		VCFGSplice_t splice;
+		splice.writer = writer;
+		splice.data = parserObj->m_configBuffer;
+		splice.length = parserObj->m_configBufferLength;
+		splice.cursor = 0;
+		splice.removed = 0;
+		splice.newline = "\n";
+		splice.newlineLength = 1;
+		splice.atLineStart = 1;
+		splice.empty = 1;
+
+		for (size_t i = 0; i < splice.length; i++) {
+			if (splice.data[i] != '\n') continue;
+			if (i && (splice.data[i - 1] == '\r')) {
+				splice.newline = "\r\n";
+				splice.newlineLength = 2;
+			}
+			break;
+		}
+
+		// The removed keys are left out in the order they appear in the buffer
+		if (parserObj->m_removedCount > 1) qsort(parserObj->m_removedSpans, parserObj->m_removedCount, sizeof(VCFGSpan_t), vcfginternal_compare_spans);
+
+		for (uint32_t i = 0; (i < parserObj->m_sectionCount) && !(parserObj->m_lastError); i++) {
+			const VCFGSection_t* section = &(parserObj->m_parsedData[i]);
+			if (!(section->sourceFlags & VCFG_SOURCE_PARSED)) continue;
+
+			size_t openOffset = section->headerEnd ? vcfginternal_splice_line_end(&splice, section->headerEnd) : 0;
+			vcfginternal_splice_keys(&splice, section->keys, section->keyCount, 0, openOffset, 0);
+		}
+		vcfginternal_splice_copy(&splice, splice.length);
+
+		for (uint32_t i = 0; (i < parserObj->m_sectionCount) && !(parserObj->m_lastError); i++) {
+			const VCFGSection_t* section = &(parserObj->m_parsedData[i]);
+			if (section->sourceFlags & VCFG_SOURCE_PARSED) continue;
+
+			// A root section that wasn't parsed (nothing was) has no header
+			if (section->name) {
+				if (!vcfginternal_write_section_name_valid(section->name)) {
+					vcfginternal_set_error(parserObj, VCFG_ERROR_NOT_REPRESENTABLE);
+					break;
+				}
+				if (!splice.atLineStart) vcfginternal_writer_put(writer, splice.newline, splice.newlineLength);
+				if (!(writer->flags & VCFG_WRITE_COMPACT) && !splice.empty) vcfginternal_writer_put(writer, splice.newline, splice.newlineLength);
+				vcfginternal_writer_putc(writer, '[');
+				vcfginternal_writer_put(writer, section->name, vcfginternal_strlen(section->name));
+				vcfginternal_writer_putc(writer, ']');
+				vcfginternal_writer_put(writer, splice.newline, splice.newlineLength);
+			}
+
+			uint32_t* order = vcfginternal_write_order(writer, section->keys, section->keyCount);
+			for (uint32_t k = 0; (k < section->keyCount) && !(parserObj->m_lastError); k++) {
+				vcfginternal_write_key(writer, &(section->keys[order ? order[k] : k]), 1, 0);
+				vcfginternal_writer_put(writer, splice.newline, splice.newlineLength);
+			}
+			VCFG_FREE(order);
+			splice.atLineStart = 1;
+			splice.empty = 0;
+		}
+	}
+#endif // VCFG_ENABLE_LOSSLESS
+
+	/**
+	 *	@brief Write the configuration.
+	 *
+	 *	Serializes the parsed data in the configuration syntax, the keys of the root section first,
+	 *	then every section under its [name] header. Keys are written in the source order (see vcfg_optimize_layout)
+	 *	and values as they were parsed (with references resolved, the literal ${ of the values is escaped as $${),
+	 *	in quotes only when they need them. The output goes to the sink in VCFG_WRITE_BUFFER_SIZE chunks
+	 *	and writing fails with VCFG_ERROR_IO when the sink doesn't accept a whole chunk
+	 *	or with VCFG_ERROR_NOT_REPRESENTABLE on names and values that can't be parsed back
+	 *	(see vcfg_get_last_error). The sink may have received part of the output in both cases.
+	 *	With VCFG_ENABLE_LOSSLESS and VCFG_WRITE_PRESERVE_FORMATTING the configuration buffer the data was parsed from
+	 *	is written instead, with only the changed values replaced, the removed keys left out and the added keys
+	 *	(formatted according to the other flags) inserted next to their neighbours. Comments, whitespace and
+	 *	the quoting of the unchanged values stay exactly as they were.
+	 *	With VCFG_WRITE_CHECKSUM the output ends with a comment holding its CRC-32C, which vcfg_open verifies
+	 *	before parsing, so that a truncated or corrupted file is rejected (see vcfg_verify_checksum)
+	 *
+	 *	@param sink - the destination (see vcfg_buffer_sink, vcfg_file_sink and vcfg_fd_sink)
+	 *	@param flags - VCFGWriteFlags combined with |
+	 *
+	 *	@returns 0 - Failure, 1 - Success
+	 */
+	inline int vcfg_write(VCFG_Parser* parserObj, const VCFGSink_t* sink, uint32_t flags) {
+		if (!parserObj || !sink || !(sink->write)) return 0;
+		parserObj->m_lastError = VCFG_ERROR_NONE;
+
+		VCFGWriter_t writer;
+		writer.parserObj = parserObj;
+		writer.sink = sink;
+		writer.flags = flags;
+		writer.crc = 0xffffffff;
+		writer.lastChar = '\n';
+		writer.used = 0;
+
+	#if defined(VCFG_ENABLE_LOSSLESS)
+		if ((flags & VCFG_WRITE_PRESERVE_FORMATTING) && parserObj->m_configBuffer) vcfginternal_splice_write(&writer);
+		else
+	#endif
+		for (uint32_t i = 0; (i < parserObj->m_sectionCount) && !(parserObj->m_lastError); i++) {
+			const VCFGSection_t* section = &(parserObj->m_parsedData[i]);
+
+			// The root section has no header
+			if (i) {
+				if (!vcfginternal_write_section_name_valid(section->name)) {
+					vcfginternal_set_error(parserObj, VCFG_ERROR_NOT_REPRESENTABLE);
+					break;
+				}
+				if (!(flags & VCFG_WRITE_COMPACT) && ((i > 1) || parserObj->m_parsedData[0].keyCount)) vcfginternal_writer_putc(&writer, '\n');
+				vcfginternal_writer_putc(&writer, '[');
+				vcfginternal_writer_put(&writer, section->name, vcfginternal_strlen(section->name));
+				if (section->parent) {
+					const char* parentName = parserObj->m_parsedData[section->parent].name;
+					vcfginternal_writer_put(&writer, " : ", 3);
+					vcfginternal_writer_put(&writer, parentName, vcfginternal_strlen(parentName));
+				}
+				vcfginternal_writer_put(&writer, "]\n", 2);
+			}
+
+			uint32_t* order = vcfginternal_write_order(&writer, section->keys, section->keyCount);
+			for (uint32_t k = 0; (k < section->keyCount) && !(parserObj->m_lastError); k++) {
+				vcfginternal_write_key(&writer, &(section->keys[order ? order[k] : k]), 1, 0);
+				vcfginternal_writer_putc(&writer, '\n');
+			}
+			VCFG_FREE(order);
+		}
+		vcfginternal_writer_flush(&writer);
+
+		// The trailer has to start on its own line, the new line before it is part of the checked data
+		if (flags & VCFG_WRITE_CHECKSUM) {
+			if (writer.lastChar != '\n') vcfginternal_writer_emit(&writer, "\n", 1);
+
+			char trailer[VCFG_CHECKSUM_TRAILER_LENGTH];
+			vcfginternal_format_checksum(~writer.crc, trailer);
+			if (!(parserObj->m_lastError) && (sink->write(sink->userData, trailer, VCFG_CHECKSUM_TRAILER_LENGTH) != VCFG_CHECKSUM_TRAILER_LENGTH)) vcfginternal_set_error(parserObj, VCFG_ERROR_IO);
+		}
+
+		return (parserObj->m_lastError == VCFG_ERROR_NONE) ? 1 : 0;
+	}
+
+	inline size_t vcfginternal_buffer_sink_write(void* userData, const char* data, size_t length) {
+		VCFGBufferSink_t* buffer = (VCFGBufferSink_t*)userData;
+		if (length > buffer->capacity - buffer->length) {
+			if (!(buffer->growable)) return 0;
+
+			size_t newCapacity = buffer->capacity ? buffer->capacity : VCFG_WRITE_BUFFER_SIZE;
+			while (newCapacity - buffer->length < length) newCapacity <<= 1;
+			char* newData = (char*)VCFG_REALLOC((void*)(buffer->data), newCapacity);
+			if (!newData) return 0;
+			buffer->data = newData;
+			buffer->capacity = newCapacity;
+		}
+
+		vcfginternal_memcpy((void*)(buffer->data + buffer->length), (const void*)data, length);
+		buffer->length += length;
+		return length;
+	}
+
+	/**
+	 *	@brief Create a memory sink.
+	 *
+	 *	The output is appended to the data of the buffer. A growable buffer can start empty
+	 *	and is grown with VCFG_REALLOC (the caller frees the data with VCFG_FREE),
+	 *	a fixed buffer fails the write when the output doesn't fit
+	 *
+	 *	@param buffer - the buffer to append to (has to outlive the sink)
+	 *
+	 *	@returns (VCFGSink_t) the sink
+	 */
+	inline VCFGSink_t vcfg_buffer_sink(VCFGBufferSink_t* buffer) {
+		VCFGSink_t sink = { vcfginternal_buffer_sink_write, (void*)buffer };
+		return sink;
+	}
+
+#if !defined(VCFG_BUFFER_ONLY)
+	inline size_t vcfginternal_file_sink_write(void* userData, const char* data, size_t length) {
+		return fwrite((const void*)data, sizeof(char), length, (FILE*)userData);
+	}
+
+	inline size_t vcfginternal_fd_sink_write(void* userData, const char* data, size_t length) {
+		int fd = (int)(intptr_t)userData;
+		size_t written = 0;
+
+		// write() can accept only a part of the data (pipes, sockets, signals)
+		while (written < length) {
+		#if defined(OS_WINDOWS)
+			size_t chunk = length - written;
+			if (chunk > 0x40000000) chunk = 0x40000000;
+			int result = _write(fd, (const void*)(data + written), (unsigned int)chunk);
+		#else
+			ssize_t result = write(fd, (const void*)(data + written), length - written);
+		#endif
+			if (result < 0) {
+				if (errno == EINTR) continue;
+				break;
+			}
+			if (result == 0) break;
+			written += (size_t)result;
+		}
+		return written;
+	}
+
+	/**
+	 *	@brief Create a stdio sink.
+	 *
+	 *	@param file - a file opened for writing (the caller closes it)
+	 *
+	 *	@returns (VCFGSink_t) the sink
+	 */
+	inline VCFGSink_t vcfg_file_sink(FILE* file) {
+		VCFGSink_t sink = { vcfginternal_file_sink_write, (void*)file };
+		return sink;
+	}
+
+	/**
+	 *	@brief Create a file descriptor sink.
+	 *
+	 *	Writes the chunks straight to the descriptor without any additional buffering
+	 *
+	 *	@param fd - a descriptor opened for writing (the caller closes it)
+	 *
+	 *	@returns (VCFGSink_t) the sink
+	 */
+	inline VCFGSink_t vcfg_fd_sink(int fd) {
+		VCFGSink_t sink = { vcfginternal_fd_sink_write, (void*)(intptr_t)fd };
+		return sink;
+	}
+
+	/**
+	 *	@brief Write the configuration to a file.
+	 *
+	 *	Creates (or truncates) the file and writes the configuration with vcfg_write
+	 *
+	 *	@param path - path to the file
+	 *	@param flags - VCFGWriteFlags combined with |
+	 *
+	 *	@returns 0 - Failure (see vcfg_get_last_error), 1 - Success
+	 */
+	inline int vcfg_write_file(VCFG_Parser* parserObj, const char* path, uint32_t flags) {
+		if (!parserObj || !path) return 0;
+
+		FILE* file = fopen(path, "wb");
+		if (!file) {
+			perror("FOPEN()");
+			parserObj->m_lastError = VCFG_ERROR_IO;
+			return 0;
+		}
+
+		VCFGSink_t sink = vcfg_file_sink(file);
+		int result = vcfg_write(parserObj, &sink, flags);
+		if ((fclose(file) != 0) && result) {
+			vcfginternal_set_error(parserObj, VCFG_ERROR_IO);
+			result = 0;
+		}
+
+		return result;
+	}
+
+	/**
+	 *	@brief Write the configuration to a file without the risk of leaving it half written.
+	 *
+	 *	Writes the configuration to a temporary file next to the destination, flushes it to the disk
+	 *	and renames it over the destination, so that after a crash or a power loss the file holds
+	 *	either the old or the new configuration, never a part of it. The temporary file gets the permissions
+	 *	of the file it replaces (a new file is created with the umask applied like by vcfg_write_file)
+	 *	and is removed when anything fails. Combine with VCFG_WRITE_CHECKSUM
+	 *	to detect files that were damaged in other ways
+	 *
+	 *	@param path - path to the file
+	 *	@param flags - VCFGWriteFlags combined with |
+	 *
+	 *	@returns 0 - Failure (see vcfg_get_last_error), 1 - Success
+	 */
+	inline int vcfg_write_file_atomic(VCFG_Parser* parserObj, const char* path, uint32_t flags) {
+		if (!parserObj || !path) return 0;
+
+		// <path>.<pid>.<n>.tmp in the same directory, so the rename doesn't cross file systems
+		size_t pathLength = vcfginternal_strlen(path);
+		char* tempPath = (char*)VCFG_MALLOC(pathLength + 48);
+		if (!tempPath) {
+			perror("MALLOC()");
+			parserObj->m_lastError = VCFG_ERROR_OUT_OF_MEMORY;
+			return 0;
+		}
+		vcfginternal_memcpy((void*)tempPath, (const void*)path, pathLength);
+
+	#if defined(OS_WINDOWS)
+		uint64_t pid = (uint64_t)_getpid();
+	#else
+		uint64_t pid = (uint64_t)getpid();
+		// A new file gets 0666 minus the umask like with fopen, a replaced one keeps its permissions
+		struct stat fileInfo;
+		int mode = (stat(path, &fileInfo) == 0) ? (int)(fileInfo.st_mode & 07777) : -1;
+	#endif
+
+		int fd = -1;
+		for (uint64_t attempt = 0; (fd < 0) && (attempt < 100); attempt++) {
+			size_t length = pathLength;
+			tempPath[length++] = '.';
+			length += vcfginternal_uint64tobuf(pid, tempPath + length);
+			tempPath[length++] = '.';
+			length += vcfginternal_uint64tobuf(attempt, tempPath + length);
+			vcfginternal_memcpy((void*)(tempPath + length), (const void*)".tmp", 5);
+
+		#if defined(OS_WINDOWS)
+			fd = _open(tempPath, _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY, _S_IREAD | _S_IWRITE);
+		#else
+			fd = open(tempPath, O_WRONLY | O_CREAT | O_EXCL, (mode < 0) ? 0666 : 0600);
+		#endif
+			if ((fd < 0) && (errno != EEXIST)) break;
+		}
+		if (fd < 0) {
+			perror("OPEN()");
+			VCFG_FREE(tempPath);
+			parserObj->m_lastError = VCFG_ERROR_IO;
+			return 0;
+		}
+
+		VCFGSink_t sink = vcfg_fd_sink(fd);
+		int result = vcfg_write(parserObj, &sink, flags);
+
+		// The data has to be on the disk before the rename makes it visible
+	#if defined(OS_WINDOWS)
+		if (result && (_commit(fd) != 0)) result = 0;
+		if (_close(fd) != 0) result = 0;
+		if (result && !MoveFileExA(tempPath, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) result = 0;
+		if (!result) _unlink(tempPath);
+	#else
+		if (result && (((mode >= 0) && (chmod(tempPath, (mode_t)mode) != 0)) || (fsync(fd) != 0))) result = 0;
+		if (close(fd) != 0) result = 0;
+		if (result && (rename(tempPath, path) != 0)) result = 0;
+		if (!result) unlink(tempPath);
+		else {
+			// The rename itself is durable only after the directory is flushed (best effort, not every file system allows it)
+			const char* slash = 0;
+			for (const char* c = path; *c; c++) {
+				if (*c == '/') slash = c;
+			}
+
+			if (slash) {
+				size_t directoryLength = slash > path ? (size_t)(slash - path) : 1;
+				vcfginternal_memcpy((void*)tempPath, (const void*)path, directoryLength);
+				tempPath[directoryLength] = '\0';
+			}
+			else vcfginternal_memcpy((void*)tempPath, (const void*)".", 2);
+
+			int directory = open(tempPath, O_RDONLY);
+			if (directory >= 0) {
+				fsync(directory);
+				close(directory);
+			}
+		}
+	#endif
+		VCFG_FREE(tempPath);
+
+		if (!result) vcfginternal_set_error(parserObj, VCFG_ERROR_IO);
+		return result;
+	}
+#endif // VCFG_BUFFER_ONLY
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // VCFG_WRITER_H